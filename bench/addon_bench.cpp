@@ -0,0 +1,235 @@
+/******************************************************************
+ * Benchmark: addon_bench
+ * ---------------------------------------------------------------
+ * Add-on chains of 1 to 16 steps on a latte with a milk target:
+ *
+ *   legacy    - the pre-registry add-on functions, one call per
+ *               step, each recomputing espresso and milk
+ *   compiled  - DrinkComposition from the step list: the registry
+ *               folds it into one coefficient vector, volumes are
+ *               derived once
+ *   prebuilt  - the same composition built once, evaluate only
+ *               (a repeated order)
+ *   order     - computeOrder on an order carrying the steps as
+ *               add-on ids (up to ORDER_MAX_ADDONS): the batch
+ *               path, whose compiled add-ons come from a cache
+ *   uncached  - the same stages compiling the list on every
+ *               order, as computeOrder did before the cache
+ *
+ * legacy has no result struct or caffeine to fill in, so compare
+ * order with uncached, not with legacy.
+ *
+ * Before timing, every chain is checked: both paths must agree on
+ * shots, grounds, espresso, milk and final volume.
+ *
+ * Usage: addon_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "addonRegistry.hpp"
+#include "constants.hpp"
+#include "drinkComposition.hpp"
+#include "orderRecord.hpp"
+
+using namespace std;
+
+namespace {
+
+// applyLatteAddons and the milk block as they were before the registry
+void legacyApplyLatteAddons(LatteResult& latte, bool isIced, int extraShots) {
+    if (extraShots > 0) {
+        latte.shots += extraShots;
+        double gramsPerShot = GRAMS_PER_SHOT[indexOf(latte.shotSize)];
+        latte.coffeeGrams = latte.shots * gramsPerShot;
+        latte.espressoML = latte.coffeeGrams * latte.brewRatio;
+        latte.espressoCups = latte.espressoML / ML_PER_CUP;
+        if (latte.hasMilkTarget) {
+            latte.milkML = latte.espressoML * latte.milkToEspRatio;
+            latte.milkCups = latte.milkML / ML_PER_CUP;
+            latte.finalML = latte.espressoML + latte.milkML;
+            latte.finalCups = latte.finalML / ML_PER_CUP;
+        }
+    }
+    if (isIced) {
+        latte.brewRatio *= ICED_BREW_FACTOR;
+        latte.espressoML = latte.coffeeGrams * latte.brewRatio;
+        latte.espressoCups = latte.espressoML / ML_PER_CUP;
+        if (latte.hasMilkTarget) {
+            latte.milkML = latte.espressoML * latte.milkToEspRatio;
+            latte.milkCups = latte.milkML / ML_PER_CUP;
+            latte.finalML = latte.espressoML + latte.milkML;
+            latte.finalCups = latte.finalML / ML_PER_CUP;
+        }
+    }
+}
+
+void legacyMilkTarget(LatteResult& r, MilkStyle style, double ratio) {
+    r.hasMilkTarget = true;
+    r.milkStyle = style;
+    r.milkToEspRatio = ratio;
+    r.milkML = r.espressoML * r.milkToEspRatio;
+    r.milkCups = r.milkML / ML_PER_CUP;
+    r.finalML = r.espressoML + r.milkML;
+    r.finalCups = r.finalML / ML_PER_CUP;
+}
+
+// step i of a chain: one ice, the rest extra shots
+bool stepIsIce(size_t i) { return i == 1; }
+
+bool legacyChain(size_t steps, LatteResult& r) {
+    if (!calcLatteFromShots(Strength::Stronger, ShotSize::Double, 2, r)) return false;
+    legacyMilkTarget(r, MilkStyle::Latte, 3.0);
+    for (size_t i = 0; i < steps; ++i)
+        legacyApplyLatteAddons(r, stepIsIce(i), stepIsIce(i) ? 0 : 1);
+    return true;
+}
+
+// the chain as an order carries it: a list of registry ids
+struct Chain {
+    AddOnId ids[16];
+    size_t  count;
+};
+
+Chain makeChain(size_t steps) {
+    Chain c{};
+    c.count = steps;
+    for (size_t i = 0; i < steps; ++i)
+        c.ids[i] = stepIsIce(i) ? ADDON_ICED : ADDON_EXTRA_SHOT;
+    return c;
+}
+
+DrinkComposition composeChain(const Chain& chain) {
+    DrinkComposition drink;
+    drink.setLatte(Strength::Stronger, ShotSize::Double, 2);
+    drink.setMilkTarget(MilkStyle::Latte, 3.0);
+    drink.addAddOns(chain.ids, chain.count);
+    return drink;
+}
+
+// the chain as a parsed order (steps <= ORDER_MAX_ADDONS)
+Order chainOrder(const Chain& chain) {
+    Order order;
+    order.drink = DrinkType::Latte;
+    order.strength = Strength::Stronger;
+    order.shotSize = ShotSize::Double;
+    order.shots = 2;
+    order.milkStyle = MilkStyle::Latte;
+    order.milkRatio = 3.0;
+    for (size_t i = 0; i < chain.count; ++i) order.addOns[order.addOnCount++] = chain.ids[i];
+    return order;
+}
+
+// computeOrder with compile() called for every order
+bool computeUncached(const Order& order, OrderResult& out) {
+    Order base = order;
+    base.addOnCount = 0;
+    DrinkComposition drink;
+    composeOrder(base, drink);
+    drink.addAddOns(order.addOns, order.addOnCount);
+    out.drink = order.drink;
+    out.ok = drink.evaluate(out.latte);
+    out.caffeineMg = out.ok ? drink.caffeineMg() : 0.0;
+    return out.ok;
+}
+
+bool close(double a, double b) {
+    return fabs(a - b) <= 1e-9 * (fabs(a) + fabs(b) + 1.0);
+}
+
+bool sameLatte(const LatteResult& a, const LatteResult& b) {
+    return a.shots == b.shots && close(a.coffeeGrams, b.coffeeGrams) &&
+           close(a.espressoML, b.espressoML) && close(a.milkML, b.milkML) &&
+           close(a.finalML, b.finalML);
+}
+
+bool checkChain(size_t steps) {
+    LatteResult legacy, compiled;
+    if (!legacyChain(steps, legacy) || !composeChain(makeChain(steps)).evaluate(compiled)) return false;
+    if (!sameLatte(legacy, compiled)) return false;
+    if (steps > ORDER_MAX_ADDONS) return true;
+    OrderResult ordered, uncached;
+    Order order = chainOrder(makeChain(steps));
+    return computeOrder(order, ordered) && sameLatte(legacy, ordered.latte) &&
+           computeUncached(order, uncached) && sameLatte(legacy, uncached.latte);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t CHAINS[] = {1, 2, 4, 8, 16};
+
+    for (size_t steps : CHAINS) {
+        if (!checkChain(steps)) {
+            cerr << "addon_bench: legacy and compiled results differ for " << steps << " steps\n";
+            return 1;
+        }
+    }
+
+    bench::Runner runner;
+    for (size_t steps : CHAINS) {
+        string suffix = "/" + to_string(steps);
+
+        runner.add("legacy" + suffix, [steps](bench::State& state) {
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                LatteResult r;
+                legacyChain(steps, r);
+                bench::doNotOptimize(r);
+            }
+        });
+
+        runner.add("compiled" + suffix, [steps](bench::State& state) {
+            Chain chain = makeChain(steps);
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                LatteResult r;
+                composeChain(chain).evaluate(r);
+                bench::doNotOptimize(r);
+            }
+        });
+
+        runner.add("prebuilt" + suffix, [steps](bench::State& state) {
+            DrinkComposition drink = composeChain(makeChain(steps));
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                LatteResult r;
+                drink.evaluate(r);
+                bench::doNotOptimize(r);
+            }
+        });
+
+        if (steps > ORDER_MAX_ADDONS) continue;
+        runner.add("order" + suffix, [steps](bench::State& state) {
+            Order order = chainOrder(makeChain(steps));
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                OrderResult r;
+                computeOrder(order, r);
+                bench::doNotOptimize(r);
+            }
+        });
+
+        runner.add("uncached" + suffix, [steps](bench::State& state) {
+            Order order = chainOrder(makeChain(steps));
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                OrderResult r;
+                computeUncached(order, r);
+                bench::doNotOptimize(r);
+            }
+        });
+    }
+
+    // folding a registry list into one vector, the step orders pay once
+    runner.add("registry/compile8", [](bench::State& state) {
+        const AddOnRegistry& menu = defaultAddOns();
+        AddOnId ids[8];
+        for (AddOnId i = 0; i < 8; ++i) ids[i] = static_cast<AddOnId>(i % menu.size());
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            AddOnEffect fused = menu.compile(ids, 8, DrinkType::Latte);
+            bench::doNotOptimize(fused);
+        }
+    });
+
+    return runner.main(argc, argv);
+}
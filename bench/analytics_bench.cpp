@@ -0,0 +1,141 @@
+/******************************************************************
+ * Benchmark: analytics_bench
+ * ---------------------------------------------------------------
+ * Ingest and query cost of OrderAnalytics:
+ *
+ *   record/<n>t          - n threads recording orders concurrently
+ *                          (items = records across all threads)
+ *   record+reader/<n>t   - the same with one more thread running
+ *                          total() queries the whole time
+ *   query/total          - whole-window total, all stores and drinks
+ *   query/store          - whole-window total for one store
+ *   query/hourly24       - last 24 hours, hour by hour
+ *
+ * Before timing, concurrent writers are checked against the exact
+ * totals they recorded.
+ *
+ * Usage: analytics_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "orderAnalytics.hpp"
+
+using namespace std;
+
+namespace {
+
+constexpr int64_t BENCH_TIME = 1700000000;   // fixed clock for repeatable buckets
+
+// n writers recording `count` orders each, spread over stores, drinks and hours
+void ingest(OrderAnalytics& analytics, unsigned threads, size_t count) {
+    vector<thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&analytics, t, count] {
+            for (size_t i = 0; i < count; ++i) {
+                int64_t time = BENCH_TIME + static_cast<int64_t>((i / 1024) % 24) * 3600;
+                analytics.record(time, static_cast<unsigned>(i + t) % ANALYTICS_STORES,
+                                 (i & 1) ? DrinkType::Latte : DrinkType::Coffee,
+                                 95.0, 16.5, (i & 1) ? 180.0 : 0.0);
+            }
+        });
+    }
+    for (thread& w : workers) w.join();
+}
+
+AnalyticsFilter wholeWindow() {
+    AnalyticsFilter f;
+    f.toHour = BENCH_TIME / 3600 + 24;
+    f.fromHour = f.toHour - static_cast<int64_t>(ANALYTICS_HOURS);
+    return f;
+}
+
+bool checkConcurrentTotals() {
+    const unsigned THREADS = 4;
+    const size_t COUNT = 100000;
+    OrderAnalytics analytics;
+    ingest(analytics, THREADS, COUNT);
+
+    ConsumptionTotals t = analytics.total(wholeWindow());
+    size_t n = THREADS * COUNT;
+    return t.orders == n && t.caffeineMg == 95.0 * n && t.beansG == 16.5 * n
+        && t.milkML == 180.0 * (n / 2) && analytics.dropped() == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!checkConcurrentTotals()) {
+        cerr << "analytics_bench: concurrent totals do not match what was recorded\n";
+        return 1;
+    }
+
+    bench::Runner runner;
+    const unsigned WRITERS[] = {1, 2, 4};
+
+    for (unsigned threads : WRITERS) {
+        string suffix = "/" + to_string(threads) + "t";
+
+        runner.add("record" + suffix, [threads](bench::State& state) {
+            OrderAnalytics analytics;
+            state.setItemsPerOp(threads);
+            ingest(analytics, threads, state.iterations());
+        });
+
+        runner.add("record+reader" + suffix, [threads](bench::State& state) {
+            OrderAnalytics analytics;
+            atomic<bool> done{false};
+            thread reader([&analytics, &done] {
+                AnalyticsFilter f = wholeWindow();
+                while (!done.load(memory_order_relaxed)) {
+                    ConsumptionTotals t = analytics.total(f);
+                    bench::doNotOptimize(t);
+                }
+            });
+            state.setItemsPerOp(threads);
+            ingest(analytics, threads, state.iterations());
+            done.store(true, memory_order_relaxed);
+            state.pauseTiming();
+            reader.join();
+            state.resumeTiming();
+        });
+    }
+
+    // reads merge every stripe, so query cost grows with writer threads
+    static OrderAnalytics filled;
+    ingest(filled, 4, 200000);
+
+    runner.add("query/total", [](bench::State& state) {
+        AnalyticsFilter f = wholeWindow();
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            ConsumptionTotals t = filled.total(f);
+            bench::doNotOptimize(t);
+        }
+    });
+
+    runner.add("query/store", [](bench::State& state) {
+        AnalyticsFilter f = wholeWindow();
+        f.store = 3;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            ConsumptionTotals t = filled.total(f);
+            bench::doNotOptimize(t);
+        }
+    });
+
+    runner.add("query/hourly24", [](bench::State& state) {
+        AnalyticsFilter f = wholeWindow();
+        f.fromHour = f.toHour - 24;
+        vector<ConsumptionTotals> perHour;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            filled.hourly(f, perHour);
+            bench::doNotOptimize(perHour);
+        }
+    });
+
+    return runner.main(argc, argv);
+}
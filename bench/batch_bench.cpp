@@ -0,0 +1,151 @@
+/******************************************************************
+ * Benchmark: batch_bench
+ * ---------------------------------------------------------------
+ * Compares orders per second of the scalar per-order path (parse
+ * keywords, then calcCoffee / calcLatteFromShots) against the
+ * struct-of-arrays batch engine (calcCoffeeBatch / calcLatteBatch).
+ *
+ * Usage: batch_bench [orderCount]
+ ******************************************************************/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "functions.hpp"
+#include "drinkTypes.hpp"
+#include "orderBatch.hpp"
+#include "recipeKernels.hpp"
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+void report(const char* label, size_t orders, double seconds, double checksum) {
+    cout << left << setw(28) << label
+         << right << setw(14) << fixed << setprecision(0) << (orders / seconds)
+         << " orders/s   (" << setprecision(3) << seconds * 1000.0 << " ms, checksum "
+         << setprecision(2) << checksum << ")\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    if (count == 0) count = 1000000;
+
+    const char* roastNames[]    = {"light", "medium", "dark"};
+    const char* coffeeNames[]   = {"bolder", "medium", "weaker"};
+    const char* latteNames[]    = {"stronger", "weaker"};
+    const char* shotSizeNames[] = {"single", "double"};
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick3(0, 2), pick2(0, 1), pickShots(1, 4);
+
+    // same order stream in string form (scalar path) and SoA form (batch)
+    vector<string> coffeeStrength, coffeeRoast, latteStrength, latteSize;
+    vector<double> coffeeCups;
+    vector<int>    latteShots;
+    CoffeeOrderBatch coffeeBatch;
+    LatteOrderBatch  latteBatch;
+    coffeeBatch.reserve(count);
+    latteBatch.reserve(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        int s = pick3(rng), r = pick3(rng);
+        double cups = 0.5 * (1 + pick3(rng));
+        coffeeStrength.push_back(coffeeNames[s]);
+        coffeeRoast.push_back(roastNames[r]);
+        coffeeCups.push_back(cups);
+        Strength st; Roast ro;
+        parseStrength(coffeeNames[s], st);
+        parseRoast(roastNames[r], ro);
+        coffeeBatch.add(st, ro, cups);
+
+        int ls = pick2(rng), sz = pick2(rng), shots = pickShots(rng);
+        latteStrength.push_back(latteNames[ls]);
+        latteSize.push_back(shotSizeNames[sz]);
+        latteShots.push_back(shots);
+        Strength lst; ShotSize ssz;
+        parseStrength(latteNames[ls], lst);
+        parseShotSize(shotSizeNames[sz], ssz);
+        latteBatch.add(lst, ssz, shots);
+    }
+
+    vector<CoffeeResult>  coffeeOut(count);
+    vector<LatteResult>   latteOut(count);
+    vector<unsigned char> valid(count);
+
+    cout << "batch_bench: " << count << " orders per run\n";
+
+    // --- coffee ---
+    double sum = 0.0;
+    Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        Strength st; Roast ro;
+        if (parseStrength(coffeeStrength[i], st) && parseRoast(coffeeRoast[i], ro))
+            calcCoffee(st, ro, coffeeCups[i], coffeeOut[i]);
+    }
+    double scalarSec = secondsSince(t0);
+    for (const auto& r : coffeeOut) sum += r.coffeeGrams;
+    report("calcCoffee (scalar)", count, scalarSec, sum);
+
+    sum = 0.0;
+    t0 = Clock::now();
+    calcCoffeeBatch(coffeeBatch, coffeeOut.data(), valid.data());
+    double batchSec = secondsSince(t0);
+    for (const auto& r : coffeeOut) sum += r.coffeeGrams;
+    report("calcCoffeeBatch", count, batchSec, sum);
+    cout << "  speedup: " << setprecision(1) << scalarSec / batchSec << "x\n";
+
+    // compile-time specialized kernel (one fixed recipe, cups only)
+    sum = 0.0;
+    t0 = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        coffeeOut[i] = calcCoffee<Strength::Medium, Roast::Medium>(coffeeCups[i]);
+    }
+    double kernelSec = secondsSince(t0);
+    for (const auto& r : coffeeOut) sum += r.coffeeGrams;
+    report("calcCoffee<Medium, Medium>", count, kernelSec, sum);
+
+    // --- latte ---
+    sum = 0.0;
+    t0 = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        Strength st; ShotSize sz;
+        if (parseStrength(latteStrength[i], st) && parseShotSize(latteSize[i], sz))
+            calcLatteFromShots(st, sz, latteShots[i], latteOut[i]);
+    }
+    scalarSec = secondsSince(t0);
+    for (const auto& r : latteOut) sum += r.espressoML;
+    report("calcLatteFromShots (scalar)", count, scalarSec, sum);
+
+    sum = 0.0;
+    t0 = Clock::now();
+    calcLatteBatch(latteBatch, latteOut.data(), valid.data());
+    batchSec = secondsSince(t0);
+    for (const auto& r : latteOut) sum += r.espressoML;
+    report("calcLatteBatch", count, batchSec, sum);
+    cout << "  speedup: " << setprecision(1) << scalarSec / batchSec << "x\n";
+
+    sum = 0.0;
+    t0 = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        latteOut[i] = calcLatte<ShotSize::Double, Strength::Stronger>(latteShots[i]);
+    }
+    kernelSec = secondsSince(t0);
+    for (const auto& r : latteOut) sum += r.espressoML;
+    report("calcLatte<Double, Stronger>", count, kernelSec, sum);
+
+    return 0;
+}
@@ -0,0 +1,272 @@
+#ifndef BENCHHARNESS_HPP
+#define BENCHHARNESS_HPP
+
+/******************************************************************
+ * Header: benchHarness
+ * ---------------------------------------------------------------
+ * Minimal Google-Benchmark style harness for the bench/ programs:
+ * register functions with BENCHMARK-like calls, the runner picks
+ * an iteration count that fills --min-time, and reports ns/op,
+ * allocations/op, bytes allocated/op and throughput, as a table
+ * and optionally as JSON (--json[=file]).
+ *
+ * Allocations are counted by replacing the global operator new,
+ * so include this header from exactly one translation unit per
+ * benchmark binary.
+ ******************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+inline std::atomic<std::size_t> allocCount{0};
+inline std::atomic<std::size_t> allocBytes{0};
+
+// keeps the compiler from dropping a computed value
+template <typename T>
+inline void doNotOptimize(T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    volatile auto sink = &value;
+    (void)sink;
+#endif
+}
+
+/******************************************************************
+ * Class: State
+ * ---------------------------------------------------------------
+ * Passed to every benchmark body. The body runs its operation
+ * iterations() times; setup inside the body can be excluded from
+ * the timing and allocation counts with pauseTiming/resumeTiming.
+ ******************************************************************/
+class State {
+
+    using Clock = std::chrono::steady_clock;
+
+    public:
+
+        explicit State(std::size_t iterations) : iters(iterations) {}
+
+        std::size_t iterations() const { return iters; }
+
+        // items per op for throughput (default 1)
+        void setItemsPerOp(double items) { itemsPerOp = items; }
+
+        void pauseTiming() {
+            elapsed += Clock::now() - started;
+            allocs += allocCount.load(std::memory_order_relaxed) - allocStart;
+            bytes += allocBytes.load(std::memory_order_relaxed) - bytesStart;
+        }
+
+        void resumeTiming() {
+            allocStart = allocCount.load(std::memory_order_relaxed);
+            bytesStart = allocBytes.load(std::memory_order_relaxed);
+            started = Clock::now();
+        }
+
+    private:
+
+        friend class Runner;
+
+        std::size_t iters;
+        double itemsPerOp = 1.0;
+        Clock::time_point started;
+        Clock::duration elapsed{0};
+        std::size_t allocStart = 0, bytesStart = 0;
+        std::size_t allocs = 0, bytes = 0;
+};
+
+struct Result {
+    std::string name;
+    std::size_t iterations = 0;
+    double nsPerOp = 0.0;
+    double allocsPerOp = 0.0;
+    double bytesPerOp = 0.0;
+    double itemsPerSecond = 0.0;
+};
+
+/******************************************************************
+ * Class: Runner
+ * ---------------------------------------------------------------
+ * Holds the registered benchmarks and runs them. A benchmark with
+ * a fixed iteration count runs exactly once with that count;
+ * otherwise the count grows until one run lasts --min-time.
+ ******************************************************************/
+class Runner {
+
+    public:
+
+        using Body = std::function<void(State&)>;
+
+        void add(std::string name, Body body, std::size_t fixedIterations = 0) {
+            entries.push_back({std::move(name), std::move(body), fixedIterations});
+        }
+
+        // --filter=<substring> --min-time=<seconds> --json[=<file>]
+        int main(int argc, char* argv[]) {
+            for (int i = 1; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg.rfind("--filter=", 0) == 0) {
+                    filter = arg.substr(9);
+                } else if (arg.rfind("--min-time=", 0) == 0) {
+                    minTime = std::atof(arg.c_str() + 11);
+                } else if (arg == "--json") {
+                    jsonPath = "-";
+                } else if (arg.rfind("--json=", 0) == 0) {
+                    jsonPath = arg.substr(7);
+                } else {
+                    std::cerr << "usage: " << argv[0]
+                              << " [--filter=substr] [--min-time=sec] [--json[=file]]\n";
+                    return 1;
+                }
+            }
+
+            std::vector<Result> results;
+            bool table = jsonPath != "-";
+            if (table) printHeader();
+            for (const Entry& e : entries) {
+                if (!filter.empty() && e.name.find(filter) == std::string::npos) continue;
+                results.push_back(run(e));
+                if (table) printRow(results.back());
+            }
+
+            if (jsonPath == "-") {
+                writeJson(std::cout, results);
+            } else if (!jsonPath.empty()) {
+                std::ofstream out(jsonPath);
+                if (!out) {
+                    std::cerr << "cannot write " << jsonPath << "\n";
+                    return 1;
+                }
+                writeJson(out, results);
+                std::cout << "wrote " << jsonPath << "\n";
+            }
+            return 0;
+        }
+
+    private:
+
+        struct Entry {
+            std::string name;
+            Body body;
+            std::size_t fixedIterations;
+        };
+
+        std::vector<Entry> entries;
+        std::string filter;
+        std::string jsonPath;
+        double minTime = 0.2;
+
+        static Result measure(const Entry& e, std::size_t iterations, double& seconds) {
+            State state(iterations);
+            state.resumeTiming();
+            e.body(state);
+            state.pauseTiming();
+
+            seconds = std::chrono::duration<double>(state.elapsed).count();
+            Result r;
+            r.name = e.name;
+            r.iterations = iterations;
+            r.nsPerOp = seconds * 1e9 / iterations;
+            r.allocsPerOp = static_cast<double>(state.allocs) / iterations;
+            r.bytesPerOp = static_cast<double>(state.bytes) / iterations;
+            r.itemsPerSecond = seconds > 0.0 ? state.itemsPerOp * iterations / seconds : 0.0;
+            return r;
+        }
+
+        Result run(const Entry& e) const {
+            double seconds = 0.0;
+            if (e.fixedIterations > 0)
+                return measure(e, e.fixedIterations, seconds);
+
+            std::size_t iterations = 1;
+            for (;;) {
+                Result r = measure(e, iterations, seconds);
+                if (seconds >= minTime || iterations >= (std::size_t(1) << 34))
+                    return r;
+                // aim 40% past the target so the next run usually suffices
+                double scale = seconds > 0.0 ? (minTime * 1.4) / seconds : 100.0;
+                if (scale > 100.0) scale = 100.0;
+                if (scale < 2.0) scale = 2.0;
+                iterations = static_cast<std::size_t>(iterations * scale);
+            }
+        }
+
+        static void printHeader() {
+            std::cout << std::left << std::setw(40) << "benchmark"
+                      << std::right << std::setw(14) << "ns/op"
+                      << std::setw(12) << "allocs/op"
+                      << std::setw(12) << "bytes/op"
+                      << std::setw(16) << "items/s"
+                      << std::setw(14) << "iterations" << "\n"
+                      << std::string(108, '-') << "\n";
+        }
+
+        static void printRow(const Result& r) {
+            std::cout << std::left << std::setw(40) << r.name << std::right << std::fixed
+                      << std::setw(14) << std::setprecision(2) << r.nsPerOp
+                      << std::setw(12) << std::setprecision(2) << r.allocsPerOp
+                      << std::setw(12) << std::setprecision(1) << r.bytesPerOp
+                      << std::setw(16) << std::setprecision(0) << r.itemsPerSecond
+                      << std::setw(14) << r.iterations << "\n";
+        }
+
+        static void writeJson(std::ostream& out, const std::vector<Result>& results) {
+            out << "{\n  \"benchmarks\": [\n";
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                const Result& r = results[i];
+                out << "    {\"name\": \"" << r.name << "\""
+                    << ", \"iterations\": " << r.iterations
+                    << std::fixed << std::setprecision(3)
+                    << ", \"ns_per_op\": " << r.nsPerOp
+                    << ", \"allocs_per_op\": " << r.allocsPerOp
+                    << ", \"bytes_per_op\": " << r.bytesPerOp
+                    << std::setprecision(1)
+                    << ", \"items_per_second\": " << r.itemsPerSecond << "}"
+                    << (i + 1 < results.size() ? ",\n" : "\n");
+            }
+            out << "  ]\n}\n";
+        }
+};
+
+} // namespace bench
+
+// counting replacements for the global allocation functions
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    bench::allocCount.fetch_add(1, std::memory_order_relaxed);
+    bench::allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -0,0 +1,122 @@
+/******************************************************************
+ * Benchmark: console_bench
+ * ---------------------------------------------------------------
+ * Cost of reading console answers, on a long scripted session
+ * (the prompts' answers for coffee, latte and preset rounds)
+ * stored in a temporary file:
+ *
+ *   read/istream        - ifstream >> string / >> int / >> double
+ *   read/consoleInput   - ConsoleInput words, from_chars numbers
+ *
+ * Both readers classify every word the same way: a keyword through
+ * the parseXxx functions, else a number. Before timing they must
+ * agree on every word and every parsed value.
+ *
+ * Usage: console_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "consoleInput.hpp"
+#include "drinkTypes.hpp"
+
+using namespace std;
+
+namespace {
+
+constexpr size_t SESSION_ROUNDS = 20000;
+
+const char* const ROUND =
+    "1\ncoffee\ndark\nbolder\n2\ny\ny\n3\ndecaf\ny\n"
+    "1\nlatte\nstronger\ndouble\n2\ny\ny\n1\n2\ncortado\ny\n"
+    "1\nLatte\nweaker\nsingle\n3\nn\ncustom\n2.5\ny\n";
+
+struct Tally {
+    size_t words = 0;
+    size_t keywords = 0;
+    double numbers = 0.0;
+
+    bool operator==(const Tally& o) const {
+        return words == o.words && keywords == o.keywords && numbers == o.numbers;
+    }
+};
+
+// what a prompt would make of one word
+void classify(string_view w, Tally& t) {
+    DrinkType d;
+    Roast r;
+    Strength s;
+    ShotSize z;
+    MilkStyle m;
+    double x;
+    ++t.words;
+    if (parseDrinkType(w, d) || parseRoast(w, r) || parseStrength(w, s)
+        || parseShotSize(w, z) || parseMilkStyle(w, m))
+        ++t.keywords;
+    else if (parseNumber(w, x))
+        t.numbers += x;
+}
+
+Tally readIstream(const string& path) {
+    Tally t;
+    ifstream file(path);
+    string w;
+    while (file >> w) classify(w, t);
+    return t;
+}
+
+Tally readConsole(const string& path) {
+    Tally t;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return t;
+    ConsoleInput in(fd);
+    for (string_view w = in.word(); !w.empty(); w = in.word()) classify(w, t);
+    close(fd);
+    return t;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    static const string path = "console_bench.tmp";
+    {
+        ofstream file(path, ios::trunc);
+        for (size_t i = 0; i < SESSION_ROUNDS; ++i) file << ROUND;
+    }
+
+    static const Tally expected = readIstream(path);
+    if (!(readConsole(path) == expected) || expected.words == 0) {
+        cerr << "console_bench: ConsoleInput and istream read the session differently\n";
+        remove(path.c_str());
+        return 1;
+    }
+
+    bench::Runner runner;
+
+    runner.add("read/istream", [](bench::State& state) {
+        state.setItemsPerOp(expected.words);
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            Tally t = readIstream(path);
+            bench::doNotOptimize(t);
+        }
+    });
+
+    runner.add("read/consoleInput", [](bench::State& state) {
+        state.setItemsPerOp(expected.words);
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            Tally t = readConsole(path);
+            bench::doNotOptimize(t);
+        }
+    });
+
+    int status = runner.main(argc, argv);
+    remove(path.c_str());
+    return status;
+}
@@ -0,0 +1,323 @@
+/******************************************************************
+ * Benchmark: fixed_bench
+ * ---------------------------------------------------------------
+ * The fixed-point recipe engine (fixedRecipe.hpp) against the
+ * double path:
+ *
+ *   coffee/double, coffee/fixed  - computeOrder vs computeOrderFixed
+ *   latte/double,  latte/fixed     over the equivalence orders
+ *   divide/double, divide/fixed  - x / 240 vs the reciprocal
+ *
+ * Before timing, three checks (any failure exits 1):
+ *
+ *   - mulWide (128-bit builtin) and mulWidePortable agree, and
+ *     FixedDivisor matches exact integer division, on a fixed
+ *     pseudo-random stream: the results cannot depend on the
+ *     platform.
+ *   - Equivalence: every order in the domain below, through both
+ *     engines, prints the same at display precision (every result
+ *     field, 2 decimals). A difference only counts as a tie if the
+ *     exact value is within TIE_WINDOW of a rounding midpoint
+ *     (x.xx5), where either rounding is right; ties are reported,
+ *     anything else fails.
+ *   - No order in the domain falls back to the double path.
+ *
+ * Domain: coffee, every strength and roast, 0.01 to 16 cups in
+ * 0.01 steps, iced or not, no add-on, each add-on that changes a
+ * coffee value, and every ordered pair of them. Latte, both
+ * strengths and shot sizes, 1 to 16 shots, 0 to 3 extra shots,
+ * every milk style plus custom ratios 0.25 to 6 in 0.25 steps,
+ * iced or not, and the same add-on lists for lattes.
+ *
+ * Usage: fixed_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "constants.hpp"
+#include "fixedRecipe.hpp"
+
+using namespace std;
+
+namespace {
+
+constexpr double TIE_WINDOW = 1e-6;
+
+// add-ons that change a value of the drink (the rest are identity)
+vector<AddOnId> effectiveAddOns(DrinkType drink) {
+    const AddOnRegistry& menu = defaultAddOns();
+    vector<AddOnId> ids;
+    for (AddOnId id = 0; id < menu.size(); ++id) {
+        if (id == ADDON_ICED || !menu.appliesTo(id, drink)) continue;
+        const AddOnEffect& e = menu.spec(id).effect;
+        bool identity = true;
+        for (size_t q = 0; q < QUANTITY_COUNT; ++q)
+            identity = identity && e.isIdentity(static_cast<Quantity>(q));
+        if (!identity) ids.push_back(id);
+    }
+    return ids;
+}
+
+// none, each, every ordered pair
+vector<vector<AddOnId>> addOnLists(DrinkType drink) {
+    vector<AddOnId> ids = effectiveAddOns(drink);
+    vector<vector<AddOnId>> lists{{}};
+    for (AddOnId a : ids) lists.push_back({a});
+    for (AddOnId a : ids)
+        for (AddOnId b : ids) lists.push_back({a, b});
+    return lists;
+}
+
+void setAddOns(Order& o, const vector<AddOnId>& ids) {
+    o.addOnCount = static_cast<unsigned char>(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i) o.addOns[i] = ids[i];
+}
+
+// calls f(order) for every order in the equivalence domain
+template <typename F>
+void forEachCoffee(F&& f) {
+    vector<vector<AddOnId>> lists = addOnLists(DrinkType::Coffee);
+    Order o;
+    o.drink = DrinkType::Coffee;
+    for (Strength s : {Strength::Bolder, Strength::Medium, Strength::Weaker})
+        for (Roast r : {Roast::Light, Roast::Medium, Roast::Dark})
+            for (bool iced : {false, true})
+                for (const vector<AddOnId>& list : lists)
+                    for (int cents = 1; cents <= 1600; ++cents) {
+                        o.strength = s;
+                        o.roast = r;
+                        o.iced = iced;
+                        o.cups = cents / 100.0;
+                        setAddOns(o, list);
+                        f(o);
+                    }
+}
+
+template <typename F>
+void forEachLatte(F&& f) {
+    vector<vector<AddOnId>> lists = addOnLists(DrinkType::Latte);
+    vector<pair<MilkStyle, double>> milks = {{MilkStyle::None, 0.0}};
+    for (MilkStyle m : {MilkStyle::Cortado, MilkStyle::FlatWhite, MilkStyle::Latte})
+        milks.push_back({m, MILK_RATIO[indexOf(m)]});
+    for (int q = 1; q <= 24; ++q) milks.push_back({MilkStyle::Custom, q * 0.25});
+
+    Order o;
+    o.drink = DrinkType::Latte;
+    for (Strength s : {Strength::Stronger, Strength::Weaker})
+        for (ShotSize z : {ShotSize::Single, ShotSize::Double})
+            for (bool iced : {false, true})
+                for (const vector<AddOnId>& list : lists)
+                    for (const auto& milk : milks)
+                        for (int shots = 1; shots <= 16; ++shots)
+                            for (int extra = 0; extra <= 3; ++extra) {
+                                o.strength = s;
+                                o.shotSize = z;
+                                o.iced = iced;
+                                o.milkStyle = milk.first;
+                                o.milkRatio = milk.second;
+                                o.shots = shots;
+                                o.extraShots = extra;
+                                setAddOns(o, list);
+                                f(o);
+                            }
+}
+
+/******************************************************************
+ * Class: Equivalence
+ * ---------------------------------------------------------------
+ * Compares one order's results at display precision and keeps
+ * the totals.
+ ******************************************************************/
+class Equivalence {
+
+    public:
+
+        void check(const Order& order) {
+            OrderResult d, f;
+            computeOrder(order, d);
+            if (!evaluateOrderFixed(order, f)) {
+                ++fallbacks;
+                return;
+            }
+            ++orders;
+            if (d.ok != f.ok) {
+                fail(order, "ok", d.ok, f.ok);
+                return;
+            }
+            if (!d.ok) return;
+            field(order, "caffeine", d.caffeineMg, f.caffeineMg);
+            if (order.drink == DrinkType::Coffee) {
+                field(order, "water_cups", d.coffee.waterCups, f.coffee.waterCups);
+                field(order, "water_ml", d.coffee.waterML, f.coffee.waterML);
+                field(order, "grams", d.coffee.coffeeGrams, f.coffee.coffeeGrams);
+                field(order, "ratio", d.coffee.ratio, f.coffee.ratio);
+                field(order, "tbsp", d.coffee.tablespoons, f.coffee.tablespoons);
+            } else {
+                const LatteResult& a = d.latte;
+                const LatteResult& b = f.latte;
+                if (a.shots != b.shots || a.hasMilkTarget != b.hasMilkTarget)
+                    fail(order, "shots", a.shots, b.shots);
+                field(order, "grams", a.coffeeGrams, b.coffeeGrams);
+                field(order, "brew_ratio", a.brewRatio, b.brewRatio);
+                field(order, "espresso_ml", a.espressoML, b.espressoML);
+                field(order, "espresso_cups", a.espressoCups, b.espressoCups);
+                field(order, "tbsp", a.tablespoons, b.tablespoons);
+                field(order, "milk_ratio", a.milkToEspRatio, b.milkToEspRatio);
+                field(order, "milk_ml", a.milkML, b.milkML);
+                field(order, "milk_cups", a.milkCups, b.milkCups);
+                field(order, "final_ml", a.finalML, b.finalML);
+                field(order, "final_cups", a.finalCups, b.finalCups);
+            }
+        }
+
+        size_t orders = 0;
+        size_t fields = 0;
+        size_t ties = 0;
+        size_t mismatches = 0;
+        size_t fallbacks = 0;
+
+    private:
+
+        static string_view display(double v, char (&buf)[64]) {
+            auto r = to_chars(buf, buf + sizeof buf, v, chars_format::fixed, 2);
+            return string_view(buf, static_cast<size_t>(r.ptr - buf));
+        }
+
+        // within TIE_WINDOW of x.xx5
+        static bool nearMidpoint(double v) {
+            double cents = v * 100.0;
+            double midpoint = floor(cents) + 0.5;
+            return fabs(cents - midpoint) <= TIE_WINDOW * 100.0;
+        }
+
+        void field(const Order& order, const char* name, double d, double f) {
+            ++fields;
+            char a[64], b[64];
+            if (display(d, a) == display(f, b)) return;
+            if (nearMidpoint(f)) {
+                ++ties;
+                return;
+            }
+            fail(order, name, d, f);
+        }
+
+        template <typename T>
+        void fail(const Order& order, const char* name, T d, T f) {
+            if (mismatches++ < 10) {
+                cerr << "fixed_bench: " << (order.drink == DrinkType::Coffee ? "coffee" : "latte")
+                     << " cups " << order.cups << " shots " << order.shots << " extra "
+                     << order.extraShots << " ratio " << order.milkRatio << " addons "
+                     << int(order.addOnCount) << (order.iced ? " iced" : "") << ": " << name
+                     << " double " << d << " fixed " << f << "\n";
+            }
+        }
+};
+
+// xorshift64*, the same stream everywhere
+uint64_t nextRandom(uint64_t& s) {
+    s ^= s >> 12;
+    s ^= s << 25;
+    s ^= s >> 27;
+    return s * 2685821657736338717ull;
+}
+
+bool checkArithmetic() {
+    uint64_t s = 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < 1000000; ++i) {
+        uint64_t a = nextRandom(s), b = nextRandom(s) >> (i % 64);
+        uint64_t h1, l1, h2, l2;
+        fixed_detail::mulWide(a, b, h1, l1);
+        fixed_detail::mulWidePortable(a, b, h2, l2);
+        if (h1 != h2 || l1 != l2) {
+            cerr << "fixed_bench: mulWide and mulWidePortable differ for " << a << " * " << b << "\n";
+            return false;
+        }
+    }
+    for (uint64_t d = 1; d <= 256; ++d) {
+        FixedDivisor divisor(d);
+        for (int i = 0; i < 20000; ++i) {
+            Fixed q = nextRandom(s) % FIXED_LIMIT;
+            if (i < 64) q = FIXED_LIMIT - 1 - static_cast<Fixed>(i);   // the top of the range
+            if (divisor.divide(q) != (2 * q + d) / (2 * d)) {
+                cerr << "fixed_bench: FixedDivisor(" << d << ") is wrong for " << q << "\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+vector<Order> sampleOrders(DrinkType drink) {
+    vector<Order> orders;
+    size_t n = 0;
+    auto keep = [&](const Order& o) {
+        if (n++ % 97 == 0) orders.push_back(o);
+    };
+    if (drink == DrinkType::Coffee) forEachCoffee(keep);
+    else forEachLatte(keep);
+    return orders;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!checkArithmetic()) return 1;
+
+    Equivalence eq;
+    forEachCoffee([&](const Order& o) { eq.check(o); });
+    forEachLatte([&](const Order& o) { eq.check(o); });
+    cout << "fixed_bench: " << eq.orders << " orders, " << eq.fields << " fields at 2 decimals: "
+         << eq.mismatches << " mismatches, " << eq.ties << " midpoint ties, "
+         << eq.fallbacks << " fallbacks\n";
+    if (eq.mismatches > 0 || eq.fallbacks > 0) return 1;
+
+    bench::Runner runner;
+    for (DrinkType drink : {DrinkType::Coffee, DrinkType::Latte}) {
+        string name = (drink == DrinkType::Coffee) ? "coffee" : "latte";
+        vector<Order> orders = sampleOrders(drink);
+
+        runner.add(name + "/double", [orders](bench::State& state) {
+            OrderResult r;
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                computeOrder(orders[i % orders.size()], r);
+                bench::doNotOptimize(r);
+            }
+        });
+
+        runner.add(name + "/fixed", [orders](bench::State& state) {
+            OrderResult r;
+            for (size_t i = 0; i < state.iterations(); ++i) {
+                computeOrderFixed(orders[i % orders.size()], r);
+                bench::doNotOptimize(r);
+            }
+        });
+    }
+
+    // one unit conversion: hardware divide vs precomputed reciprocal
+    runner.add("divide/double", [](bench::State& state) {
+        double x = 1.0, sum = 0.0;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            sum += x / ML_PER_CUP;
+            x += 1.0;
+        }
+        bench::doNotOptimize(sum);
+    });
+
+    runner.add("divide/fixed", [](bench::State& state) {
+        const FixedDivisor cup(240);
+        Fixed x = FIXED_ONE, sum = 0;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            sum += cup.divide(x);
+            x = (x + FIXED_ONE) & (FIXED_LIMIT - 1);
+        }
+        bench::doNotOptimize(sum);
+    });
+
+    return runner.main(argc, argv);
+}
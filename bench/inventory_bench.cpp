@@ -0,0 +1,142 @@
+/******************************************************************
+ * Benchmark: inventory_bench
+ * ---------------------------------------------------------------
+ * InventoryForecast over a replayed day of orders:
+ *
+ *   consume/in-order     - one order per call, clock moving forward
+ *   consume/jittered     - times up to 5 min out of order
+ *   consume/day-20M      - a 24 h log of 20 million orders (one op
+ *                          = the whole log, items = orders)
+ *   merge                - folding one worker's forecast into another
+ *
+ * Before timing, a log split across 4 forecasts and merged must
+ * match one forecast fed the whole log.
+ *
+ * Usage: inventory_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <iostream>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "inventoryForecast.hpp"
+
+using namespace std;
+
+namespace {
+
+constexpr int64_t DAY_START = 1760000000;
+constexpr int64_t DAY_SECONDS = 24 * 3600;
+
+// a day's log of n orders: times spread evenly, roughly half lattes
+struct DayLog {
+    vector<int64_t> time;
+    vector<float>   beansG;
+    vector<float>   milkML;
+};
+
+DayLog makeDayLog(size_t n, int64_t jitter) {
+    DayLog log;
+    log.time.resize(n);
+    log.beansG.resize(n);
+    log.milkML.resize(n);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        int64_t t = DAY_START + static_cast<int64_t>(i * DAY_SECONDS / n);
+        if (jitter > 0) t -= static_cast<int64_t>(seed >> 8) % jitter;
+        bool latte = (seed >> 4) & 1;
+        log.time[i] = t;
+        log.beansG[i] = latte ? 16.0f * static_cast<float>(1 + ((seed >> 5) & 3)) : 18.46f;
+        log.milkML[i] = latte ? 192.0f : 0.0f;
+    }
+    return log;
+}
+
+void feed(InventoryForecast& f, const DayLog& log, size_t from, size_t to) {
+    for (size_t i = from; i < to; ++i)
+        f.consume(log.time[i], log.beansG[i], log.milkML[i]);
+}
+
+bool checkMerge() {
+    DayLog log = makeDayLog(400000, 300);
+    InventoryForecast whole;
+    feed(whole, log, 0, log.time.size());
+
+    // interleaved quarters, like chunks dealt to workers
+    InventoryForecast parts[4], merged;
+    size_t chunk = 5000;
+    for (size_t start = 0, k = 0; start < log.time.size(); start += chunk, ++k)
+        feed(parts[k % 4], log, start, min(start + chunk, log.time.size()));
+    for (const InventoryForecast& p : parts) merged.merge(p);
+
+    for (size_t i = 0; i < INGREDIENT_COUNT; ++i) {
+        Ingredient g = static_cast<Ingredient>(i);
+        if (merged.consumed(g) != whole.consumed(g) || merged.ratePerHour(g) != whole.ratePerHour(g))
+            return false;
+    }
+    return merged.orders() == whole.orders() && merged.late() == whole.late() &&
+           merged.latestTime() == whole.latestTime();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!checkMerge()) {
+        cerr << "inventory_bench: merged forecasts differ from a single pass\n";
+        return 1;
+    }
+
+    static const DayLog inOrder = makeDayLog(1 << 20, 0);
+    static const DayLog jittered = makeDayLog(1 << 20, 300);
+
+    bench::Runner runner;
+
+    runner.add("consume/in-order", [](bench::State& state) {
+        InventoryForecast f;
+        size_t n = inOrder.time.size();
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            size_t k = i % n;
+            f.consume(inOrder.time[k], inOrder.beansG[k], inOrder.milkML[k]);
+        }
+        double left = f.remaining(Ingredient::Beans);
+        bench::doNotOptimize(left);
+    });
+
+    runner.add("consume/jittered", [](bench::State& state) {
+        InventoryForecast f;
+        size_t n = jittered.time.size();
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            size_t k = i % n;
+            f.consume(jittered.time[k], jittered.beansG[k], jittered.milkML[k]);
+        }
+        double left = f.remaining(Ingredient::Beans);
+        bench::doNotOptimize(left);
+    });
+
+    runner.add("consume/day-20M", [](bench::State& state) {
+        state.pauseTiming();
+        static const DayLog day = makeDayLog(20000000, 300);
+        state.resumeTiming();
+        state.setItemsPerOp(static_cast<double>(day.time.size()));
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            InventoryForecast f;
+            f.restock(Ingredient::Beans, 1e9);
+            feed(f, day, 0, day.time.size());
+            double hours = f.hoursToEmpty(Ingredient::Beans);
+            bench::doNotOptimize(hours);
+        }
+    }, 1);
+
+    runner.add("merge", [](bench::State& state) {
+        InventoryForecast part;
+        feed(part, jittered, 0, 100000);
+        InventoryForecast total;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            total.merge(part);
+            bench::doNotOptimize(total);
+        }
+    });
+
+    return runner.main(argc, argv);
+}
@@ -0,0 +1,173 @@
+/******************************************************************
+ * Benchmark: menu_bench
+ * ---------------------------------------------------------------
+ * The precomputed menu table against the calculator:
+ *
+ *   order/computeOrder        - full calculation per order
+ *   order/computeOrderCached  - through the result cache (all hits)
+ *   order/menuLookup          - one indexed load from MenuTable
+ *   table/build               - generating every entry
+ *   table/save+load           - binary export and reload
+ *
+ * The orders cycle through every standard menu item. Before
+ * timing, every standard order (including base/extra shot splits)
+ * must give bit-identical results through the table, and off-menu
+ * orders must be refused.
+ *
+ * Usage: menu_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "menuTable.hpp"
+#include "orderCache.hpp"
+
+using namespace std;
+
+namespace {
+
+vector<Order> standardOrders() {
+    vector<Order> orders;
+    for (Strength s : {Strength::Bolder, Strength::Medium, Strength::Weaker})
+        for (Roast r : {Roast::Light, Roast::Medium, Roast::Dark})
+            for (bool iced : {false, true})
+                for (size_t cups = 1; cups <= MENU_MAX_CUPS; ++cups) {
+                    Order o;
+                    o.drink = DrinkType::Coffee;
+                    o.strength = s;
+                    o.roast = r;
+                    o.iced = iced;
+                    o.cups = static_cast<double>(cups);
+                    orders.push_back(o);
+                }
+    for (ShotSize z : {ShotSize::Single, ShotSize::Double})
+        for (Strength s : {Strength::Stronger, Strength::Weaker})
+            for (MilkStyle m : {MilkStyle::None, MilkStyle::Cortado, MilkStyle::FlatWhite, MilkStyle::Latte})
+                for (bool iced : {false, true})
+                    for (size_t total = 1; total <= MENU_MAX_SHOTS; ++total)
+                        for (size_t extra = 0; extra < total && extra < 4; ++extra) {
+                            Order o;
+                            o.drink = DrinkType::Latte;
+                            o.strength = s;
+                            o.shotSize = z;
+                            o.milkStyle = m;
+                            o.milkRatio = milkStyleToRatio(m);
+                            o.iced = iced;
+                            o.shots = static_cast<int>(total - extra);
+                            o.extraShots = static_cast<int>(extra);
+                            orders.push_back(o);
+                        }
+    return orders;
+}
+
+bool sameResult(const OrderResult& a, const OrderResult& b) {
+    if (a.ok != b.ok || a.drink != b.drink || memcmp(&a.caffeineMg, &b.caffeineMg, sizeof(double)) != 0)
+        return false;
+    if (a.drink == DrinkType::Coffee) return memcmp(&a.coffee, &b.coffee, sizeof(CoffeeResult)) == 0;
+    const LatteResult& x = a.latte;
+    const LatteResult& y = b.latte;
+    const double xs[] = {x.coffeeGrams, x.brewRatio, x.espressoML, x.espressoCups, x.tablespoons,
+                         x.milkToEspRatio, x.milkML, x.milkCups, x.finalML, x.finalCups};
+    const double ys[] = {y.coffeeGrams, y.brewRatio, y.espressoML, y.espressoCups, y.tablespoons,
+                         y.milkToEspRatio, y.milkML, y.milkCups, y.finalML, y.finalCups};
+    return x.shots == y.shots && x.shotSize == y.shotSize && x.hasMilkTarget == y.hasMilkTarget
+        && x.milkStyle == y.milkStyle && memcmp(xs, ys, sizeof xs) == 0;
+}
+
+bool checkTable(const MenuTable& table, const vector<Order>& orders) {
+    for (const Order& o : orders) {
+        OrderResult fromTable, computed;
+        if (!table.lookup(o, fromTable)) return false;
+        computeOrder(o, computed);
+        if (!sameResult(fromTable, computed)) return false;
+    }
+
+    // off the menu: fractional cups, too many shots, custom milk, registry add-ons
+    Order off = orders.front();
+    off.cups = 1.5;
+    OrderResult r;
+    if (table.lookup(off, r)) return false;
+    off = orders.back();
+    off.extraShots = static_cast<int>(MENU_MAX_SHOTS);
+    if (table.lookup(off, r)) return false;
+    off = orders.back();
+    off.milkStyle = MilkStyle::Custom;
+    off.milkRatio = 1.5;
+    if (table.lookup(off, r)) return false;
+    off = orders.back();
+    off.addOns[off.addOnCount++] = defaultAddOns().find("decaf");
+    return !table.lookup(off, r);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    static const vector<Order> orders = standardOrders();
+    static MenuTable table;
+    table.build();
+
+    if (!checkTable(table, orders)) {
+        cerr << "menu_bench: menu table disagrees with computeOrder\n";
+        return 1;
+    }
+    string path = "menu_bench.tmp";
+    MenuTable reloaded;
+    if (!table.save(path) || !reloaded.load(path) || !checkTable(reloaded, orders)) {
+        cerr << "menu_bench: saved table does not load back identically\n";
+        remove(path.c_str());
+        return 1;
+    }
+
+    bench::Runner runner;
+
+    runner.add("order/computeOrder", [](bench::State& state) {
+        OrderResult r;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            computeOrder(orders[i % orders.size()], r);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    runner.add("order/computeOrderCached", [](bench::State& state) {
+        OrderCache cache(ORDER_CACHE_CAPACITY, ORDER_CACHE_SHARDS);
+        OrderResult r;
+        for (const Order& o : orders) computeOrderCached(o, r, cache);
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            computeOrderCached(orders[i % orders.size()], r, cache);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    runner.add("order/menuLookup", [](bench::State& state) {
+        OrderResult r;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            table.lookup(orders[i % orders.size()], r);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    runner.add("table/build", [](bench::State& state) {
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            MenuTable t;
+            t.build();
+            bench::doNotOptimize(t);
+        }
+    });
+
+    runner.add("table/save+load", [path](bench::State& state) {
+        MenuTable t;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            bool ok = table.save(path) && t.load(path);
+            bench::doNotOptimize(ok);
+        }
+    });
+
+    int status = runner.main(argc, argv);
+    remove(path.c_str());
+    return status;
+}
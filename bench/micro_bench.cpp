@@ -0,0 +1,278 @@
+/******************************************************************
+ * Benchmark: micro_bench
+ * ---------------------------------------------------------------
+ * Micro and macro benchmarks for the core calculator: keyword
+ * helpers, the coffee/latte calcs, drink composition, PresetManager add and
+ * lookup at 10 / 10k / 1M presets, the order result cache, and
+ * summary formatting. Reports
+ * ns/op, allocations/op and throughput; --json writes the same
+ * numbers in machine-readable form for release-to-release diffs.
+ *
+ * Usage: micro_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "batchMode.hpp"
+#include "drinkComposition.hpp"
+#include "functions.hpp"
+#include "orderCache.hpp"
+#include "presetManager.hpp"
+#include "presets.hpp"
+#include "summaryFormat.hpp"
+
+using namespace std;
+
+namespace {
+
+// swallows everything written to it
+class NullBuffer : public streambuf {
+
+    protected:
+
+        int overflow(int c) override { return c; }
+        streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+const Strength COFFEE_STRENGTHS[] = {Strength::Bolder, Strength::Medium, Strength::Weaker};
+const Strength LATTE_STRENGTHS[]  = {Strength::Stronger, Strength::Weaker};
+const Roast    ROASTS[]           = {Roast::Light, Roast::Medium, Roast::Dark};
+
+// 1M distinct presets, built once and shared by the PresetManager benches
+const vector<Presets>& presetPool() {
+    static vector<Presets> pool = [] {
+        vector<Presets> v;
+        v.reserve(1000000);
+        for (size_t i = 0; i < 1000000; ++i) {
+            Presets p("preset-" + to_string(i));
+            if (i % 2 == 0)
+                p.setCoffee(ROASTS[i % 3], COFFEE_STRENGTHS[i % 3], 1.0 + i % 4);
+            else
+                p.setLatte(ShotSize::Double, 1 + i % 4, LATTE_STRENGTHS[i % 2], MilkStyle::Latte, 3.0);
+            v.push_back(p);
+        }
+        return v;
+    }();
+    return pool;
+}
+
+void addPresetBenches(bench::Runner& runner, size_t count) {
+    string suffix = "/" + to_string(count);
+
+    // one op = one addPreset into a manager that grows to count;
+    // whole fills only, so every run covers sizes 0..count
+    size_t fills = (count < 200000) ? 200000 / count : 1;
+    runner.add("PresetManager/add" + suffix, [count](bench::State& state) {
+        state.pauseTiming();
+        const vector<Presets>& pool = presetPool();
+        state.resumeTiming();
+        size_t done = 0;
+        while (done < state.iterations()) {
+            state.pauseTiming();
+            auto manager = make_unique<PresetManager>();
+            state.resumeTiming();
+            for (size_t i = 0; i < count && done < state.iterations(); ++i, ++done) {
+                PresetHandle h = manager->addPreset(pool[i]);
+                bench::doNotOptimize(h);
+            }
+            state.pauseTiming();
+            manager.reset();
+            state.resumeTiming();
+        }
+    }, fills * count);
+
+    // one op = one findPreset by name, scattered over the set
+    auto manager = make_shared<unique_ptr<PresetManager>>();
+    runner.add("PresetManager/find" + suffix, [count, manager](bench::State& state) {
+        state.pauseTiming();
+        const vector<Presets>& pool = presetPool();
+        if (!*manager) {
+            *manager = make_unique<PresetManager>();
+            for (size_t i = 0; i < count; ++i) (*manager)->addPreset(pool[i]);
+        }
+        state.resumeTiming();
+
+        PresetManager& m = **manager;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            PresetHandle h = m.findPreset(pool[(i * 7919) % count].getName());
+            bench::doNotOptimize(h);
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::Runner runner;
+
+    runner.add("toLowerCopy/short", [](bench::State& state) {
+        string input = "FlatWhite";
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            string out = toLowerCopy(input);
+            bench::doNotOptimize(out);
+        }
+    });
+
+    runner.add("toLowerCopy/long", [](bench::State& state) {
+        string input = "Whipped Cream With Cinnamon And Chocolate Shavings";
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            string out = toLowerCopy(input);
+            bench::doNotOptimize(out);
+        }
+    });
+
+    runner.add("milkStyleToRatio", [](bench::State& state) {
+        double sum = 0.0;
+        for (size_t i = 0; i < state.iterations(); ++i)
+            sum += milkStyleToRatio(static_cast<MilkStyle>(i % MILK_STYLE_COUNT));
+        bench::doNotOptimize(sum);
+    });
+
+    runner.add("calcCoffee", [](bench::State& state) {
+        CoffeeResult r;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            calcCoffee(COFFEE_STRENGTHS[i % 3], ROASTS[(i / 3) % 3], 1.0 + (i & 3), r);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    runner.add("calcLatteFromShots", [](bench::State& state) {
+        LatteResult r;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            calcLatteFromShots(LATTE_STRENGTHS[i & 1], (i & 2) ? ShotSize::Double : ShotSize::Single,
+                               1 + static_cast<int>(i & 3), r);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    // a latte with three add-on steps and a milk target, derived in one pass
+    runner.add("DrinkComposition/latte", [](bench::State& state) {
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            DrinkComposition drink;
+            drink.setLatte(Strength::Stronger, ShotSize::Double, 2);
+            if (i & 1) drink.addAddOn(ADDON_ICED);
+            drink.addExtraShots(static_cast<int>(i & 3));
+            drink.addExtraShots(1);
+            drink.setMilkTarget(MilkStyle::Latte, 3.0);
+            LatteResult r;
+            drink.evaluate(r);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    for (size_t count : {size_t(10), size_t(10000), size_t(1000000)})
+        addPresetBenches(runner, count);
+
+    // a latte with milk target and add-ons: direct vs through the cache
+    Order latteOrder;
+    latteOrder.drink = DrinkType::Latte;
+    latteOrder.strength = Strength::Stronger;
+    latteOrder.shotSize = ShotSize::Double;
+    latteOrder.shots = 2;
+    latteOrder.milkStyle = MilkStyle::FlatWhite;
+    latteOrder.milkRatio = milkStyleToRatio(MilkStyle::FlatWhite);
+    latteOrder.iced = true;
+    latteOrder.extraShots = 1;
+
+    runner.add("computeOrder/latte", [latteOrder](bench::State& state) {
+        OrderResult r;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            computeOrder(latteOrder, r);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    runner.add("computeOrderCached/hit", [latteOrder](bench::State& state) {
+        OrderCache cache(ORDER_CACHE_CAPACITY, ORDER_CACHE_SHARDS);
+        OrderResult r;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            computeOrderCached(latteOrder, r, cache);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    // more distinct orders than entries: mostly misses and evictions
+    runner.add("computeOrderCached/churn", [latteOrder](bench::State& state) {
+        OrderCache cache(256, 4);
+        Order order = latteOrder;
+        OrderResult r;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            order.milkRatio = static_cast<double>(i % 4096);
+            computeOrderCached(order, r, cache);
+            bench::doNotOptimize(r);
+        }
+    });
+
+    runner.add("orderCacheKey", [latteOrder](bench::State& state) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < state.iterations(); ++i)
+            sum += orderCacheKey(latteOrder);
+        bench::doNotOptimize(sum);
+    });
+
+    // console summaries, written to a discarding stream
+    runner.add("printCoffeeSummary", [](bench::State& state) {
+        CoffeeResult r;
+        calcCoffee(Strength::Medium, Roast::Dark, 2.0, r);
+        NullBuffer sink;
+        streambuf* saved = cout.rdbuf(&sink);
+        for (size_t i = 0; i < state.iterations(); ++i)
+            printCoffeeSummary(r, Roast::Dark, Strength::Medium);
+        cout.rdbuf(saved);
+    });
+
+    runner.add("printLatteSummary", [](bench::State& state) {
+        LatteResult r;
+        calcLatteFromShots(Strength::Weaker, ShotSize::Double, 3, r);
+        NullBuffer sink;
+        streambuf* saved = cout.rdbuf(&sink);
+        for (size_t i = 0; i < state.iterations(); ++i)
+            printLatteSummary(r, Strength::Weaker);
+        cout.rdbuf(saved);
+    });
+
+    // the shared fixed-buffer formatter behind both front ends
+    runner.add("formatCoffeeSummary", [](bench::State& state) {
+        CoffeeResult r;
+        calcCoffee(Strength::Medium, Roast::Dark, 2.0, r);
+        char buffer[SUMMARY_CAPACITY];
+        SummaryWriter out(buffer);
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            out.clear();
+            formatCoffeeSummary(out, r, Roast::Dark, Strength::Medium);
+            bench::doNotOptimize(buffer);
+        }
+    });
+
+    runner.add("formatLatteSummary", [](bench::State& state) {
+        LatteResult r;
+        calcLatteFromShots(Strength::Weaker, ShotSize::Double, 3, r);
+        char buffer[SUMMARY_CAPACITY];
+        SummaryWriter out(buffer);
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            out.clear();
+            formatLatteSummary(out, r, Strength::Weaker);
+            bench::doNotOptimize(buffer);
+        }
+    });
+
+    // batch row formatting into memory
+    runner.add("writeOrderRow/csv", [](bench::State& state) {
+        OrderResult result;
+        result.drink = DrinkType::Latte;
+        result.ok = calcLatteFromShots(Strength::Stronger, ShotSize::Double, 2, result.latte);
+        OutputBuffer out;
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            if ((i & 1023) == 0) out.clear();
+            writeOrderRow(out, OutputFormat::Csv, i, result, nullptr);
+        }
+        bench::doNotOptimize(out);
+    });
+
+    return runner.main(argc, argv);
+}
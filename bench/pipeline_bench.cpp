@@ -0,0 +1,129 @@
+/******************************************************************
+ * Benchmark: pipeline_bench
+ * ---------------------------------------------------------------
+ * Scaling of the multithreaded order pipeline (runPipeline) from
+ * 1 to N worker threads against the single-threaded loop
+ * (processRecords over the whole input). Input and output stay in
+ * memory; every run's output is compared byte for byte with the
+ * single-threaded output to check ordering.
+ *
+ * Usage: pipeline_bench [orderCount] [maxThreads]
+ ******************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "batchMode.hpp"
+#include "orderPipeline.hpp"
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+string makeOrders(size_t count) {
+    const char* roasts[]   = {"light", "medium", "dark"};
+    const char* coffee[]   = {"bolder", "medium", "weaker"};
+    const char* latte[]    = {"stronger", "weaker"};
+    const char* sizes[]    = {"single", "double"};
+    const char* milk[]     = {"none", "cortado", "flatwhite", "latte", "custom,ratio=1.5"};
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> pick(0, 99);
+    string text;
+    text.reserve(count * 40);
+    for (size_t i = 0; i < count; ++i) {
+        int r = pick(rng);
+        if (r < 50) {
+            text += "coffee,";
+            text += roasts[r % 3];
+            text += ',';
+            text += coffee[(r / 3) % 3];
+            text += (r & 1) ? ",1.5" : ",2";
+            if (r % 5 == 0) text += ",iced";
+        } else {
+            text += "latte,";
+            text += latte[r % 2];
+            text += ',';
+            text += sizes[(r / 2) % 2];
+            text += ',';
+            text += static_cast<char>('1' + r % 4);
+            text += ',';
+            text += milk[r % 5];
+            if (r % 7 == 0) text += ",extra=1";
+        }
+        text += '\n';
+    }
+    return text;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t count = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 1000000;
+    if (count == 0) count = 1000000;
+    unsigned maxThreads = (argc > 2) ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 0;
+    maxThreads = resolveThreadCount(maxThreads);
+
+    string input = makeOrders(count);
+
+    // single-threaded reference
+    OutputBuffer expected;
+    BatchCounts baseCounts;
+    Clock::time_point start = Clock::now();
+    processRecords(input, 1, expected, OutputFormat::Csv, baseCounts);
+    double baseSeconds = secondsSince(start);
+    string_view reference = expected.view();
+
+    cout << "cores reported: " << thread::hardware_concurrency() << "\n";
+    cout << left << setw(16) << "single-threaded"
+         << right << setw(14) << fixed << setprecision(0) << (count / baseSeconds)
+         << " orders/s   (" << setprecision(1) << baseSeconds * 1000.0 << " ms)\n";
+
+    for (unsigned threads = 1; threads <= maxThreads; ++threads) {
+        size_t offset = 0;
+        size_t consumed = 0;
+        bool match = true;
+
+        PipelineReader read = [&](char* dst, size_t len) {
+            size_t n = min(len, input.size() - consumed);
+            memcpy(dst, input.data() + consumed, n);
+            consumed += n;
+            return static_cast<long>(n);
+        };
+        PipelineWriter write = [&](const char* src, size_t len) {
+            if (offset + len > reference.size() || memcmp(src, reference.data() + offset, len) != 0)
+                match = false;
+            offset += len;
+            return true;
+        };
+
+        PipelineOptions options;
+        options.threads = threads;
+        BatchCounts counts;
+        start = Clock::now();
+        runPipeline(read, write, OutputFormat::Csv, options, counts);
+        double seconds = secondsSince(start);
+        match = match && offset == reference.size() && counts.processed == baseCounts.processed;
+
+        cout << left << setw(3) << threads << setw(13) << "thread(s)"
+             << right << setw(14) << setprecision(0) << (count / seconds)
+             << " orders/s   (" << setprecision(1) << seconds * 1000.0 << " ms, "
+             << setprecision(2) << (baseSeconds / seconds) << "x)"
+             << (match ? "" : "   OUTPUT MISMATCH") << "\n";
+        if (!match) return 1;
+    }
+    return 0;
+}
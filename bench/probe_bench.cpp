@@ -0,0 +1,158 @@
+/******************************************************************
+ * Benchmark: probe_bench
+ * ---------------------------------------------------------------
+ * Cost of one probe (instrumentation.hpp), to keep it under the
+ * 20 ns budget for hot paths:
+ *
+ *   probe/off           - PROBE_SCOPE while probes are disabled
+ *   probe/on            - PROBE_SCOPE timing 1 call in
+ *                         PROBE_SAMPLE_EVERY, counting the rest
+ *   probe/on+trace      - timing every call and appending trace
+ *                         events (past PROBE_TRACE_CAPACITY only
+ *                         counted)
+ *   counter/on          - PROBE_COUNT
+ *   ticks/read          - one probeTicks() alone; a timed call
+ *                         makes two, which is why probes sample
+ *   probe/record        - the bookkeeping alone: one timed call
+ *                         added to this thread's block
+ *   calc/coffee+probe   - calcCoffee with its probe on, against
+ *   calc/coffee         - calcCoffee with probes off
+ *
+ * With INSTRUMENT=0 the macro rows measure an empty loop.
+ *
+ * Afterwards a verdict goes to stderr: an enabled probe against
+ * the budget. Over budget the bench exits 1.
+ *
+ * Usage: probe_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "benchHarness.hpp"
+#include "functions.hpp"
+#include "instrumentation.hpp"
+
+using namespace std;
+
+namespace {
+
+// one probe site, as the hot paths use them
+void probedCall(size_t& sink) {
+    PROBE_SCOPE("bench.scope");
+    ++sink;
+}
+
+void runProbes(bench::State& state) {
+    size_t sink = 0;
+    for (size_t i = 0; i < state.iterations(); ++i) probedCall(sink);
+    bench::doNotOptimize(sink);
+}
+
+void runCoffee(bench::State& state) {
+    CoffeeResult r;
+    for (size_t i = 0; i < state.iterations(); ++i) {
+        calcCoffee(Strength::Medium, Roast::Dark, 1.0 + static_cast<double>(i & 7), r);
+        bench::doNotOptimize(r);
+    }
+}
+
+constexpr double PROBE_BUDGET_NS = 20.0;
+
+// ns per call of body, over about 0.2 s
+template <typename Body>
+double nsPerCall(Body body) {
+    const size_t CALLS = 1 << 20;
+    double best = 1e9;
+    for (int round = 0; round < 4; ++round) {
+        auto start = chrono::steady_clock::now();
+        body(CALLS);
+        double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        best = min(best, ns / CALLS);
+    }
+    return best;
+}
+
+// false when an enabled probe is over budget
+bool printVerdict() {
+    double ticks = nsPerCall([](size_t n) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < n; ++i) sum += probeTicks();
+        bench::doNotOptimize(sum);
+    });
+    enableProbes();
+    double probe = nsPerCall([](size_t n) {
+        size_t sink = 0;
+        for (size_t i = 0; i < n; ++i) probedCall(sink);
+        bench::doNotOptimize(sink);
+    });
+    disableProbes();
+
+    bool within = probe <= PROBE_BUDGET_NS;
+    cerr << fixed << setprecision(1) << "probe_bench: enabled probe " << probe << " ns against a " << PROBE_BUDGET_NS
+         << " ns budget (timing 1 call in " << static_cast<int>(PROBE_SAMPLE_EVERY) << ", 2 tick reads "
+         << 2 * ticks << " ns per timed call): " << (within ? "within budget" : "OVER budget") << '\n';
+    return within;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    bench::Runner runner;
+
+    runner.add("probe/off", [](bench::State& state) {
+        disableProbes();
+        runProbes(state);
+    });
+
+    runner.add("probe/on", [](bench::State& state) {
+        enableProbes();
+        runProbes(state);
+        disableProbes();
+    });
+
+    runner.add("probe/on+trace", [](bench::State& state) {
+        enableProbes(true);
+        runProbes(state);
+        disableProbes();
+    });
+
+    runner.add("counter/on", [](bench::State& state) {
+        enableProbes();
+        for (size_t i = 0; i < state.iterations(); ++i) PROBE_COUNT("bench.counter", 1);
+        disableProbes();
+    });
+
+    runner.add("ticks/read", [](bench::State& state) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < state.iterations(); ++i) sum += probeTicks();
+        bench::doNotOptimize(sum);
+    });
+
+    runner.add("probe/record", [](bench::State& state) {
+        enableProbes();
+        ProbeId id = registerProbe("bench.record");
+        for (size_t i = 0; i < state.iterations(); ++i)
+            probe_detail::record(id, 1000, 1040 + (i & 7));
+        disableProbes();
+    });
+
+    runner.add("calc/coffee", [](bench::State& state) {
+        disableProbes();
+        runCoffee(state);
+    });
+
+    runner.add("calc/coffee+probe", [](bench::State& state) {
+        enableProbes();
+        runCoffee(state);
+        disableProbes();
+    });
+
+    int status = runner.main(argc, argv);
+#if COFFEE_INSTRUMENT
+    if (status == 0 && !printVerdict()) status = 1;
+#endif
+    return status;
+}
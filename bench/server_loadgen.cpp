@@ -0,0 +1,302 @@
+/******************************************************************
+ * Benchmark: server_loadgen
+ * ---------------------------------------------------------------
+ * Load generator for daemon mode (orderServer.hpp). N client
+ * threads each keep `depth` requests in flight on their own
+ * connection and time every request from send to reply:
+ *
+ *   line    - record lines, CSV rows back
+ *   binary  - WireRequest frames, WireResponse frames back
+ *
+ * Reports throughput and p50/p99/p999/max latency per protocol.
+ * Without --socket it starts its own server on a temporary socket
+ * in this process (presets off, so presets.bin is not touched).
+ * Before timing, one request of every sample order must come back
+ * byte for byte as batch mode / fromWire would answer it.
+ *
+ * Usage: server_loadgen [--socket=path] [--clients=N] [--requests=N]
+ *                       [--depth=N] [--protocol=line|binary|both]
+ ******************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "orderServer.hpp"
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+#ifdef __linux__
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+const char* const SAMPLE_ORDERS[] = {
+    "coffee,dark,bolder,2",
+    "latte,stronger,double,2,cortado",
+    "coffee,light,medium,1.5,iced,decaf",
+    "latte,weaker,single,3,custom,ratio=2.5,extra=1",
+    "latte,stronger,single,auto,latte,volume=350",
+    "coffee,medium,weaker,3,chocolate",
+};
+
+struct Workload {
+    vector<string>      lines;    // with '\n'
+    vector<WireRequest> frames;
+    vector<OrderResult> results;  // expected, for the check
+};
+
+struct ClientResult {
+    vector<double> latencyUs;
+    bool ok = true;
+};
+
+Workload makeWorkload() {
+    Workload w;
+    for (const char* text : SAMPLE_ORDERS) {
+        Order order;
+        OrderResult result;
+        const char* error = nullptr;
+        if (!parseOrderLine(text, order, error) || !computeOrder(order, result)) continue;
+        w.lines.push_back(string(text) + "\n");
+        w.frames.push_back(toWire(order, static_cast<uint32_t>(w.frames.size())));
+        w.results.push_back(result);
+    }
+    return w;
+}
+
+int connectTo(const string& path) {
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof addr.sun_path) return -1;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    return fd;
+}
+
+bool sendAll(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool recvExactly(int fd, string& out, size_t len) {
+    out.resize(len);
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = ::read(fd, &out[got], len - got);
+        if (n <= 0) return false;
+        got += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// every sample once per protocol, compared with the local answer
+bool checkReplies(const string& path, const Workload& w) {
+    int fd = connectTo(path);
+    if (fd < 0) return false;
+
+    string request;
+    OutputBuffer expected;
+    for (size_t i = 0; i < w.lines.size(); ++i) {
+        request += w.lines[i];
+        writeOrderRow(expected, OutputFormat::Csv, i + 1, w.results[i], nullptr);
+    }
+    for (size_t i = 0; i < w.frames.size(); ++i) {
+        request.append(reinterpret_cast<const char*>(&w.frames[i]), sizeof(WireRequest));
+        WireResponse r = wireResponse(w.frames[i].id, w.results[i], WireStatus::Ok);
+        expected.append(string_view(reinterpret_cast<const char*>(&r), sizeof r));
+    }
+
+    string reply;
+    bool ok = sendAll(fd, request.data(), request.size())
+           && recvExactly(fd, reply, expected.view().size())
+           && reply == expected.view();
+    ::close(fd);
+    return ok;
+}
+
+/******************************************************************
+ * Function: runClient
+ * ---------------------------------------------------------------
+ * One connection: tops the pipeline up to depth requests in one
+ * write, then reads whatever replies have arrived. Replies come
+ * back in order, so the oldest send time belongs to the next one.
+ ******************************************************************/
+void runClient(const string& path, const Workload& w, bool binary, size_t total, size_t depth,
+               ClientResult& out) {
+    int fd = connectTo(path);
+    if (fd < 0) {
+        out.ok = false;
+        return;
+    }
+    out.latencyUs.reserve(total);
+
+    vector<Clock::time_point> sentAt(depth);
+    string batch;
+    vector<char> buf(64 * 1024);
+    size_t carry = 0;       // partial binary reply
+    size_t sent = 0, done = 0;
+
+    while (done < total) {
+        batch.clear();
+        Clock::time_point now = Clock::now();
+        for (; sent < total && sent - done < depth; ++sent) {
+            size_t k = sent % w.lines.size();
+            if (binary) batch.append(reinterpret_cast<const char*>(&w.frames[k]), sizeof(WireRequest));
+            else batch += w.lines[k];
+            sentAt[sent % depth] = now;
+        }
+        if (!batch.empty() && !sendAll(fd, batch.data(), batch.size())) break;
+
+        ssize_t n = ::read(fd, buf.data() + carry, buf.size() - carry);
+        if (n <= 0) break;
+        Clock::time_point arrived = Clock::now();
+
+        size_t replies = 0;
+        if (binary) {
+            size_t have = carry + static_cast<size_t>(n);
+            replies = have / sizeof(WireResponse);
+            carry = have % sizeof(WireResponse);
+            memmove(buf.data(), buf.data() + replies * sizeof(WireResponse), carry);
+        } else {
+            replies = static_cast<size_t>(count(buf.data(), buf.data() + n, '\n'));
+        }
+        for (size_t i = 0; i < replies; ++i, ++done)
+            out.latencyUs.push_back(chrono::duration<double, micro>(arrived - sentAt[done % depth]).count());
+    }
+    out.ok = done == total;
+    ::close(fd);
+}
+
+double percentile(vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    size_t k = min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+bool runLoad(const string& path, const Workload& w, bool binary, size_t clients, size_t requests,
+             size_t depth) {
+    vector<ClientResult> results(clients);
+    vector<thread> threads;
+    Clock::time_point start = Clock::now();
+    for (size_t c = 0; c < clients; ++c)
+        threads.emplace_back(runClient, cref(path), cref(w), binary, requests, depth, ref(results[c]));
+    for (thread& t : threads) t.join();
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    vector<double> all;
+    for (ClientResult& r : results) {
+        if (!r.ok) {
+            cerr << "server_loadgen: a client lost its connection\n";
+            return false;
+        }
+        all.insert(all.end(), r.latencyUs.begin(), r.latencyUs.end());
+    }
+
+    double maxUs = all.empty() ? 0.0 : *max_element(all.begin(), all.end());
+    cout << left << setw(8) << (binary ? "binary" : "line") << right << fixed
+         << setw(12) << setprecision(0) << (seconds > 0 ? all.size() / seconds : 0.0) << " req/s"
+         << "   p50 " << setw(8) << setprecision(1) << percentile(all, 0.50) << " us"
+         << "   p99 " << setw(8) << percentile(all, 0.99) << " us"
+         << "   p999 " << setw(8) << percentile(all, 0.999) << " us"
+         << "   max " << setw(9) << maxUs << " us\n";
+    return true;
+}
+
+bool parseCount(const string& arg, const char* flag, size_t& out) {
+    size_t len = strlen(flag);
+    if (arg.compare(0, len, flag) != 0) return false;
+    out = strtoul(arg.c_str() + len, nullptr, 10);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    string path;
+    size_t clients = 4, requests = 50000, depth = 32;
+    bool lines = true, binary = true;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg.rfind("--socket=", 0) == 0) path = arg.substr(9);
+        else if (parseCount(arg, "--clients=", clients) || parseCount(arg, "--requests=", requests)
+                 || parseCount(arg, "--depth=", depth)) {}
+        else if (arg == "--protocol=line") binary = false;
+        else if (arg == "--protocol=binary") lines = false;
+        else if (arg == "--protocol=both") lines = binary = true;
+        else {
+            cerr << "Usage: " << argv[0] << " [--socket=path] [--clients=N] [--requests=N]"
+                 << " [--depth=N] [--protocol=line|binary|both]\n";
+            return 1;
+        }
+    }
+    if (clients == 0 || requests == 0 || depth == 0) {
+        cerr << "server_loadgen: counts must be positive\n";
+        return 1;
+    }
+
+    // self-hosted unless pointed at a running daemon
+    OrderServer server;
+    thread serving;
+    if (path.empty()) {
+        ServerOptions options;
+        options.socketPath = "server_loadgen.sock";
+        options.presets = false;
+        string error;
+        if (!server.open(options, error)) {
+            cerr << "server_loadgen: " << error << "\n";
+            return 1;
+        }
+        path = options.socketPath;
+        serving = thread([&server] { server.run(); });
+    }
+
+    Workload w = makeWorkload();
+    bool ok = checkReplies(path, w);
+    if (!ok) cerr << "server_loadgen: replies differ from the local calculation\n";
+
+    if (ok) {
+        cout << "server_loadgen: " << clients << " clients x " << requests << " requests, depth "
+             << depth << (serving.joinable() ? " (in-process server)" : "") << "\n";
+        if (lines) ok = runLoad(path, w, false, clients, requests, depth);
+        if (ok && binary) ok = runLoad(path, w, true, clients, requests, depth);
+    }
+
+    if (serving.joinable()) {
+        server.stop();
+        serving.join();
+    }
+    return ok ? 0 : 1;
+}
+
+#else
+
+int main() {
+    cout << "server_loadgen: daemon mode needs Linux (epoll); skipped\n";
+    return 0;
+}
+
+#endif
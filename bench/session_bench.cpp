@@ -0,0 +1,96 @@
+/******************************************************************
+ * Benchmark: session_bench
+ * ---------------------------------------------------------------
+ * Heap traffic of order sessions on the headless UI (UiMachine).
+ * One op is a whole session from the main menu and back: a latte
+ * with a typed topping longer than any small-string buffer, then
+ * an iced coffee with another one.
+ *
+ *   ui/order-session    - the two drinks, ending in resetToMenu()
+ *   ui/reset            - resetToMenu() alone (arena release)
+ *
+ * The typed answers live on the session arena, so allocs/op should
+ * read 0 once the machine is warm; the arena's heap fallback count
+ * is printed at the end. Before timing, a session must reach both
+ * summaries with the toppings in them.
+ *
+ * Usage: session_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "presetManager.hpp"
+#include "uiReplay.hpp"
+#include "uiStateMachine.hpp"
+
+using namespace std;
+
+namespace {
+
+// latte (stronger, double x2, flatwhite) + topping, then coffee (medium, bolder, 1.5) iced + topping
+const char SESSION_TRACE[] =
+    "enter\ndown\nenter\nenter\ndown\nenter\nup\nenter\ndown\ndown\nenter\n"
+    "down\nenter\ndown\nenter\ntext cinnamon and toasted nutmeg\nenter\n"
+    "down\ndown\ndown\nenter\nenter\n"
+    "enter\nenter\ndown\nenter\nenter\nup\nenter\n"
+    "down\nenter\nenter\ndown\nenter\ntext dark chocolate shavings\nenter\n"
+    "down\ndown\nenter\nenter\n";
+
+struct Session {
+    PresetManager presets;
+    unique_ptr<UiMachine> machine;
+    vector<UiEvent> events;
+    size_t summaries = 0;
+    bool toppingsShown = true;
+
+    Session() : machine(make_unique<UiMachine>(presets)) {
+        size_t errorLine = 0;
+        if (!parseUiTrace(SESSION_TRACE, events, errorLine))
+            cerr << "session_bench: bad trace line " << errorLine << "\n";
+    }
+
+    void run(bool check) {
+        for (const UiEvent& e : events) {
+            machine->handle(e);
+            if (check && machine->state().screen == Screen::Summary && e.key == UiKey::Enter
+                && machine->state().summary[0] != '\0') {
+                const char* s = machine->state().summary;
+                if (!strstr(s, "cinnamon and toasted nutmeg") && !strstr(s, "dark chocolate shavings"))
+                    toppingsShown = false;
+                ++summaries;
+            }
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Session session;
+    session.run(true);
+    if (session.summaries != 2 || !session.toppingsShown
+        || session.machine->state().screen != Screen::MainMenu) {
+        cerr << "session_bench: the session did not produce both drinks\n";
+        return 1;
+    }
+
+    bench::Runner runner;
+
+    runner.add("ui/order-session", [&session](bench::State& state) {
+        for (size_t i = 0; i < state.iterations(); ++i) session.run(false);
+    });
+
+    runner.add("ui/reset", [&session](bench::State& state) {
+        for (size_t i = 0; i < state.iterations(); ++i) session.machine->resetToMenu();
+    });
+
+    int status = runner.main(argc, argv);
+    const SessionArena& arena = session.machine->sessionArena();
+    cout << "session arena: " << arena.sessionsEnded() << " sessions, "
+         << arena.heapBlocks() << " heap blocks borrowed\n";
+    return status;
+}
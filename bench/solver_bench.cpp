@@ -0,0 +1,184 @@
+/******************************************************************
+ * Benchmark: solver_bench
+ * ---------------------------------------------------------------
+ * Sizing a whole menu board (every drink x cup size) from target
+ * volumes:
+ *
+ *   board/solveMenu      - the batched closed-form solver
+ *   board/sizeOrder      - one sizeOrder call per cell (rebuilds
+ *                          the line every time)
+ *   board/forward-search - counting shots up with computeOrder
+ *                          until the cup is full, as one would
+ *                          without an inverse
+ *
+ * Before timing, every cell is checked against computeOrder: the
+ * solved size must give the reported amount, respect its rounding
+ * policy, and be the best whole shot count for it.
+ *
+ * Usage: solver_bench [--filter=substr] [--min-time=sec] [--json[=file]]
+ ******************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "benchHarness.hpp"
+#include "inverseSolver.hpp"
+
+using namespace std;
+
+namespace {
+
+// US cup sizes, 4 to 24 fl oz
+const double CUP_ML[] = {118.0, 177.0, 237.0, 296.0, 355.0, 473.0, 591.0, 710.0};
+constexpr size_t CUP_COUNT = sizeof(CUP_ML) / sizeof(CUP_ML[0]);
+
+// every recipe, each plain, iced and with a few add-ons
+vector<Order> makeMenu() {
+    const AddOnRegistry& reg = defaultAddOns();
+    const char* const LATTE_EXTRAS[] = {"", "ristretto", "extra-milk", "lungo"};
+    const char* const COFFEE_EXTRAS[] = {"", "short", "americano-top"};
+    const MilkStyle STYLES[] = {MilkStyle::None, MilkStyle::Cortado, MilkStyle::FlatWhite, MilkStyle::Latte};
+
+    vector<Order> menu;
+    for (bool iced : {false, true}) {
+        for (Strength s : {Strength::Bolder, Strength::Medium, Strength::Weaker})
+            for (Roast r : {Roast::Light, Roast::Medium, Roast::Dark})
+                for (const char* extra : COFFEE_EXTRAS) {
+                    Order o;
+                    o.drink = DrinkType::Coffee;
+                    o.strength = s;
+                    o.roast = r;
+                    o.iced = iced;
+                    if (*extra) o.addOns[o.addOnCount++] = reg.find(extra);
+                    menu.push_back(o);
+                }
+        for (ShotSize z : {ShotSize::Single, ShotSize::Double})
+            for (Strength s : {Strength::Stronger, Strength::Weaker})
+                for (MilkStyle m : STYLES)
+                    for (const char* extra : LATTE_EXTRAS) {
+                        Order o;
+                        o.drink = DrinkType::Latte;
+                        o.strength = s;
+                        o.shotSize = z;
+                        o.milkStyle = m;
+                        o.milkRatio = milkStyleToRatio(m);
+                        o.iced = iced;
+                        if (*extra) o.addOns[o.addOnCount++] = reg.find(extra);
+                        menu.push_back(o);
+                    }
+    }
+    return menu;
+}
+
+double finalML(const OrderResult& r) {
+    if (r.drink == DrinkType::Coffee) return r.coffee.waterML;
+    return r.latte.hasMilkTarget ? r.latte.finalML : r.latte.espressoML;
+}
+
+// the order at a solved size, run forward
+double forward(Order o, const SizedDrink& size, int shotDelta = 0) {
+    if (o.drink == DrinkType::Coffee) o.cups = size.cups;
+    else o.shots = size.shots + shotDelta;
+    OrderResult r;
+    return (o.shots >= 0 && computeOrder(o, r)) ? finalML(r) : NAN;
+}
+
+bool checkBoard(const vector<Order>& menu, ShotRounding rounding) {
+    vector<SizedDrink> board(menu.size() * CUP_COUNT);
+    solveMenu(menu.data(), menu.size(), CUP_ML, CUP_COUNT, SizeBy::Volume, rounding, board.data());
+
+    for (size_t d = 0; d < menu.size(); ++d) {
+        for (size_t c = 0; c < CUP_COUNT; ++c) {
+            const SizedDrink& s = board[d * CUP_COUNT + c];
+            double target = CUP_ML[c];
+            if (!s.ok) {
+                if (rounding != ShotRounding::Down) return false;   // only down may not fit
+                continue;
+            }
+            double got = forward(menu[d], s);
+            if (fabs(got - s.amount) > 1e-6 * target) return false;
+            if (menu[d].drink == DrinkType::Coffee) {
+                if (fabs(got - target) > 1e-6 * target) return false;
+                continue;
+            }
+            double more = forward(menu[d], s, 1), less = forward(menu[d], s, -1);
+            bool best = true;
+            if (rounding == ShotRounding::Down)
+                best = got <= target + 1e-9 && !(more <= target + 1e-9);
+            else if (rounding == ShotRounding::Up)
+                best = got >= target - 1e-9 && (s.shots == 1 || !(less >= target - 1e-9));
+            else
+                best = !(fabs(more - target) < fabs(got - target))
+                    && (s.shots == 1 || !(fabs(less - target) < fabs(got - target)));
+            if (!best) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    static const vector<Order> menu = makeMenu();
+
+    for (ShotRounding r : {ShotRounding::Nearest, ShotRounding::Down, ShotRounding::Up}) {
+        if (!checkBoard(menu, r)) {
+            cerr << "solver_bench: solved sizes disagree with computeOrder (rounding "
+                 << static_cast<int>(r) << ")\n";
+            return 1;
+        }
+    }
+    cout << "menu: " << menu.size() << " drinks x " << CUP_COUNT << " cup sizes\n";
+
+    bench::Runner runner;
+    const double cells = static_cast<double>(menu.size() * CUP_COUNT);
+
+    runner.add("board/solveMenu", [cells](bench::State& state) {
+        vector<SizedDrink> board(menu.size() * CUP_COUNT);
+        state.setItemsPerOp(cells);
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            solveMenu(menu.data(), menu.size(), CUP_ML, CUP_COUNT,
+                      SizeBy::Volume, ShotRounding::Nearest, board.data());
+            bench::doNotOptimize(board);
+        }
+    });
+
+    runner.add("board/sizeOrder", [cells](bench::State& state) {
+        state.setItemsPerOp(cells);
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            for (const Order& drink : menu) {
+                for (double ml : CUP_ML) {
+                    Order o = drink;
+                    o.sizeBy = SizeBy::Volume;
+                    o.sizeAmount = ml;
+                    bool ok = sizeOrder(o);
+                    bench::doNotOptimize(ok);
+                    bench::doNotOptimize(o);
+                }
+            }
+        }
+    });
+
+    // coffee has no whole-number size to count, so this covers lattes only
+    runner.add("board/forward-search", [](bench::State& state) {
+        size_t lattes = 0;
+        for (const Order& drink : menu) lattes += (drink.drink == DrinkType::Latte);
+        state.setItemsPerOp(static_cast<double>(lattes * CUP_COUNT));
+        for (size_t i = 0; i < state.iterations(); ++i) {
+            for (const Order& drink : menu) {
+                if (drink.drink != DrinkType::Latte) continue;
+                for (double ml : CUP_ML) {
+                    Order o = drink;
+                    OrderResult r;
+                    for (o.shots = 1; o.shots < 1000; ++o.shots) {
+                        if (computeOrder(o, r) && finalML(r) >= ml) break;
+                    }
+                    bench::doNotOptimize(o);
+                }
+            }
+        }
+    });
+
+    return runner.main(argc, argv);
+}
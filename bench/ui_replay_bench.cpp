@@ -0,0 +1,102 @@
+/******************************************************************
+ * Benchmark: ui_replay_bench
+ * ---------------------------------------------------------------
+ * Throughput of the headless UI state machine (UiMachine) on a
+ * fixed session: a coffee, a latte with every addon, and creating
+ * and loading a preset. Reports events/s over repeated replays and
+ * the per-event handle() latency (p50/p99) from a sampled pass.
+ *
+ * Usage: ui_replay_bench [repeats]
+ ******************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "uiReplay.hpp"
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+// same format the GUI records with --record
+const char SESSION_TRACE[] =
+    "# coffee: medium, bolder, 1.5 cups, no addons\n"
+    "enter\nenter\ndown\nenter\nenter\nup\nenter\nenter\nenter\n"
+    "# latte: stronger, double x2, flatwhite, iced + topping + 2 extra shots\n"
+    "enter\ndown\nenter\nenter\ndown\nenter\nup\nenter\ndown\ndown\nenter\n"
+    "down\nenter\nenter\ndown\nenter\ntext cinnamon\nenter\n"
+    "down\ndown\nenter\nup\nenter\nup\nenter\nenter\n"
+    "# create preset 'morning' (light, bolder, 1 cup), then load it\n"
+    "down\nenter\ntext morning\nenter\nenter\nenter\nenter\nenter\nenter\nenter\n"
+    "down\ndown\nenter\nenter\nenter\n"
+    "# back/restart navigation\n"
+    "enter\nenter\nleft\nleft\ndown\nenter\nesc\n";
+
+double percentile(vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    size_t k = static_cast<size_t>(p * (samples.size() - 1));
+    nth_element(samples.begin(), samples.begin() + k, samples.end());
+    return samples[k];
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t repeats = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 20000;
+    if (repeats == 0) repeats = 1;
+
+    vector<UiEvent> events;
+    size_t errorLine = 0;
+    if (!parseUiTrace(SESSION_TRACE, events, errorLine)) {
+        cerr << "bad trace line " << errorLine << endl;
+        return 1;
+    }
+
+    // throughput: a fresh machine and preset list per session
+    uint64_t digest = 0;
+    size_t total = 0, summaries = 0;
+    auto start = Clock::now();
+    for (size_t r = 0; r < repeats; ++r) {
+        PresetManager presets;
+        UiMachine machine(presets);
+        ReplayStats stats = replayUiTrace(machine, events);
+        if (r == 0) digest = stats.digest;
+        else if (stats.digest != digest) {
+            cerr << "digest changed between replays" << endl;
+            return 1;
+        }
+        total += stats.events;
+        summaries += stats.summaries;
+    }
+    double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+    // latency: time each handle() separately on a smaller sample
+    size_t sampled = min<size_t>(repeats, 2000);
+    vector<double> ns;
+    ns.reserve(sampled * events.size());
+    for (size_t r = 0; r < sampled; ++r) {
+        PresetManager presets;
+        UiMachine machine(presets);
+        for (const UiEvent& e : events) {
+            auto t0 = Clock::now();
+            machine.handle(e);
+            ns.push_back(chrono::duration<double, nano>(Clock::now() - t0).count());
+            if (machine.quitRequested()) machine.clearQuit();
+        }
+    }
+
+    cout << fixed << setprecision(0);
+    cout << "session: " << events.size() << " events, " << summaries / repeats
+         << " summaries, digest " << hex << digest << dec << "\n";
+    cout << "replay:  " << total << " events in " << setprecision(3) << seconds << " s  ("
+         << setprecision(0) << total / seconds << " events/s)\n";
+    cout << "handle:  p50 " << percentile(ns, 0.50) << " ns, p99 " << percentile(ns, 0.99)
+         << " ns (" << ns.size() << " samples)\n";
+    return 0;
+}
@@ -0,0 +1,124 @@
+#ifndef ADDONREGISTRY_HPP
+#define ADDONREGISTRY_HPP
+
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "drinkTypes.hpp"
+
+// what an add-on can change (shots, g, mL, ratio, mL, mg); indexes AddOnEffect
+enum class Quantity : unsigned char { Shots, Grams, Water, BrewRatio, Milk, Caffeine };
+constexpr std::size_t QUANTITY_COUNT = 6;
+
+/******************************************************************
+ * Struct: AddOnEffect
+ * ---------------------------------------------------------------
+ * Flat coefficient vector: each quantity x becomes
+ * x * scale + offset. Effects compose into one effect of the same
+ * shape (then()), so any chain of add-ons collapses into a single
+ * vector that is applied once when the drink is evaluated. The
+ * default is the identity.
+ ******************************************************************/
+struct AddOnEffect {
+    double scale[QUANTITY_COUNT]  = {1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+    double offset[QUANTITY_COUNT] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+    constexpr AddOnEffect scaled(Quantity q, double factor) const {
+        AddOnEffect e = *this;
+        e.scale[indexOf(q)] *= factor;
+        e.offset[indexOf(q)] *= factor;
+        return e;
+    }
+
+    constexpr AddOnEffect plus(Quantity q, double amount) const {
+        AddOnEffect e = *this;
+        e.offset[indexOf(q)] += amount;
+        return e;
+    }
+
+    // this effect followed by next
+    AddOnEffect& then(const AddOnEffect& next) {
+#pragma GCC unroll 6
+        for (std::size_t i = 0; i < QUANTITY_COUNT; ++i) {
+            offset[i] = offset[i] * next.scale[i] + next.offset[i];
+            scale[i] *= next.scale[i];
+        }
+        return *this;
+    }
+
+    double apply(Quantity q, double x) const {
+        return x * scale[indexOf(q)] + offset[indexOf(q)];
+    }
+
+    // true if q passes through unchanged
+    bool isIdentity(Quantity q) const {
+        return scale[indexOf(q)] == 1.0 && offset[indexOf(q)] == 0.0;
+    }
+};
+
+// which drinks an add-on is offered for
+constexpr unsigned char FOR_COFFEE = 1;
+constexpr unsigned char FOR_LATTE  = 2;
+constexpr unsigned char FOR_ANY    = FOR_COFFEE | FOR_LATTE;
+
+/******************************************************************
+ * Struct: AddOnSpec
+ * ---------------------------------------------------------------
+ * One menu modifier: its name (as typed in orders and menus),
+ * the drinks it applies to, and its effect. Effects on quantities
+ * a drink does not have (water on a latte, milk on a coffee) are
+ * ignored.
+ ******************************************************************/
+struct AddOnSpec {
+    const char*   name;
+    unsigned char drinks;
+    AddOnEffect   effect;
+};
+
+using AddOnId = unsigned short;
+constexpr AddOnId NO_ADDON = 0xFFFF;
+
+// fixed ids of the built-in add-ons the code refers to directly
+constexpr AddOnId ADDON_ICED = 0;
+constexpr AddOnId ADDON_EXTRA_SHOT = 1;
+
+/******************************************************************
+ * Class: AddOnRegistry
+ * ---------------------------------------------------------------
+ * The add-on menu as data. Ids are positions in registration
+ * order; names are copied in, so specs may come from anywhere.
+ ******************************************************************/
+class AddOnRegistry {
+
+    public:
+
+        AddOnRegistry() = default;
+
+        // NO_ADDON if the name is empty or already taken
+        AddOnId add(const AddOnSpec& spec);
+
+        // names match case-insensitively
+        AddOnId find(std::string_view name) const;
+        const AddOnSpec& spec(AddOnId id) const { return specs[id]; }
+        std::size_t size() const { return specs.size(); }
+
+        bool appliesTo(AddOnId id, DrinkType drink) const {
+            unsigned char mask = (drink == DrinkType::Coffee) ? FOR_COFFEE : FOR_LATTE;
+            return id < specs.size() && (specs[id].drinks & mask) != 0;
+        }
+
+        // fused effect of the add-ons that apply to drink, in order
+        AddOnEffect compile(const AddOnId* ids, std::size_t count, DrinkType drink) const;
+
+    private:
+
+        std::vector<AddOnSpec> specs;
+        std::deque<std::string> names;   // stable storage behind spec.name
+};
+
+// the built-in menu (see ADDON_MENU in addonRegistry.cpp)
+const AddOnRegistry& defaultAddOns();
+
+#endif
@@ -1,22 +1,18 @@
 #ifndef ADDONS_HPP
 #define ADDONS_HPP
 
-#include "functions.hpp"
+#include "drinkComposition.hpp"
 #include "constants.hpp"
 #include <iostream>
 #include <string>
 using namespace std;
 
-// Handles add-ons for coffee drinks
-void handleCoffeeAddOns(CoffeeResult& coffee);
+class ConsoleInput;
 
-// Applies add-on logic for coffee (GUI/Console shared)
-void applyCoffeeAddons(CoffeeResult& coffee, bool isIced, const std::string& topping);
+// Asks for coffee add-ons and records them on the drink
+void handleCoffeeAddOns(ConsoleInput& in, DrinkComposition& coffee);
 
-// Handles add-ons for latte drinks
-void handleLatteAddOns(LatteResult& latte);
-
-// Applies add-on logic for latte (GUI/Console shared)
-void applyLatteAddons(LatteResult& latte, bool isIced, int extraShots, const std::string& topping);
+// Asks for latte add-ons and records them on the drink
+void handleLatteAddOns(ConsoleInput& in, DrinkComposition& latte);
 
 #endif
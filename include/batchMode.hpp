@@ -0,0 +1,105 @@
+#ifndef BATCHMODE_HPP
+#define BATCHMODE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "orderRecord.hpp"
+
+enum class OutputFormat { Csv, Jsonl };
+
+// recipe math for batch orders: doubles (computeOrder) or fixed point (fixedRecipe.hpp)
+enum class CalcEngine { Double, Fixed };
+
+class InventoryForecast;
+
+/******************************************************************
+ * Struct: BatchOptions
+ * ---------------------------------------------------------------
+ * Settings for non-interactive batch mode (--batch).
+ ******************************************************************/
+struct BatchOptions {
+    std::string  inputPath;            // empty or "-" = stdin
+    OutputFormat format = OutputFormat::Csv;
+    unsigned     threads = 0;          // 0 = one per core, 1 = no worker threads
+    bool         stats = false;        // consumption report on stderr
+    bool         inventory = false;    // bean/milk forecast on stderr
+    double       beansStockG = 0.0;
+    double       milkStockML = 0.0;
+    std::string  menuPath;             // precomputed menu table; empty = build in memory
+    CalcEngine   engine = CalcEngine::Double;
+};
+
+/******************************************************************
+ * Struct: BatchCounts
+ * ---------------------------------------------------------------
+ * Running totals of processed and invalid records.
+ ******************************************************************/
+struct BatchCounts {
+    std::size_t processed = 0;
+    std::size_t failed = 0;
+};
+
+/******************************************************************
+ * Class: OutputBuffer
+ * ---------------------------------------------------------------
+ * Fixed-capacity output buffer written to a file descriptor in
+ * large blocks. Numbers are formatted with std::to_chars. The
+ * default constructor gives a growable in-memory buffer instead
+ * (flush is a no-op; read it back with view()).
+ ******************************************************************/
+class OutputBuffer {
+
+    public:
+
+        explicit OutputBuffer(int fd, std::size_t capacity = 1 << 20);
+        OutputBuffer();
+        ~OutputBuffer();
+
+        OutputBuffer(const OutputBuffer&) = delete;
+        OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+        void append(std::string_view s);
+        void append(char c);
+        void appendInt(long long v);
+        void appendFixed2(double v);   // 2 decimals, like the summaries
+        bool flush();
+
+        // a write to the fd has failed since construction
+        bool failed() const { return writeFailed; }
+
+        // keeps at least n bytes free (flushes or grows if needed)
+        void reserve(std::size_t n);
+
+        // memory mode: buffered bytes and reset
+        std::string_view view() const { return std::string_view(data, used); }
+        void clear() { used = 0; }
+
+    private:
+
+        int fd;
+        char* data;
+        std::size_t capacity;
+        std::size_t used = 0;
+        bool writeFailed = false;
+};
+
+// writes the CSV header row (no-op for JSONL)
+void writeOrderHeader(OutputBuffer& out, OutputFormat format);
+
+// formats one processed record (error may be null when ok)
+void writeOrderRow(OutputBuffer& out, OutputFormat format, std::size_t lineNo,
+                   const OrderResult& result, const char* error);
+
+// parse -> calc -> add-ons -> format for a block of whole lines;
+// returns the number of lines consumed. Valid orders are also
+// consumed from inventory, if given.
+std::size_t processRecords(std::string_view text, std::size_t firstLine, OutputBuffer& out,
+                           OutputFormat format, BatchCounts& counts,
+                           InventoryForecast* inventory = nullptr,
+                           CalcEngine engine = CalcEngine::Double);
+
+// parse -> calc -> add-ons -> format for every record in the input
+int runBatch(const BatchOptions& options);
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef BOUNDEDQUEUE_HPP
+#define BOUNDEDQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/******************************************************************
+ * Class: BoundedQueue
+ * ---------------------------------------------------------------
+ * Fixed-capacity lock-free multi-producer / multi-consumer FIFO
+ * (Vyukov's bounded queue). Each cell carries a sequence number
+ * that tells producers and consumers whose turn it is, so push
+ * and pop are a single CAS on the shared index in the common case.
+ * Capacity is rounded up to a power of two. T should be cheap to
+ * copy (pointers, handles).
+ ******************************************************************/
+template <typename T>
+class BoundedQueue {
+
+    public:
+
+        explicit BoundedQueue(std::size_t capacity) {
+            std::size_t size = 2;
+            while (size < capacity) size *= 2;
+            mask = size - 1;
+            cells.reset(new Cell[size]);
+            for (std::size_t i = 0; i < size; ++i)
+                cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // false if the queue is full
+        bool push(const T& value) {
+            std::size_t pos = tail.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells[pos & mask];
+                std::size_t seq = cell->seq.load(std::memory_order_acquire);
+                std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+                if (dif == 0) {
+                    if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (dif < 0) {
+                    return false;
+                } else {
+                    pos = tail.load(std::memory_order_relaxed);
+                }
+            }
+            cell->value = value;
+            cell->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // false if the queue is empty
+        bool pop(T& value) {
+            std::size_t pos = head.load(std::memory_order_relaxed);
+            Cell* cell;
+            for (;;) {
+                cell = &cells[pos & mask];
+                std::size_t seq = cell->seq.load(std::memory_order_acquire);
+                std::ptrdiff_t dif = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+                if (dif == 0) {
+                    if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (dif < 0) {
+                    return false;
+                } else {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+            value = cell->value;
+            cell->seq.store(pos + mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t capacity() const { return mask + 1; }
+
+    private:
+
+        struct Cell {
+            std::atomic<std::size_t> seq;
+            T value;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        std::size_t mask = 0;
+
+        // producers and consumers on separate cache lines
+        alignas(64) std::atomic<std::size_t> tail{0};
+        alignas(64) std::atomic<std::size_t> head{0};
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef CONSOLEINPUT_HPP
+#define CONSOLEINPUT_HPP
+
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+/******************************************************************
+ * Class: ConsoleInput
+ * ---------------------------------------------------------------
+ * Buffered reader behind every console prompt. Input is read from
+ * a file descriptor in large blocks and handed out as string_views
+ * into the buffer, with the same token rules as cin >>: words are
+ * whitespace separated, letter() takes a single character, and
+ * skipLine() drops the rest of the line. Numbers are parsed with
+ * std::from_chars and must fill the whole word.
+ *
+ * Pending console output is flushed before every blocking read,
+ * so prompts still appear with iostream sync turned off. At end
+ * of input word() is empty and letter() is '\0'; the prompts treat
+ * that as "stop".
+ ******************************************************************/
+class ConsoleInput {
+
+    public:
+
+        explicit ConsoleInput(int fd = 0, std::size_t capacity = 1 << 16);
+
+        // next word; empty at end of input. Valid until the next read.
+        std::string_view word();
+
+        // next non-blank character, lowercased (like cin >> char)
+        char letter();
+
+        // one word as a number; on failure the rest of the line is dropped
+        bool number(int& out);
+        bool number(double& out);
+
+        void skipLine();
+
+        bool atEnd();
+
+    private:
+
+        bool skipBlanks();
+        bool fill();
+
+        int fd;
+        std::vector<char> buf;
+        std::size_t pos = 0;
+        std::size_t len = 0;
+        bool ended = false;
+};
+
+// the whole word as a number (std::from_chars, optional leading '+')
+bool parseNumber(std::string_view word, int& out);
+bool parseNumber(std::string_view word, double& out);
+
+// reader on standard input, shared by the console prompts
+ConsoleInput& consoleIn();
+
+/******************************************************************
+ * Function: promptUntil
+ * ---------------------------------------------------------------
+ * Prints prompt and reads words until accept(word) is true,
+ * printing error after each rejected word.
+ *
+ * Returns:
+ *   false if input ended first.
+ ******************************************************************/
+template <typename Accept>
+bool promptUntil(ConsoleInput& in, const char* prompt, const char* error, Accept accept) {
+    for (;;) {
+        std::cout << prompt;
+        std::string_view w = in.word();
+        if (w.empty()) return false;
+        if (accept(w)) return true;
+        std::cout << error;
+    }
+}
+
+// y/n question, re-asked until answered; 'n' at end of input
+char promptYesNo(ConsoleInput& in, const char* prompt, const char* error);
+
+#endif
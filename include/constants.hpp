@@ -1,11 +1,39 @@
 #ifndef CONSTANTS_HPP
 #define CONSTANTS_HPP
 #include <iostream>
+#include "drinkTypes.hpp"
 
 constexpr double ML_PER_CUP     = 240.0;
 constexpr double GRAMS_PER_TBSP = 16.0;   // 1 tbsp = 16 g
 constexpr double CAFFEINE_PER_CUP_COFFEE = 95.0; // mg
 constexpr double CAFFEINE_PER_SINGLE_SHOT = 63.0; // mg
 
+// iced drinks: less water for coffee, a shorter pull for espresso
+constexpr double ICED_WATER_FACTOR = 0.85;
+constexpr double ICED_BREW_FACTOR  = 0.8;
+constexpr double DECAF_CAFFEINE_FACTOR = 0.03;
 
-#endif
\ No newline at end of file
+/******************************************************************
+ * Recipe tables
+ * ---------------------------------------------------------------
+ * Indexed by enum value (see drinkTypes.hpp). A 0 entry marks a
+ * parameter the drink does not accept.
+ ******************************************************************/
+
+// coffee water:grounds ratio per strength (bolder, medium, weaker, stronger)
+constexpr double COFFEE_BASE_RATIO[STRENGTH_COUNT] = {14.0, 16.0, 18.0, 0.0};
+
+// roast tweak added to the coffee ratio (light, medium, dark)
+constexpr double ROAST_RATIO_ADJUST[ROAST_COUNT] = {1.0, 0.0, -1.0};
+
+// espresso grams per shot (single, double)
+constexpr double GRAMS_PER_SHOT[SHOT_SIZE_COUNT] = {8.0, 16.0};
+
+// espresso output:grounds ratio per strength (bolder, medium, weaker, stronger)
+constexpr double ESPRESSO_RATIO[STRENGTH_COUNT] = {0.0, 0.0, 2.5, 2.0};
+
+// milk:espresso ratio per style (none, cortado, flatwhite, latte, custom)
+constexpr double MILK_RATIO[MILK_STYLE_COUNT] = {0.0, 1.0, 2.0, 3.0, -1.0};
+
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef DRINKCOMPOSITION_HPP
+#define DRINKCOMPOSITION_HPP
+
+#include "addonRegistry.hpp"
+#include "drinkTypes.hpp"
+#include "functions.hpp"
+
+// after add-ons; a latte with more shots than this cannot be made
+constexpr int MAX_TOTAL_SHOTS = 100000;
+
+// nearest whole shot, halves away from zero; false if shots is not
+// finite or rounds past MAX_TOTAL_SHOTS either way
+bool wholeShots(double shots, int& out);
+
+/******************************************************************
+ * Class: DrinkComposition
+ * ---------------------------------------------------------------
+ * A drink described as stages: the base recipe, add-ons from an
+ * AddOnRegistry and, for lattes, a milk target. Each add-on is
+ * folded into one fused coefficient vector as it is added;
+ * evaluate() derives every volume once, in a single pass at the
+ * end, so any number of add-ons costs the same as one. Set the
+ * base first: add-ons not offered for the drink are ignored.
+ ******************************************************************/
+class DrinkComposition {
+
+    public:
+
+        DrinkComposition() = default;
+
+        // base recipe (replaces any earlier base)
+        void setCoffee(Strength strength, Roast roast, double cups);
+        void setLatte(Strength strength, ShotSize shotSize, int shots);
+
+        // add-ons; extra shots only apply to lattes
+        void addAddOn(AddOnId id, const AddOnRegistry& registry = defaultAddOns()) {
+            if (registry.appliesTo(id, base.drink)) addons.then(registry.spec(id).effect);
+        }
+        void addExtraShots(int count);
+
+        // a whole add-on list, folded in registers and applied once
+        void addAddOns(const AddOnId* ids, std::size_t count,
+                       const AddOnRegistry& registry = defaultAddOns()) {
+            addons.then(registry.compile(ids, count, base.drink));
+        }
+
+        // an effect already folded by compile() (e.g. a cached one)
+        void addEffect(const AddOnEffect& effect) { addons.then(effect); }
+
+        // latte milk target; MilkStyle::None clears it
+        void setMilkTarget(MilkStyle style, double ratio);
+
+        DrinkType drinkType() const { return base.drink; }
+        const AddOnEffect& effect() const { return addons; }
+
+        // false if the base recipe cannot be made (bad strength, no cups/shots)
+        bool valid() const;
+
+        // false if the composition is invalid or the other drink type
+        bool evaluate(CoffeeResult& out) const;
+        bool evaluate(LatteResult& out) const;
+
+        // caffeine of the drink as composed, in mg
+        double caffeineMg() const;
+
+    private:
+
+        struct Base {
+            DrinkType drink = DrinkType::Coffee;
+            Strength  strength = Strength::Medium;
+            Roast     roast = Roast::Medium;
+            double    cups = 0.0;
+            ShotSize  shotSize = ShotSize::Single;
+            int       shots = 0;
+        };
+
+        struct Milk {
+            MilkStyle style = MilkStyle::None;
+            double    ratio = 0.0;
+        };
+
+        // base shots after the shot add-ons; false if out of range
+        bool totalShots(int& out) const;
+
+        Base        base;
+        AddOnEffect addons;
+        Milk        milk;
+};
+
+#endif
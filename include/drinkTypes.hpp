@@ -0,0 +1,52 @@
+#ifndef DRINKTYPES_HPP
+#define DRINKTYPES_HPP
+
+#include <cstddef>
+#include <string_view>
+
+/******************************************************************
+ * Enums: DrinkType / Roast / Strength / ShotSize / MilkStyle
+ * ---------------------------------------------------------------
+ * Drink parameters, parsed once at the input boundary and passed
+ * by value everywhere else. Strength covers both drinks: coffee
+ * uses bolder/medium/weaker, latte uses stronger/weaker.
+ ******************************************************************/
+enum class DrinkType : unsigned char { Coffee, Latte };
+enum class Roast : unsigned char { Light, Medium, Dark };
+enum class Strength : unsigned char { Bolder, Medium, Weaker, Stronger };
+enum class ShotSize : unsigned char { Single, Double };
+enum class MilkStyle : unsigned char { None, Cortado, FlatWhite, Latte, Custom };
+
+constexpr std::size_t ROAST_COUNT      = 3;
+constexpr std::size_t STRENGTH_COUNT   = 4;
+constexpr std::size_t SHOT_SIZE_COUNT  = 2;
+constexpr std::size_t MILK_STYLE_COUNT = 5;
+
+// enum -> table index
+template <typename E>
+constexpr std::size_t indexOf(E e) { return static_cast<std::size_t>(e); }
+
+// ASCII case-insensitive comparison, used for every keyword and add-on name
+bool equalsIgnoreCase(std::string_view a, std::string_view b);
+
+// keyword -> enum (case-insensitive, no allocation); false if unrecognized
+bool parseDrinkType(std::string_view in, DrinkType& out);
+bool parseRoast(std::string_view in, Roast& out);
+bool parseStrength(std::string_view in, Strength& out);
+bool parseShotSize(std::string_view in, ShotSize& out);
+bool parseMilkStyle(std::string_view in, MilkStyle& out);
+
+// which strengths each drink accepts
+constexpr bool isCoffeeStrength(Strength s) { return s != Strength::Stronger; }
+constexpr bool isLatteStrength(Strength s) {
+    return s == Strength::Stronger || s == Strength::Weaker;
+}
+
+// enum -> canonical lowercase keyword
+const char* toString(DrinkType d);
+const char* toString(Roast r);
+const char* toString(Strength s);
+const char* toString(ShotSize s);
+const char* toString(MilkStyle m);
+
+#endif
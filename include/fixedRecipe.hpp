@@ -0,0 +1,191 @@
+#ifndef FIXEDRECIPE_HPP
+#define FIXEDRECIPE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "addonRegistry.hpp"
+#include "orderRecord.hpp"
+
+/******************************************************************
+ * Fixed-point recipe math
+ * ---------------------------------------------------------------
+ * An integer version of the calc + add-on path (computeOrder).
+ * Every quantity is an unsigned Q32.32 value: mL, g, mg, shots
+ * and ratios times 2^32. Products are rounded half up from a
+ * 128-bit intermediate; divisions by the small integer constants
+ * (240 mL per cup, 16 g per tbsp, the 13..19 coffee ratios) are a
+ * multiply by a precomputed reciprocal, exact to the rounding.
+ * No floating-point operation touches a value between the input
+ * and the result, so the results are the same bits on every
+ * platform and compiler (no FMA contraction, no x87 excess
+ * precision), and they are converted to double exactly.
+ *
+ * The engine covers values below FIXED_MAX_VALUE with non-negative
+ * add-on coefficients. An order that leaves that range (or uses
+ * an add-on with a negative coefficient) is computed by the double
+ * path instead. Within it, results agree with computeOrder to the
+ * 2 decimals the summaries print, except where the exact value
+ * lies on a rounding midpoint (see bench/fixed_bench.cpp).
+ ******************************************************************/
+
+using Fixed = std::uint64_t;
+
+constexpr unsigned FIXED_FRACTION_BITS = 32;
+constexpr Fixed    FIXED_ONE   = Fixed(1) << FIXED_FRACTION_BITS;
+constexpr double   FIXED_SCALE = 4294967296.0;              // 2^32
+constexpr Fixed    FIXED_LIMIT = Fixed(1) << 53;            // exclusive; doubles hold it exactly
+constexpr double   FIXED_MAX_VALUE = 2097152.0;             // FIXED_LIMIT / 2^32
+
+static_assert(FIXED_SCALE == static_cast<double>(FIXED_ONE), "scale is 2^fraction bits");
+static_assert(FIXED_MAX_VALUE * FIXED_SCALE == static_cast<double>(FIXED_LIMIT), "limit");
+
+// 0 <= x < FIXED_MAX_VALUE; nearest, ties up. Conversions go
+// through int64 (one instruction; uint64 is a sequence on x86-64).
+constexpr Fixed toFixed(double x) {
+    double scaled = x * FIXED_SCALE;   // exact: a power of two
+    std::int64_t whole = static_cast<std::int64_t>(scaled);
+    return static_cast<Fixed>(whole) + (scaled - static_cast<double>(whole) >= 0.5 ? 1 : 0);
+}
+
+// exact for every value below FIXED_LIMIT
+constexpr double toDouble(Fixed q) {
+    return static_cast<double>(static_cast<std::int64_t>(q)) * (1.0 / FIXED_SCALE);
+}
+
+namespace fixed_detail {
+
+// a * b as a 128-bit (hi, lo) pair from 32-bit halves; any platform
+inline void mulWidePortable(std::uint64_t a, std::uint64_t b,
+                            std::uint64_t& hi, std::uint64_t& lo) {
+    const std::uint64_t MASK = 0xFFFFFFFFu;
+    std::uint64_t a0 = a & MASK, a1 = a >> 32;
+    std::uint64_t b0 = b & MASK, b1 = b >> 32;
+    std::uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    std::uint64_t mid = (p00 >> 32) + (p01 & MASK) + (p10 & MASK);
+    lo = (mid << 32) | (p00 & MASK);
+    hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+}
+
+// same result; one instruction where the compiler has 128-bit integers
+inline void mulWide(std::uint64_t a, std::uint64_t b, std::uint64_t& hi, std::uint64_t& lo) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+    hi = static_cast<std::uint64_t>(p >> 64);
+    lo = static_cast<std::uint64_t>(p);
+#else
+    mulWidePortable(a, b, hi, lo);
+#endif
+}
+
+} // namespace fixed_detail
+
+/******************************************************************
+ * Struct: FixedDivisor
+ * ---------------------------------------------------------------
+ * Division by a constant integer d (1..256) as one multiply:
+ * round(q / d) = floor((2q + d) / 2d), and for n < 2^64 / 2d,
+ * floor(n / 2d) is the high word of n * (floor(2^64 / 2d) + 1).
+ * Every q below FIXED_LIMIT keeps n in that range.
+ ******************************************************************/
+struct FixedDivisor {
+    std::uint64_t d = 1;
+    std::uint64_t reciprocal = 0;
+
+    constexpr FixedDivisor() = default;
+    constexpr explicit FixedDivisor(std::uint64_t divisor)
+        : d(divisor), reciprocal(~std::uint64_t(0) / (2 * divisor) + 1) {}
+
+    // q / d, nearest (ties up)
+    Fixed divide(Fixed q) const {
+        std::uint64_t hi, lo;
+        fixed_detail::mulWide(2 * q + d, reciprocal, hi, lo);
+        return hi;
+    }
+};
+
+/******************************************************************
+ * Struct: FixedEffect
+ * ---------------------------------------------------------------
+ * AddOnEffect in Q32.32: each quantity x becomes
+ * x * scale + offset. The default is the identity.
+ ******************************************************************/
+struct FixedEffect {
+    Fixed scale[QUANTITY_COUNT]  = {FIXED_ONE, FIXED_ONE, FIXED_ONE,
+                                    FIXED_ONE, FIXED_ONE, FIXED_ONE};
+    Fixed offset[QUANTITY_COUNT] = {0, 0, 0, 0, 0, 0};
+
+    bool isIdentity(Quantity q) const {
+        return scale[indexOf(q)] == FIXED_ONE && offset[indexOf(q)] == 0;
+    }
+};
+
+// false (out unchanged) if a coefficient is negative or past FIXED_MAX_VALUE
+bool toFixedEffect(const AddOnEffect& effect, FixedEffect& out);
+
+/******************************************************************
+ * Class: FixedMath
+ * ---------------------------------------------------------------
+ * The arithmetic of one evaluation. Every result stays below
+ * FIXED_LIMIT; an operation that would not sets a sticky flag
+ * (and its result is meaningless), so a whole calculation checks
+ * once at the end.
+ ******************************************************************/
+class FixedMath {
+
+    public:
+
+        Fixed in(double x) {
+            if (x >= 0.0 && x < FIXED_MAX_VALUE) return toFixed(x);
+            overflow = true;
+            return 0;
+        }
+
+        Fixed add(Fixed a, Fixed b) {
+            Fixed sum = a + b;
+            overflow |= sum >= FIXED_LIMIT;
+            return sum;
+        }
+
+        // a * b, nearest (ties up)
+        Fixed mul(Fixed a, Fixed b) {
+            std::uint64_t hi, lo;
+            fixed_detail::mulWide(a, b, hi, lo);
+            std::uint64_t rounded = lo + (FIXED_ONE >> 1);
+            hi += rounded < lo;
+            overflow |= hi >= (FIXED_LIMIT >> FIXED_FRACTION_BITS);
+            return (hi << (64 - FIXED_FRACTION_BITS)) | (rounded >> FIXED_FRACTION_BITS);
+        }
+
+        Fixed div(Fixed a, const FixedDivisor& divisor) const { return divisor.divide(a); }
+
+        // a scale of exactly 1 skips the multiply (most add-ons touch one or two quantities)
+        Fixed apply(const FixedEffect& effect, Quantity q, Fixed x) {
+            Fixed scale = effect.scale[indexOf(q)];
+            return add(scale == FIXED_ONE ? x : mul(x, scale), effect.offset[indexOf(q)]);
+        }
+
+        // effect followed by next, into effect
+        void then(FixedEffect& effect, const FixedEffect& next) {
+            for (std::size_t i = 0; i < QUANTITY_COUNT; ++i) {
+                if (next.scale[i] != FIXED_ONE) {
+                    effect.offset[i] = mul(effect.offset[i], next.scale[i]);
+                    effect.scale[i] = mul(effect.scale[i], next.scale[i]);
+                }
+                effect.offset[i] = add(effect.offset[i], next.offset[i]);
+            }
+        }
+
+        bool overflowed() const { return overflow; }
+
+    private:
+
+        bool overflow = false;
+};
+
+// computeOrder in fixed point; false (out unspecified) if the order leaves the fixed range
+bool evaluateOrderFixed(const Order& order, OrderResult& out);
+
+// evaluateOrderFixed, else computeOrder; returns out.ok
+bool computeOrderFixed(const Order& order, OrderResult& out);
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef FRAMEPROFILER_HPP
+#define FRAMEPROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+constexpr std::size_t FRAME_HISTORY     = 240;   // rolling window, 4 s at 60 fps
+constexpr std::size_t FRAME_HUD_REFRESH = 15;    // frames between HUD text updates
+constexpr std::size_t WAKEUP_WINDOW     = 60;    // seconds in the wakeups/min window
+
+/******************************************************************
+ * Struct: FrameSample
+ * ---------------------------------------------------------------
+ * One drawn GUI frame. frameMs is start to start of drawn frames,
+ * so it includes the framerate limiter's sleep in display() and,
+ * in the event-driven loop, the idle time between redraws; workMs
+ * is only the frame's own work (events + build + draw).
+ ******************************************************************/
+struct FrameSample {
+    std::uint64_t frame = 0;
+    double        frameMs = 0.0;
+    double        workMs = 0.0;
+    double        eventsMs = 0.0;
+    double        buildMs = 0.0;
+    double        drawMs = 0.0;
+    std::uint32_t drawCalls = 0;
+    std::uint32_t textsCreated = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t allocatedBytes = 0;
+};
+
+/******************************************************************
+ * Struct: FramePercentiles
+ * ---------------------------------------------------------------
+ * Rolling statistics over the last FRAME_HISTORY frames.
+ ******************************************************************/
+struct FramePercentiles {
+    std::size_t frames = 0;
+    double frameP50 = 0.0, frameP95 = 0.0, frameP99 = 0.0, frameMax = 0.0;
+    double workP50 = 0.0, workP99 = 0.0;
+    double drawCalls = 0.0;        // means per frame
+    double textsCreated = 0.0;
+    double allocations = 0.0;
+};
+
+/******************************************************************
+ * Allocation counter
+ * ---------------------------------------------------------------
+ * The GUI binary replaces the global operator new and reports
+ * every allocation here (relaxed atomic adds); the profiler takes
+ * the difference across a frame. In a binary without the
+ * replacement both stay 0.
+ ******************************************************************/
+namespace frame_detail {
+extern std::atomic<std::uint64_t> allocations;
+extern std::atomic<std::uint64_t> allocatedBytes;
+}
+
+inline void noteAllocation(std::size_t bytes) {
+    frame_detail::allocations.fetch_add(1, std::memory_order_relaxed);
+    frame_detail::allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/******************************************************************
+ * Class: WakeupMeter
+ * ---------------------------------------------------------------
+ * Counts how often the GUI thread wakes up: per second over the
+ * last WAKEUP_WINDOW seconds (a ring of one-second buckets) and in
+ * total since the first wakeup. This is what separates a loop that
+ * polls at 60 Hz from one that sleeps until an event arrives.
+ ******************************************************************/
+class WakeupMeter {
+
+    public:
+
+        using TimePoint = std::chrono::steady_clock::time_point;
+
+        void wake(TimePoint now);
+
+        // wakeups in the last WAKEUP_WINDOW seconds (fewer if the run is younger)
+        std::uint64_t lastMinute(TimePoint now);
+
+        // total per minute of wall time since the first wakeup
+        double perMinute(TimePoint now) const;
+
+        std::uint64_t total() const { return count; }
+
+    private:
+
+        void advance(TimePoint now);
+
+        std::array<std::uint32_t, WAKEUP_WINDOW> perSecond{};
+        std::int64_t second = 0;    // bucket the ring is at, seconds since start
+        TimePoint start;
+        std::uint64_t count = 0;
+};
+
+/******************************************************************
+ * Class: FrameProfiler
+ * ---------------------------------------------------------------
+ * Collects per-frame timings and counts for the GUI: a ring of the
+ * last FRAME_HISTORY samples for the HUD, and optionally every
+ * frame as a CSV row so rendering changes can be compared run
+ * against run.
+ *
+ * The loop calls beginFrame(), bumps the draw/text counters while
+ * it works, and hands its phase times to endFrame(). Nothing here
+ * allocates once the CSV file is open.
+ ******************************************************************/
+class FrameProfiler {
+
+    public:
+
+        // starts writing one CSV row per frame; false if the file cannot be created
+        bool openCsv(const std::string& path);
+        bool csvOpen() const { return csv.is_open(); }
+
+        void beginFrame();
+        void countDraw(std::uint32_t n = 1) { current.drawCalls += n; }
+        void countText(std::uint32_t n = 1) { current.textsCreated += n; }
+
+        // phase times in ms; frameMs is the time since the previous beginFrame()
+        void endFrame(double frameMs, double eventsMs, double buildMs, double drawMs);
+
+        std::uint64_t frames() const { return frameCount; }
+        const FrameSample& last() const { return history[(next + FRAME_HISTORY - 1) % FRAME_HISTORY]; }
+
+        // over the ring (sorts a copy, so call it per HUD refresh, not per frame)
+        FramePercentiles percentiles() const;
+
+        // one wakeup of the GUI thread (a loop pass, whether or not it redraws)
+        void countWakeup(std::chrono::steady_clock::time_point now) { wakeups.wake(now); }
+        WakeupMeter& wakeupMeter() { return wakeups; }
+
+    private:
+
+        std::array<FrameSample, FRAME_HISTORY> history{};
+        std::size_t next = 0;
+        std::size_t filled = 0;
+        std::uint64_t frameCount = 0;
+
+        FrameSample current;
+        WakeupMeter wakeups;
+        std::uint64_t allocStart = 0;
+        std::uint64_t bytesStart = 0;
+        std::ofstream csv;
+};
+
+// one HUD block (several lines) for the stats, into a fixed buffer
+void formatFrameHud(char* buffer, std::size_t capacity, const FramePercentiles& stats,
+                    const FrameSample& last, std::uint64_t wakeupsLastMinute, bool recording);
+
+#endif
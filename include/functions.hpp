@@ -6,6 +6,8 @@
 #include <algorithm>
 #include <cctype>    // for std::tolower
 #include <limits>    // for std::numeric_limits
+#include <type_traits>
+#include "drinkTypes.hpp"
 using namespace std;
             
             
@@ -29,17 +31,17 @@ struct CoffeeResult {
  * brew ratio, espresso volume, and optional milk volumes.
  ******************************************************************/
 struct LatteResult {
-    int    shots;
-    string shotSize;
+    int      shots;
+    ShotSize shotSize;
     double coffeeGrams;
     double brewRatio;
     double espressoML;
     double espressoCups;
     double tablespoons;
 
-    bool   hasMilkTarget = false;
-    string milkStyle;
-    double milkToEspRatio = 0.0;
+    bool      hasMilkTarget = false;
+    MilkStyle milkStyle = MilkStyle::None;
+    double    milkToEspRatio = 0.0;
     double milkML = 0.0;
     double milkCups = 0.0;
     double finalML = 0.0;
@@ -47,31 +49,31 @@ struct LatteResult {
     
     // latte constructor
     LatteResult();
-    LatteResult(int s, const std::string& size, double grams,
+    LatteResult(int s, ShotSize size, double grams,
             double ratio, double espML, double espCups, double tbsp);
 
 };
 
+// results are plain values: no heap allocation on the calc path
+static_assert(std::is_trivially_copyable<CoffeeResult>::value, "CoffeeResult must stay POD");
+static_assert(std::is_trivially_copyable<LatteResult>::value, "LatteResult must stay POD");
+
 
 
 string toLowerCopy(string s);
 
 double gramsToTablespoons(double grams);
 
-double milkStyleToRatio(const string& styleIn);
+double milkStyleToRatio(MilkStyle style);
 
-bool calcCoffee(const string& strengthIn, const string& roastIn,
+bool calcCoffee(Strength strength, Roast roast,
                 double cups, CoffeeResult& out);
                 
-bool calcLatteFromShots(const string& strengthIn, const string& shotSizeIn,
+bool calcLatteFromShots(Strength strength, ShotSize shotSize,
                         int shotCount, LatteResult& out);
                         
-void printCoffeeSummary(const CoffeeResult& r,
-                        const string& roastType,
-                        const string& strength);
+void printCoffeeSummary(const CoffeeResult& r, Roast roast, Strength strength);
 
-void printLatteSummary(const LatteResult& r,
-                       const string& strength,
-                       const string& shotSize);
+void printLatteSummary(const LatteResult& r, Strength strength);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 0 compiles every PROBE_* site out (make INSTRUMENT=0)
+#ifndef COFFEE_INSTRUMENT
+#define COFFEE_INSTRUMENT 1
+#endif
+
+constexpr std::size_t PROBE_MAX            = 64;        // distinct probe names
+constexpr std::size_t PROBE_BUCKETS        = 164;       // 4 per power of two, up to 2^41 ticks
+constexpr std::size_t PROBE_TRACE_CAPACITY = 1 << 16;   // trace events kept per thread
+constexpr std::uint8_t PROBE_SAMPLE_EVERY  = 16;        // a scoped probe times 1 call in this many
+
+using ProbeId = std::uint16_t;
+
+/******************************************************************
+ * Probes
+ * ---------------------------------------------------------------
+ * Named timers and counters for the hot paths (calc, add-ons,
+ * presets, batch/server requests, the GUI frame). Sites use the
+ * macros below, so INSTRUMENT=0 removes them completely.
+ *
+ * Compiled in, a probe costs one relaxed load while probes are
+ * off. Turned on (--profile), a scoped timer times 1 call in
+ * PROBE_SAMPLE_EVERY per thread and only counts the others: a
+ * timed call reads the cycle counter on entry and exit (no fence)
+ * and adds its ticks, max and a log-scale histogram bucket into
+ * the calling thread's own block. The first call of each probe on
+ * a thread is always timed. Reports give the exact call count and
+ * the mean, percentiles and max of the timed ones, with the total
+ * scaled up from them. Two counter reads cost about 36 ns where
+ * rdtsc is trapped (some VMs), so timing every call would miss the
+ * 20 ns budget there; sampled it stays under (bench/probe_bench.cpp).
+ * Only that thread writes its block (relaxed load + store, no
+ * read-modify-write), and readers merge all blocks, so nothing
+ * locks or shares a cache line on the hot path. With tracing on
+ * (--trace) every call is timed and also appended to a per-thread event buffer
+ * (the first PROBE_TRACE_CAPACITY per thread are kept) for
+ * Chrome's trace viewer.
+ *
+ * Blocks outlive their threads and are reused by later ones, so
+ * totals cover the whole run.
+ ******************************************************************/
+
+// same name -> same id; names must be string literals (kept by pointer)
+ProbeId registerProbe(const char* name);
+
+namespace probe_detail {
+extern std::atomic<bool> enabled;
+extern std::atomic<bool> tracing;
+void record(ProbeId id, std::uint64_t start, std::uint64_t end);
+void tally(ProbeId id);
+void count(ProbeId id, std::uint64_t n);
+
+// calls each probe lets pass untimed before timing the next one, per thread
+inline thread_local std::uint8_t untimedLeft[PROBE_MAX] = {};
+}
+
+inline bool probesEnabled() { return probe_detail::enabled.load(std::memory_order_relaxed); }
+
+// cycle counter where there is one (scaled to ns when reported), else steady_clock ns
+inline std::uint64_t probeTicks() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return __builtin_ia32_rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+// starts timing (and with trace also recording events) from now
+void enableProbes(bool trace = false);
+void disableProbes();
+
+namespace probe_detail {
+// start ticks for a call to time, else 0 after counting it untimed
+inline std::uint64_t begin(ProbeId id) {
+    std::uint8_t& left = untimedLeft[id];
+    if (left == 0 || tracing.load(std::memory_order_relaxed)) {
+        left = PROBE_SAMPLE_EVERY - 1;
+        return probeTicks();
+    }
+    --left;
+    tally(id);
+    return 0;
+}
+}
+
+/******************************************************************
+ * Class: ScopedProbe
+ * ---------------------------------------------------------------
+ * Times its own lifetime under one probe id, or when sampling
+ * skips it only counts the call (nothing if probes were off when
+ * it started).
+ ******************************************************************/
+class ScopedProbe {
+
+    public:
+
+        explicit ScopedProbe(ProbeId probe)
+            : id(probe), start(probesEnabled() ? probe_detail::begin(probe) : 0) {}
+
+        ~ScopedProbe() {
+            if (start) probe_detail::record(id, start, probeTicks());
+        }
+
+        ScopedProbe(const ScopedProbe&) = delete;
+        ScopedProbe& operator=(const ScopedProbe&) = delete;
+
+    private:
+
+        ProbeId id;
+        std::uint64_t start;
+};
+
+// adds n to a counter probe (no timing)
+inline void countProbe(ProbeId id, std::uint64_t n = 1) {
+    if (probesEnabled()) probe_detail::count(id, n);
+}
+
+#define PROBE_JOIN2(a, b) a##b
+#define PROBE_JOIN(a, b) PROBE_JOIN2(a, b)
+
+#if COFFEE_INSTRUMENT
+#define PROBE_SCOPE(name)                                                          \
+    static const ProbeId PROBE_JOIN(probeId_, __LINE__) = registerProbe(name);     \
+    ScopedProbe PROBE_JOIN(probeScope_, __LINE__)(PROBE_JOIN(probeId_, __LINE__))
+#define PROBE_COUNT(name, n)                                                       \
+    do {                                                                           \
+        static const ProbeId probeId_ = registerProbe(name);                       \
+        countProbe(probeId_, (n));                                                 \
+    } while (0)
+#else
+#define PROBE_SCOPE(name) ((void)0)
+#define PROBE_COUNT(name, n) ((void)0)
+#endif
+
+/******************************************************************
+ * Struct: ProbeSummary
+ * ---------------------------------------------------------------
+ * One probe merged over every thread. Timers fill the ns fields
+ * from their timed calls (percentiles are histogram bucket upper
+ * bounds, within 19%; totalNs is scaled up to every call);
+ * counters only have count.
+ ******************************************************************/
+struct ProbeSummary {
+    const char*   name = "";
+    std::uint64_t calls = 0;     // scoped calls, timed or not
+    std::uint64_t timed = 0;     // of those, the ones timed
+    std::uint64_t count = 0;     // counter total
+    double        totalNs = 0.0;
+    double        meanNs = 0.0;
+    double        p50Ns = 0.0;
+    double        p99Ns = 0.0;
+    double        maxNs = 0.0;
+};
+
+// every probe with any activity, in registration order
+void probeSnapshot(std::vector<ProbeSummary>& out);
+
+// text table of probeSnapshot()
+void printProbeSnapshot(std::ostream& out);
+
+// trace events so far as Chrome trace-event JSON (chrome://tracing, Perfetto)
+void writeChromeTrace(std::ostream& out);
+
+// events not kept because a thread's buffer was full
+std::uint64_t droppedTraceEvents();
+
+/******************************************************************
+ * Class: ProbeReporter
+ * ---------------------------------------------------------------
+ * Prints printProbeSnapshot() to out every interval on its own
+ * thread until destroyed.
+ ******************************************************************/
+class ProbeReporter {
+
+    public:
+
+        ProbeReporter(std::ostream& out, std::chrono::milliseconds interval);
+        ~ProbeReporter();
+
+        ProbeReporter(const ProbeReporter&) = delete;
+        ProbeReporter& operator=(const ProbeReporter&) = delete;
+
+    private:
+
+        std::mutex lock;
+        std::condition_variable wake;
+        bool done = false;
+        std::thread worker;
+};
+
+/******************************************************************
+ * Class: ProbeSession
+ * ---------------------------------------------------------------
+ * What --profile / --trace ask for, for the lifetime of a run:
+ * probes on, an optional periodic snapshot, and at the end the
+ * final snapshot on stderr and/or the Chrome trace file.
+ ******************************************************************/
+class ProbeSession {
+
+    public:
+
+        // everySeconds 0 = no periodic snapshot; empty tracePath = no trace
+        ProbeSession(bool report, unsigned everySeconds, const std::string& tracePath);
+        ~ProbeSession();
+
+        ProbeSession(const ProbeSession&) = delete;
+        ProbeSession& operator=(const ProbeSession&) = delete;
+
+    private:
+
+        bool report;
+        std::string tracePath;
+        std::unique_ptr<ProbeReporter> reporter;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef INVENTORYFORECAST_HPP
+#define INVENTORYFORECAST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include "orderRecord.hpp"
+
+enum class Ingredient : unsigned char { Beans, Milk };   // g, mL
+constexpr std::size_t INGREDIENT_COUNT = 2;
+
+constexpr std::int64_t INVENTORY_BUCKET_SECONDS = 60;   // rate resolution
+constexpr std::size_t  INVENTORY_WINDOW_BUCKETS = 60;   // rate window: last hour
+
+/******************************************************************
+ * Class: InventoryForecast
+ * ---------------------------------------------------------------
+ * Running bean and milk depletion over a stream of computed
+ * orders, with a time-to-empty projection.
+ *
+ * Every order is O(1): its grams and mL are added to the consumed
+ * totals and to a ring of per-minute buckets. A running sum over
+ * the ring gives the consumption rate of the last hour (or of the
+ * stream so far, if shorter); buckets are evicted as the clock
+ * moves past them. Amounts are kept as integers (mg, µL), so
+ * forecasts built over parts of a stream merge() into exactly
+ * what one forecast over the whole stream would hold, in any
+ * order.
+ *
+ * The clock is the newest order time seen. Orders older than the
+ * window ending there count as consumed but not toward the rate
+ * (see late()). Amounts are taken as at most 1e9 g or mL each.
+ ******************************************************************/
+class InventoryForecast {
+
+    public:
+
+        InventoryForecast();
+
+        void restock(Ingredient ingredient, double amount);
+
+        void consume(std::int64_t unixTime, double beansG, double milkML);
+
+        // ok results only
+        void consume(std::int64_t unixTime, const OrderResult& result);
+
+        // adds another forecast's stock, consumption and window
+        void merge(const InventoryForecast& other);
+
+        double stock(Ingredient ingredient) const;
+        double consumed(Ingredient ingredient) const;
+        double remaining(Ingredient ingredient) const { return stock(ingredient) - consumed(ingredient); }
+
+        // per hour over the window ending at latestTime()
+        double ratePerHour(Ingredient ingredient) const;
+
+        // seconds the rate is taken over (the window, or less early on)
+        std::int64_t rateSpanSeconds() const;
+
+        // 0 if already out, infinity if nothing is being used
+        double hoursToEmpty(Ingredient ingredient) const;
+
+        std::int64_t latestTime() const { return head * INVENTORY_BUCKET_SECONDS; }
+        std::uint64_t orders() const { return orderCount; }
+
+        // orders outside the current window; the same however the stream was split
+        std::uint64_t late() const;
+
+    private:
+
+        void advanceTo(std::int64_t bucket);
+        void addToWindow(std::int64_t bucket, const std::uint64_t* amounts);
+
+        std::uint64_t stockUnits[INGREDIENT_COUNT] = {};
+        std::uint64_t usedUnits[INGREDIENT_COUNT] = {};
+
+        // ring of the newest INVENTORY_WINDOW_BUCKETS minutes
+        std::int64_t  slotBucket[INVENTORY_WINDOW_BUCKETS];
+        std::uint64_t slotUnits[INVENTORY_WINDOW_BUCKETS][INGREDIENT_COUNT] = {};
+        std::uint64_t slotOrders[INVENTORY_WINDOW_BUCKETS] = {};
+        std::uint64_t windowUnits[INGREDIENT_COUNT] = {};
+        std::uint64_t windowOrders = 0;
+
+        bool          started = false;
+        std::int64_t  head = 0;          // newest bucket
+        std::int64_t  firstBucket = 0;   // oldest bucket seen
+        std::uint64_t orderCount = 0;
+};
+
+// stock, use, rate and time to empty per ingredient
+void printForecast(const InventoryForecast& forecast, std::ostream& out);
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef INVERSESOLVER_HPP
+#define INVERSESOLVER_HPP
+
+#include <cstddef>
+#include "orderRecord.hpp"
+
+/******************************************************************
+ * Struct: SizingModel
+ * ---------------------------------------------------------------
+ * A drink's final volume (or bean use) as a straight line in its
+ * size: amount = perUnit * units + fixed, where units are cups for
+ * coffee and total shots for a latte. Holds for every recipe, milk
+ * style and add-on chain, because add-ons are affine per quantity
+ * (see AddOnEffect); a latte's total shots are
+ * round(base shots * shotScale + shotOffset).
+ ******************************************************************/
+struct SizingModel {
+    DrinkType drink = DrinkType::Coffee;
+    bool      ok = false;        // false if no size reaches any amount
+    double    perUnit = 0.0;
+    double    fixed = 0.0;
+    double    shotScale = 1.0;
+    double    shotOffset = 0.0;
+};
+
+/******************************************************************
+ * Struct: SizedDrink
+ * ---------------------------------------------------------------
+ * A solved size: cups (coffee) or base shots before add-ons
+ * (latte), and the amount that size actually gives.
+ ******************************************************************/
+struct SizedDrink {
+    bool   ok = false;
+    double cups = 0.0;
+    int    shots = 0;
+    double amount = 0.0;   // mL or g, as computeOrder would report it
+};
+
+// the line for order's recipe, add-ons and milk target (size fields ignored)
+SizingModel sizingModel(const Order& order, SizeBy by);
+
+// closed-form inverse; coffee cups are exact, latte shots follow rounding
+SizedDrink solveSize(const SizingModel& model, double amount, ShotRounding rounding);
+
+// sets order.cups / order.shots from order.sizeBy and sizeAmount
+bool sizeOrder(Order& order);
+
+/******************************************************************
+ * Function: solveMenu
+ * ---------------------------------------------------------------
+ * Solves every drink x amount cell of a menu board at once:
+ * out[d * amountCount + a] sizes drinks[d] for amounts[a]. Each
+ * drink's line is built once and reused for the whole row.
+ *
+ * Returns:
+ *   number of cells that could be solved.
+ ******************************************************************/
+std::size_t solveMenu(const Order* drinks, std::size_t drinkCount,
+                      const double* amounts, std::size_t amountCount,
+                      SizeBy by, ShotRounding rounding, SizedDrink* out);
+
+#endif
@@ -4,6 +4,8 @@
 #include "functions.hpp"
 #include "constants.hpp"
 #include "presetManager.hpp"
+#include "presetStore.hpp"
+#include "consoleInput.hpp"
 
 class MachineDisplay {
     
@@ -15,10 +17,15 @@ class MachineDisplay {
         // for presets
         void createPreset();
         void loadPreset();
+        PresetStore presetStore;
         PresetManager presetManager;
+        ConsoleInput& in;
         
     public:
     
+        // prompts read from input (standard input by default)
+        explicit MachineDisplay(ConsoleInput& input = consoleIn());
+
         void run(char &again);
         char askRepeat(char &again);
     
@@ -0,0 +1,97 @@
+#ifndef MENUTABLE_HPP
+#define MENUTABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "orderRecord.hpp"
+
+// the standard menu: whole cups, total shots (base + extra) up to these
+constexpr std::size_t MENU_MAX_CUPS  = 16;
+constexpr std::size_t MENU_MAX_SHOTS = 16;
+
+constexpr std::size_t MENU_COFFEE_STRENGTHS = 3;   // bolder, medium, weaker
+constexpr std::size_t MENU_LATTE_STRENGTHS  = 2;   // stronger, weaker
+constexpr std::size_t MENU_MILK_STYLES      = 4;   // none .. latte (custom is computed)
+
+constexpr std::size_t MENU_COFFEE_ENTRIES =
+    MENU_COFFEE_STRENGTHS * ROAST_COUNT * 2 * MENU_MAX_CUPS;
+constexpr std::size_t MENU_LATTE_ENTRIES =
+    SHOT_SIZE_COUNT * MENU_LATTE_STRENGTHS * MENU_MILK_STYLES * 2 * MENU_MAX_SHOTS;
+constexpr std::size_t MENU_ENTRIES = MENU_COFFEE_ENTRIES + MENU_LATTE_ENTRIES;
+
+// default table file for --export-menu / --menu (relative to the working directory)
+constexpr const char* DEFAULT_MENU_TABLE = "menu.bin";
+
+/******************************************************************
+ * Struct: MenuEntry
+ * ---------------------------------------------------------------
+ * The numbers of one precomputed order, one cache line each.
+ * Everything else in the result (shots, shot size, milk style,
+ * cups columns of the milk target) follows from the index or is
+ * derived on unpack exactly as DrinkComposition derives it.
+ *
+ *   coffee: waterCups, waterML, coffeeGrams, ratio, tablespoons
+ *   latte:  coffeeGrams, brewRatio, espressoML, espressoCups,
+ *           tablespoons, milkML, finalML
+ *   both:   caffeineMg in the last slot
+ ******************************************************************/
+struct alignas(64) MenuEntry {
+    double value[8];
+};
+
+static_assert(sizeof(MenuEntry) == 64, "MenuEntry layout is part of the file format");
+
+/******************************************************************
+ * Class: MenuTable
+ * ---------------------------------------------------------------
+ * Every standard order precomputed through computeOrder:
+ *
+ *   coffee - strength x roast x iced x 1..MENU_MAX_CUPS whole cups
+ *   latte  - shot size x strength x milk style (not custom) x iced
+ *            x 1..MENU_MAX_SHOTS total shots
+ *
+ * lookup() answers such an order with one indexed load; anything
+ * else (fractional or larger sizes, custom milk ratios, named
+ * add-ons) returns false so the caller computes it. Results are
+ * bit for bit what computeOrder gives.
+ *
+ * The table can be saved to a binary file (64-byte header, then
+ * the entries) and loaded back; load() rejects files written for
+ * different recipes, add-on effects or table shape.
+ ******************************************************************/
+class MenuTable {
+
+    public:
+
+        // generates every entry (about a thousand computeOrder calls)
+        void build();
+
+        bool save(const std::string& path) const;
+
+        // false (and the table unchanged) if the file is missing,
+        // truncated or from other recipes
+        bool load(const std::string& path);
+
+        bool ready() const { return !entries.empty(); }
+
+        // false if the order is not on the standard menu
+        bool lookup(const Order& order, OrderResult& out) const;
+
+        // fingerprint of everything the entries depend on
+        static std::uint64_t recipeHash();
+
+    private:
+
+        std::vector<MenuEntry> entries;
+};
+
+// process-wide table, built on first use (load() into it to use a file)
+MenuTable& sharedMenuTable();
+
+// menu lookup, falling back to computeOrder; results are identical
+bool computeOrderFromMenu(const Order& order, OrderResult& out,
+                         const MenuTable& table = sharedMenuTable());
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef ORDERANALYTICS_HPP
+#define ORDERANALYTICS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+#include "drinkTypes.hpp"
+#include "orderRecord.hpp"
+
+constexpr std::size_t ANALYTICS_HOURS   = 24 * 7;   // rolling window, one bucket per hour
+constexpr std::size_t ANALYTICS_STORES  = 16;       // store ids 0..15
+constexpr std::size_t ANALYTICS_STRIPES = 16;       // writer stripes (threads map onto these)
+constexpr std::size_t DRINK_TYPE_COUNT  = 2;
+
+constexpr std::int64_t ANALYTICS_MAX_SKEW_SECONDS = 3600;   // order time= ahead of the clock
+
+constexpr unsigned ANY_STORE = ~0u;
+
+/******************************************************************
+ * Struct: ConsumptionTotals
+ * ---------------------------------------------------------------
+ * Merged aggregate for one query or hour.
+ ******************************************************************/
+struct ConsumptionTotals {
+    std::uint64_t orders = 0;
+    double caffeineMg = 0.0;
+    double beansG = 0.0;
+    double milkML = 0.0;
+};
+
+/******************************************************************
+ * Struct: AnalyticsFilter
+ * ---------------------------------------------------------------
+ * Hours are whole hours since the Unix epoch, [fromHour, toHour).
+ ******************************************************************/
+struct AnalyticsFilter {
+    std::int64_t fromHour = 0;
+    std::int64_t toHour = 0;
+    unsigned     store = ANY_STORE;
+    bool         anyDrink = true;
+    DrinkType    drink = DrinkType::Coffee;   // used when !anyDrink
+};
+
+/******************************************************************
+ * Class: OrderAnalytics
+ * ---------------------------------------------------------------
+ * Caffeine, bean and milk consumption per hour, store and drink
+ * type over a rolling ANALYTICS_HOURS window.
+ *
+ * Writers never lock: each thread is pinned to one of
+ * ANALYTICS_STRIPES stripes and adds into that stripe's columns
+ * (one array per metric, indexed hour slot x store x drink) with
+ * relaxed atomic adds. Amounts are kept as integers (µg, mg, µL)
+ * so concurrent adds are exact. Readers merge all stripes on
+ * query, so a dashboard never holds up order processing.
+ *
+ * An hour slot is reused when a newer hour reaches it; records
+ * older than the slot's current hour are counted in dropped(),
+ * as are orders recordOrder() finds outside the window.
+ * Amounts saturate at 1e9 (mg, g, mL) per record.
+ * A record that races an hour rollover may land in the new hour.
+ ******************************************************************/
+class OrderAnalytics {
+
+    public:
+
+        OrderAnalytics();
+        ~OrderAnalytics();
+
+        OrderAnalytics(const OrderAnalytics&) = delete;
+        OrderAnalytics& operator=(const OrderAnalytics&) = delete;
+
+        // stores beyond ANALYTICS_STORES are folded into the last one
+        void record(std::int64_t unixTime, unsigned store, DrinkType drink,
+                    double caffeineMg, double beansG, double milkML);
+
+        ConsumptionTotals total(const AnalyticsFilter& filter) const;
+
+        // one entry per hour of the filter's range (oldest first)
+        void hourly(const AnalyticsFilter& filter, std::vector<ConsumptionTotals>& out) const;
+
+        std::uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+
+        // counts a record that was not taken
+        void drop() { droppedCount.fetch_add(1, std::memory_order_relaxed); }
+
+    private:
+
+        struct Stripe;
+
+        Stripe& stripeForThisThread();
+        void collect(const AnalyticsFilter& filter, ConsumptionTotals* perHour) const;
+
+        std::unique_ptr<std::atomic<Stripe*>[]> stripes;
+        std::atomic<std::uint64_t> droppedCount{0};
+};
+
+// process-wide instance fed by the console, GUI and batch front ends
+OrderAnalytics& sharedAnalytics();
+
+// current wall-clock time in Unix seconds
+std::int64_t analyticsNow();
+
+// records a computed order (ok results only); order.time 0 means unixTime,
+// and one outside (unixTime - window, unixTime + max skew] is dropped
+void recordOrder(OrderAnalytics& analytics, const Order& order,
+                 const OrderResult& result, std::int64_t unixTime);
+
+// window totals by drink and store, then the last day hour by hour
+void printAnalytics(const OrderAnalytics& analytics, std::int64_t unixTime, std::ostream& out);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef ORDERBATCH_HPP
+#define ORDERBATCH_HPP
+
+#include <cstddef>
+#include <vector>
+#include "drinkTypes.hpp"
+#include "functions.hpp"
+
+/******************************************************************
+ * Struct: CoffeeOrderBatch
+ * ---------------------------------------------------------------
+ * Struct-of-arrays block of pre-parsed coffee orders. Entry i of
+ * every column belongs to the same order.
+ ******************************************************************/
+struct CoffeeOrderBatch {
+    std::vector<Strength> strength;
+    std::vector<Roast>    roast;
+    std::vector<double>   cups;
+
+    void add(Strength s, Roast r, double c);
+    void reserve(std::size_t n);
+    void clear();
+    std::size_t size() const { return cups.size(); }
+};
+
+/******************************************************************
+ * Struct: LatteOrderBatch
+ * ---------------------------------------------------------------
+ * Struct-of-arrays block of pre-parsed latte orders.
+ ******************************************************************/
+struct LatteOrderBatch {
+    std::vector<Strength> strength;
+    std::vector<ShotSize> shotSize;
+    std::vector<int>      shots;
+
+    void add(Strength s, ShotSize size, int count);
+    void reserve(std::size_t n);
+    void clear();
+    std::size_t size() const { return shots.size(); }
+};
+
+// Fills results[i] / valid[i] for every order in the batch.
+// Invalid orders get a zeroed result and valid[i] = 0.
+// Returns the number of valid orders.
+std::size_t calcCoffeeBatch(const CoffeeOrderBatch& orders,
+                            CoffeeResult* results, unsigned char* valid);
+
+std::size_t calcLatteBatch(const LatteOrderBatch& orders,
+                           LatteResult* results, unsigned char* valid);
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef ORDERCACHE_HPP
+#define ORDERCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "orderRecord.hpp"
+#include "resultCache.hpp"
+
+constexpr std::size_t ORDER_CACHE_CAPACITY = 4096;
+constexpr std::size_t ORDER_CACHE_SHARDS = 16;
+
+using OrderCache = ResultCache<OrderResult>;
+
+/******************************************************************
+ * Function: orderCacheKey
+ * ---------------------------------------------------------------
+ * Packs every input that changes an order's numbers into 64 bits
+ * (the topping is display-only and left out). Cups and milk ratio
+ * are stored in thousandths, so only values that are an exact
+ * number of thousandths get a key; anything else (negative, out
+ * of range, or with named registry add-ons) returns 0 and is
+ * computed without the cache.
+ ******************************************************************/
+std::uint64_t orderCacheKey(const Order& order);
+
+// process-wide cache shared by the front ends and batch workers
+OrderCache& sharedOrderCache();
+
+// computeOrder through the cache; results are identical
+bool computeOrderCached(const Order& order, OrderResult& out,
+                        OrderCache& cache = sharedOrderCache());
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef ORDERPIPELINE_HPP
+#define ORDERPIPELINE_HPP
+
+#include <cstddef>
+#include <functional>
+#include "batchMode.hpp"
+
+/******************************************************************
+ * Struct: PipelineOptions
+ * ---------------------------------------------------------------
+ * Tuning for runPipeline. At most threads * chunksPerThread
+ * chunks are in flight; the reader waits for the writer beyond
+ * that, so memory stays bounded on any input size.
+ ******************************************************************/
+struct PipelineOptions {
+    unsigned    threads = 0;               // workers; 0 = one per core
+    std::size_t chunkBytes = 256 * 1024;   // largest read; a chunk is one read's whole lines
+    std::size_t chunksPerThread = 4;
+    CalcEngine  engine = CalcEngine::Double;
+};
+
+// returns bytes read, 0 at end of input, < 0 on error
+using PipelineReader = std::function<long(char* dst, std::size_t len)>;
+
+// returns false if the bytes could not be written
+using PipelineWriter = std::function<bool(const char* src, std::size_t len)>;
+
+// 0 -> number of cores (at least 1)
+unsigned resolveThreadCount(unsigned requested);
+
+// multithreaded processRecords over a whole stream, output in input order
+bool runPipeline(const PipelineReader& read, const PipelineWriter& write,
+                 OutputFormat format, const PipelineOptions& options, BatchCounts& counts,
+                 InventoryForecast* inventory = nullptr);
+
+#endif
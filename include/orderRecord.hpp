@@ -0,0 +1,115 @@
+#ifndef ORDERRECORD_HPP
+#define ORDERRECORD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "addonRegistry.hpp"
+#include "drinkComposition.hpp"
+#include "drinkTypes.hpp"
+#include "functions.hpp"
+
+constexpr std::size_t ORDER_MAX_ADDONS = 8;
+
+// order limits (checkOrderLimits); larger values are rejected, not computed
+constexpr double ORDER_MAX_CUPS = 1000.0;         // 240 L of coffee
+constexpr double ORDER_MAX_MILK_RATIO = 100.0;    // milk : espresso
+constexpr int    ORDER_MAX_SHOTS = 1000;          // base shots, and extra= on top
+constexpr double ORDER_MAX_SIZE_AMOUNT = 1e6;     // volume= mL or beans= g
+
+class Presets;
+
+// sizing an order from a target instead of cups/shots (inverseSolver.hpp)
+enum class SizeBy : unsigned char { None, Volume, Beans };   // final mL, grounds g
+
+// whole latte shots for a target: down never goes over it, up never under
+enum class ShotRounding : unsigned char { Nearest, Down, Up };
+
+/******************************************************************
+ * Struct: Order
+ * ---------------------------------------------------------------
+ * One parsed order record. Record syntax (comma separated, one
+ * order per line, '#' starts a comment line):
+ *
+ *   coffee,<roast>,<strength>,<cups>[,flag...]
+ *   latte,<strength>,<shotSize>,<shots>,<milkStyle>[,flag...]
+ *
+ * Flags: iced | extra=<shots> | ratio=<milk:espresso> |
+ *        topping=<name> | any add-on name from the registry
+ *        (decaf, ristretto, extra-milk, ...; up to
+ *        ORDER_MAX_ADDONS) | store=<id> | time=<unix seconds> |
+ *        volume=<final mL> | beans=<grounds g> |
+ *        round=nearest|down|up.
+ *        ratio= is required for custom milk. store and time only
+ *        feed the analytics (time defaults to when it is processed).
+ *        volume= or beans= sizes the drink (cups/shots may then be
+ *        "auto"); round= picks whole latte shots for the target.
+ ******************************************************************/
+struct Order {
+    DrinkType drink = DrinkType::Coffee;
+
+    // coffee
+    Roast    roast = Roast::Medium;
+    double   cups = 0.0;
+
+    // shared
+    Strength strength = Strength::Medium;
+
+    // latte
+    ShotSize  shotSize = ShotSize::Single;
+    int       shots = 0;
+    MilkStyle milkStyle = MilkStyle::None;
+    double    milkRatio = 0.0;
+
+    // add-ons
+    bool             iced = false;
+    int              extraShots = 0;
+    std::string_view topping;   // view into the input line
+
+    // named menu add-ons, in the order given
+    AddOnId       addOns[ORDER_MAX_ADDONS] = {};
+    unsigned char addOnCount = 0;
+
+    // size from a target; cups/shots are filled in when parsed
+    SizeBy       sizeBy = SizeBy::None;
+    double       sizeAmount = 0.0;
+    ShotRounding rounding = ShotRounding::Nearest;
+
+    // analytics only; not part of the drink
+    unsigned     store = 0;
+    std::int64_t time = 0;   // Unix seconds, 0 = now
+};
+
+/******************************************************************
+ * Struct: OrderResult
+ * ---------------------------------------------------------------
+ * Output of computeOrder; coffee or latte is filled per drink.
+ ******************************************************************/
+struct OrderResult {
+    DrinkType    drink = DrinkType::Coffee;
+    bool         ok = false;
+    CoffeeResult coffee{};
+    LatteResult  latte;
+    double       caffeineMg = 0.0;
+};
+
+// parses one record; on failure error points at a static message
+bool parseOrderLine(std::string_view line, Order& out, const char*& error);
+
+// nullptr if the order's numbers are within the ORDER_MAX_* limits,
+// else a static message; parseOrderLine and fromWire both apply it
+const char* checkOrderLimits(const Order& order);
+
+// the order a saved preset describes (no add-ons)
+void presetOrder(const Presets& preset, Order& out);
+
+// the order as a DrinkComposition (base, add-ons, milk target)
+void composeOrder(const Order& order, DrinkComposition& out);
+
+// calc + add-ons + milk target, as the interactive front ends do
+bool computeOrder(const Order& order, OrderResult& out);
+
+// true for blank lines and '#' comments
+bool isSkippableLine(std::string_view line);
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef ORDERSERVER_HPP
+#define ORDERSERVER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "batchMode.hpp"
+#include "orderRecord.hpp"
+#include "presetManager.hpp"
+#include "presetStore.hpp"
+
+// default socket for --serve (relative to the working directory)
+constexpr const char* DEFAULT_SERVER_SOCKET = "final_project.sock";
+
+constexpr std::size_t SERVER_READ_CHUNK  = 64 * 1024;
+constexpr std::size_t SERVER_MAX_LINE    = 4096;        // longer requests close the connection
+constexpr std::size_t SERVER_MAX_PENDING = 1 << 20;     // unsent replies before reading pauses
+constexpr int         SERVER_BACKLOG     = 128;
+
+// first byte of every binary frame (never starts a record line)
+constexpr std::uint8_t WIRE_MAGIC = 0xC5;
+
+enum class WireStatus : std::uint8_t { Ok, Invalid, CalcError };
+
+/******************************************************************
+ * Struct: WireRequest
+ * ---------------------------------------------------------------
+ * One binary order, 64 bytes in host byte order (the socket is
+ * local, so both ends share it). Enum fields hold the enum values
+ * from drinkTypes.hpp; addOns are registry ids. sizeBy other than
+ * None sizes the drink from sizeAmount as volume=/beans= do, and
+ * cups/shots are then ignored. id is echoed in the response.
+ ******************************************************************/
+struct WireRequest {
+    std::uint8_t  magic = WIRE_MAGIC;
+    std::uint8_t  drink = 0;
+    std::uint8_t  roast = 0;
+    std::uint8_t  strength = 0;
+    std::uint8_t  shotSize = 0;
+    std::uint8_t  milkStyle = 0;
+    std::uint8_t  iced = 0;
+    std::uint8_t  addOnCount = 0;
+    std::uint8_t  addOns[ORDER_MAX_ADDONS] = {};
+    std::uint32_t id = 0;
+    std::int32_t  shots = 0;
+    std::int32_t  extraShots = 0;
+    std::uint16_t store = 0;
+    std::uint8_t  sizeBy = 0;
+    std::uint8_t  rounding = 0;
+    double        cups = 0.0;
+    double        milkRatio = 0.0;
+    double        sizeAmount = 0.0;
+    std::int64_t  time = 0;
+};
+
+/******************************************************************
+ * Struct: WireResponse
+ * ---------------------------------------------------------------
+ * Reply to one WireRequest, 80 bytes. ratio is the brew ratio of
+ * either drink; coffee fills waterML, lattes espresso/milk/final.
+ * The numbers are only meaningful when status is Ok.
+ ******************************************************************/
+struct WireResponse {
+    std::uint8_t  magic = WIRE_MAGIC;
+    WireStatus    status = WireStatus::Ok;
+    std::uint8_t  drink = 0;
+    std::uint8_t  hasMilkTarget = 0;
+    std::uint32_t id = 0;
+    std::int32_t  shots = 0;
+    std::uint32_t reserved = 0;
+    double        ratio = 0.0;
+    double        coffeeGrams = 0.0;
+    double        tablespoons = 0.0;
+    double        waterML = 0.0;
+    double        espressoML = 0.0;
+    double        milkML = 0.0;
+    double        finalML = 0.0;
+    double        caffeineMg = 0.0;
+};
+
+static_assert(sizeof(WireRequest) == 64, "WireRequest layout is part of the protocol");
+static_assert(sizeof(WireResponse) == 80, "WireResponse layout is part of the protocol");
+
+// order -> frame (the loadgen side)
+WireRequest toWire(const Order& order, std::uint32_t id);
+
+// frame -> order, with the checks parseOrderLine makes
+bool fromWire(const WireRequest& request, Order& out);
+
+// result -> frame
+WireResponse wireResponse(std::uint32_t id, const OrderResult& result, WireStatus status);
+
+/******************************************************************
+ * Struct: ServerOptions
+ * ---------------------------------------------------------------
+ * Settings for daemon mode (--serve).
+ ******************************************************************/
+struct ServerOptions {
+    std::string  socketPath = DEFAULT_SERVER_SOCKET;
+    OutputFormat format = OutputFormat::Csv;   // line-mode replies
+    std::string  menuPath;                     // precomputed menu table; empty = build in memory
+    bool         presets = true;               // answer preset,<name> from presets.bin
+    bool         stopOnSignal = false;         // SIGINT/SIGTERM end run()
+};
+
+/******************************************************************
+ * Struct: ServerStats
+ * ---------------------------------------------------------------
+ * Totals since open(); read after run() returns.
+ ******************************************************************/
+struct ServerStats {
+    std::size_t connections = 0;
+    std::size_t requests = 0;
+    std::size_t failed = 0;       // invalid or uncomputable orders
+    std::size_t dropped = 0;      // connections closed for a protocol error
+};
+
+/******************************************************************
+ * Class: OrderServer
+ * ---------------------------------------------------------------
+ * Long-running order service on a Unix domain socket, so a POS
+ * terminal pays process start-up and preset loading once instead
+ * of per order. One thread runs a level-triggered epoll loop over
+ * non-blocking sockets.
+ *
+ * A client may pipeline any number of requests; each connection's
+ * replies come back in request order. Requests are either
+ *
+ *   - a record line as in batch mode (orderRecord.hpp), or
+ *     "preset,<name>" for a saved preset, answered with the batch
+ *     CSV/JSONL row (line = request number on the connection;
+ *     blank and '#' lines get no reply), or
+ *   - a WireRequest frame, answered with a WireResponse.
+ *
+ * Both kinds may be mixed on one connection. Orders go through the
+ * same menu table, calculator and analytics as batch mode. Replies
+ * are buffered per connection; past SERVER_MAX_PENDING unsent
+ * bytes the server stops reading that client until it catches up.
+ *
+ * Linux only (epoll); elsewhere open() fails with a message.
+ ******************************************************************/
+class OrderServer {
+
+    public:
+
+        OrderServer();
+        ~OrderServer();
+
+        OrderServer(const OrderServer&) = delete;
+        OrderServer& operator=(const OrderServer&) = delete;
+
+        // binds and listens; replaces a stale socket file. false with error set on failure.
+        bool open(const ServerOptions& options, std::string& error);
+
+        // serves until stop() (or a signal, if asked); false on a fatal error
+        bool run();
+
+        // thread-safe; run() returns after the current events
+        void stop();
+
+        const ServerStats& stats() const { return totals; }
+
+    private:
+
+        struct Connection;
+
+        void accept();
+        void onReadable(Connection& c);
+        void onWritable(Connection& c);
+        void serveRequests(Connection& c, bool atEnd);
+        void serveLine(Connection& c, std::string_view line);
+        void serveFrame(Connection& c, const WireRequest& request);
+        void updateEvents(Connection& c);
+        void closeConnection(Connection& c);
+
+        ServerOptions options;
+        ServerStats totals;
+        PresetStore presetStore;
+        PresetManager presetManager;
+        std::vector<std::unique_ptr<Connection>> connections;   // by fd
+        int listenFd = -1;
+        int epollFd = -1;
+        int wakeFd = -1;
+        int signalFd = -1;
+        std::atomic<bool> stopping{false};
+};
+
+// --serve: runs an OrderServer until SIGINT/SIGTERM; totals to stderr
+int runServer(const ServerOptions& options);
+
+#endif
@@ -1,28 +1,85 @@
 #ifndef PRESETMANAGER_HPP
 #define PRESETMANAGER_HPP
 
+#include <cstdint>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
-#include <string>
 #include "presets.hpp"
+#include "presetStore.hpp"
 using namespace std;
 
+/******************************************************************
+ * Struct: PresetHandle
+ * ---------------------------------------------------------------
+ * Stable reference to a stored preset. Stays valid across later
+ * insertions; becomes stale (resolves to nullptr) once the preset
+ * is removed, even if its slot is reused.
+ ******************************************************************/
+struct PresetHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != UINT32_MAX; }
+};
+
 class PresetManager {
     
     private:
     
-        vector<Presets> presets;
+        struct Slot {
+            Presets preset;
+            uint32_t generation;
+            bool live;
+        };
+
+        // deque keeps slot addresses (and the name views below) stable.
+        // With a store attached these act as a cache of it, filled on
+        // demand, hence mutable.
+        mutable deque<Slot> slots;
+        mutable vector<uint32_t> freeSlots;
+        mutable unordered_map<string_view, uint32_t> byName;
+        mutable bool storeLoaded = false;
+
+        PresetStore* store = nullptr;
+
+        PresetHandle insertSlot(const Presets& preset) const;
+        PresetHandle faultIn(string_view name) const;
+        void loadAllFromStore() const;
 
     public:
+
+        PresetManager() = default;
+
+        // name index holds views into slots, so no copies
+        PresetManager(const PresetManager&) = delete;
+        PresetManager& operator=(const PresetManager&) = delete;
+        PresetManager(PresetManager&&) = default;
+        PresetManager& operator=(PresetManager&&) = default;
+
+        // persist through store (not owned); presets load lazily from it
+        void attachStore(PresetStore* backing);
     
     // list functions
-        void addPreset(const Presets& preset);
+        // returns an invalid handle if the name is already taken
+        PresetHandle addPreset(const Presets& preset);
+        bool removePreset(string_view name);
         void listPresets() const;
         
     // accessor
-        Presets* getPresetByName(const string& name);
-        vector<string> getPresetNames() const;
+        PresetHandle findPreset(string_view name);
+        Presets* getPreset(PresetHandle handle);
+        const Presets* getPreset(PresetHandle handle) const;
+        Presets* getPresetByName(string_view name);
+        bool contains(string_view name) const;
+
+        // views into stored names; valid until that preset is removed
+        vector<string_view> getPresetNames() const;
+        void getPresetNames(vector<string_view>& out) const;   // reuses out's capacity
     
         bool hasPresets() const;
+        size_t size() const;
 
 
 };
@@ -0,0 +1,128 @@
+#ifndef PRESETSTORE_HPP
+#define PRESETSTORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "presets.hpp"
+
+/******************************************************************
+ * Struct: PresetRecord
+ * ---------------------------------------------------------------
+ * One fixed-size (64 byte) on-disk preset. Stored in host byte
+ * order; the file header records the layout version.
+ ******************************************************************/
+struct PresetRecord {
+    char     name[PRESET_NAME_MAX + 1];
+    uint8_t  state;            // RECORD_LIVE or RECORD_TOMBSTONE
+    uint8_t  drinkType;
+    uint8_t  roast;
+    uint8_t  coffeeStrength;
+    uint8_t  shotSize;
+    uint8_t  latteStrength;
+    uint8_t  milkStyle;
+    uint8_t  reserved;
+    int32_t  shots;
+    uint32_t checksum;         // FNV-1a of the record with this field zeroed
+    double   coffeeCups;
+    double   milkRatio;
+};
+
+static_assert(sizeof(PresetRecord) == 64, "PresetRecord layout is part of the file format");
+
+// store file used by the console and GUI (relative to the working directory)
+constexpr const char* DEFAULT_PRESET_STORE = "presets.bin";
+
+constexpr uint8_t RECORD_LIVE      = 1;
+constexpr uint8_t RECORD_TOMBSTONE = 2;
+
+/******************************************************************
+ * Class: PresetStore
+ * ---------------------------------------------------------------
+ * Persistent preset file. Layout:
+ *
+ *   [header][hash table][base records][write-ahead tail records]
+ *
+ * The header, hash table and base records are written by
+ * compaction and mmap'ed read-only at open, so lookups into the
+ * base read the mapping directly and startup never scans it. New
+ * presets and deletions (tombstones) are appended to the tail,
+ * which is replayed at open and folded back into the base once it
+ * grows past a threshold.
+ *
+ * Every header offset is checked against the file size at open;
+ * records are checked (checksum, terminated name, field ranges)
+ * when read, and a bad one is treated as absent. Opening, appends
+ * and compaction hold an flock on "<path>.lock" and remap first
+ * if another process replaced or extended the file.
+ ******************************************************************/
+class PresetStore {
+
+    public:
+
+        PresetStore() = default;
+        ~PresetStore();
+
+        PresetStore(const PresetStore&) = delete;
+        PresetStore& operator=(const PresetStore&) = delete;
+
+        // maps an existing file; a missing file (ENOENT) opens as an empty store
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const { return !path.empty(); }
+
+        // write-ahead tail; false if the name exists / is missing
+        bool append(const Presets& preset);
+        bool remove(std::string_view name);
+
+        // zero-copy lookups (decoded into out on success)
+        bool find(std::string_view name, Presets& out) const;
+        bool contains(std::string_view name) const;
+
+        // visits every live preset (base first, then tail)
+        void forEach(const std::function<void(const Presets&)>& fn) const;
+
+        size_t size() const { return liveCount; }
+        size_t tailSize() const { return tail.size(); }
+
+        // rewrites base + live tail into a fresh file and remaps it
+        bool compact();
+
+    private:
+
+        std::string path;
+        int fd = -1;
+
+        // read-only mapping of header + table + base
+        const unsigned char* mapped = nullptr;
+        size_t mappedSize = 0;
+        const uint32_t* table = nullptr;
+        const PresetRecord* base = nullptr;
+        uint64_t tableSlots = 0;
+        uint64_t baseCount = 0;
+        uint64_t tailOffset = 0;
+        uint64_t fileEnd = 0;          // end of the last record we know of
+
+        // tail records since the last compaction, indexed by name
+        std::deque<PresetRecord> tail;
+        std::unordered_map<std::string_view, size_t> tailIndex;
+
+        size_t liveCount = 0;
+
+        const PresetRecord* baseRecord(uint64_t i) const;
+        const PresetRecord* findBase(std::string_view name) const;
+        const PresetRecord* findLive(std::string_view name) const;
+        bool appendRecord(const PresetRecord& rec);   // lock held
+        bool refresh();                               // lock held
+        bool compactLocked();                         // lock held
+        bool mapFile();
+        void unmap();
+        void dropFile();
+        void maybeCompact();
+};
+
+#endif
@@ -2,53 +2,62 @@
 #define PRESETS_HPP
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include <type_traits>
+#include "drinkTypes.hpp"
 using namespace std;
 
+// longest preset name; longer names are refused, not truncated
+constexpr size_t PRESET_NAME_MAX = 31;
+
+// every input checks this before a name becomes a key
+inline bool presetNameFits(string_view name) { return name.size() <= PRESET_NAME_MAX; }
+
 class Presets{
     
     private:
     
-        string name;
-        string drinkType;
+        char name[PRESET_NAME_MAX + 1] = {};
+        DrinkType drinkType = DrinkType::Coffee;
         
         // coffee values
-        string coffeeRoast;
-        string coffeeStrength;
+        Roast coffeeRoast = Roast::Medium;
+        Strength coffeeStrength = Strength::Medium;
         double coffeeCups = 0.0;
         
         // latte values
-        string shotSize;
+        ShotSize shotSize = ShotSize::Single;
         int shots = 0;
-        string latteStrength;
-        string milkStyle;
+        Strength latteStrength = Strength::Stronger;
+        MilkStyle milkStyle = MilkStyle::None;
         double milkRatio = 0.0;
         
     public:
     
         // constructor
-        Presets(const string& name);
+        Presets(string_view name);
         
         // set
-        void setCoffee(const string& roast, const string& strength, double cups);
-        void setLatte(const string& shotSize, int shorts, const string& strength,
-                       const string& milkStyle, double ratio);
+        void setCoffee(Roast roast, Strength strength, double cups);
+        void setLatte(ShotSize shotSize, int shots, Strength strength,
+                      MilkStyle milkStyle, double ratio);
                        
         // accessors
-        string getName() const;
-        string getDrinkType() const;
+        string_view getName() const;
+        DrinkType getDrinkType() const;
         
         // coffee accessors
-        string getRoast() const;
-        string getStrength() const;
+        Roast getRoast() const;
+        Strength getStrength() const;
         double getCups() const;
         
         // latte accessors
-        string getShotSize() const;
+        ShotSize getShotSize() const;
         int getShots() const;
-        string getMilkStyle() const;
+        MilkStyle getMilkStyle() const;
         double getMilkRatio() const;
-        string getLatteStrength() const;
+        Strength getLatteStrength() const;
         
     
         // display
@@ -56,7 +65,7 @@ class Presets{
         
 };
 
+static_assert(std::is_trivially_copyable<Presets>::value, "Presets must stay POD");
 
 
-
-#endif
\ No newline at end of file
+#endif
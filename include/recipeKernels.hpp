@@ -0,0 +1,156 @@
+#ifndef RECIPEKERNELS_HPP
+#define RECIPEKERNELS_HPP
+
+#include "constants.hpp"
+#include "drinkTypes.hpp"
+#include "functions.hpp"
+
+/******************************************************************
+ * Struct: CoffeeRecipe
+ * ---------------------------------------------------------------
+ * Per-cup factors for one (strength, roast) pair. Every coffee
+ * output is cups times one of these, so a calculation is a single
+ * table load plus multiplies. ratio == 0 marks an invalid pair.
+ ******************************************************************/
+struct CoffeeRecipe {
+    double ratio;
+    double gramsPerCup;
+    double tbspPerCup;
+};
+
+/******************************************************************
+ * Struct: LatteRecipe
+ * ---------------------------------------------------------------
+ * Per-shot factors for one (shot size, strength) pair.
+ * brewRatio == 0 marks an invalid pair.
+ ******************************************************************/
+struct LatteRecipe {
+    double gramsPerShot;
+    double brewRatio;
+    double espressoMLPerShot;
+    double espressoCupsPerShot;
+    double tbspPerShot;
+};
+
+constexpr CoffeeRecipe coffeeRecipe(Strength s, Roast r) {
+    double base = COFFEE_BASE_RATIO[indexOf(s)];
+    if (base == 0.0) return {0.0, 0.0, 0.0};
+    double ratio = base + ROAST_RATIO_ADJUST[indexOf(r)];
+    double gramsPerCup = ML_PER_CUP / ratio;
+    return {ratio, gramsPerCup, gramsPerCup / GRAMS_PER_TBSP};
+}
+
+constexpr LatteRecipe latteRecipe(ShotSize size, Strength s) {
+    double grams = GRAMS_PER_SHOT[indexOf(size)];
+    double brewRatio = ESPRESSO_RATIO[indexOf(s)];
+    if (brewRatio == 0.0) return {0.0, 0.0, 0.0, 0.0, 0.0};
+    double espressoML = grams * brewRatio;
+    return {grams, brewRatio, espressoML, espressoML / ML_PER_CUP,
+            grams / GRAMS_PER_TBSP};
+}
+
+/******************************************************************
+ * Compile-time lookup tables covering every parameter combination.
+ ******************************************************************/
+struct CoffeeRecipeTable {
+    CoffeeRecipe entry[STRENGTH_COUNT][ROAST_COUNT];
+
+    constexpr CoffeeRecipeTable() : entry{} {
+        for (std::size_t s = 0; s < STRENGTH_COUNT; ++s)
+            for (std::size_t r = 0; r < ROAST_COUNT; ++r)
+                entry[s][r] = coffeeRecipe(static_cast<Strength>(s),
+                                           static_cast<Roast>(r));
+    }
+
+    constexpr const CoffeeRecipe& operator()(Strength s, Roast r) const {
+        return entry[indexOf(s)][indexOf(r)];
+    }
+};
+
+struct LatteRecipeTable {
+    LatteRecipe entry[SHOT_SIZE_COUNT][STRENGTH_COUNT];
+
+    constexpr LatteRecipeTable() : entry{} {
+        for (std::size_t z = 0; z < SHOT_SIZE_COUNT; ++z)
+            for (std::size_t s = 0; s < STRENGTH_COUNT; ++s)
+                entry[z][s] = latteRecipe(static_cast<ShotSize>(z),
+                                          static_cast<Strength>(s));
+    }
+
+    constexpr const LatteRecipe& operator()(ShotSize z, Strength s) const {
+        return entry[indexOf(z)][indexOf(s)];
+    }
+};
+
+constexpr CoffeeRecipeTable COFFEE_RECIPES{};
+constexpr LatteRecipeTable  LATTE_RECIPES{};
+
+/******************************************************************
+ * Function: calcCoffee<Strength, Roast>
+ * ---------------------------------------------------------------
+ * Compile-time specialized coffee kernel. The recipe is a constant
+ * of the instantiation; cups must already be validated (> 0).
+ ******************************************************************/
+template <Strength S, Roast R>
+inline CoffeeResult calcCoffee(double cups) {
+    static_assert(isCoffeeStrength(S), "coffee kernel needs bolder/medium/weaker");
+    constexpr CoffeeRecipe rec = coffeeRecipe(S, R);
+    return {cups, cups * ML_PER_CUP, cups * rec.gramsPerCup, rec.ratio,
+            cups * rec.tbspPerCup};
+}
+
+/******************************************************************
+ * Function: calcLatte<ShotSize, Strength>
+ * ---------------------------------------------------------------
+ * Compile-time specialized latte kernel (no milk target). shots
+ * must already be validated (> 0).
+ ******************************************************************/
+template <ShotSize Z, Strength S>
+inline LatteResult calcLatte(int shots) {
+    static_assert(isLatteStrength(S), "latte kernel needs stronger/weaker");
+    constexpr LatteRecipe rec = latteRecipe(Z, S);
+    return LatteResult(shots, Z, shots * rec.gramsPerShot, rec.brewRatio,
+                       shots * rec.espressoMLPerShot,
+                       shots * rec.espressoCupsPerShot,
+                       shots * rec.tbspPerShot);
+}
+
+/******************************************************************
+ * Compile-time checks pinning the recipe values.
+ ******************************************************************/
+namespace recipe_checks {
+
+constexpr bool near(double a, double b) {
+    return (a - b) < 1e-9 && (b - a) < 1e-9;
+}
+
+static_assert(COFFEE_RECIPES(Strength::Bolder, Roast::Light).ratio == 15.0, "bolder/light");
+static_assert(COFFEE_RECIPES(Strength::Bolder, Roast::Medium).ratio == 14.0, "bolder/medium");
+static_assert(COFFEE_RECIPES(Strength::Bolder, Roast::Dark).ratio == 13.0, "bolder/dark");
+static_assert(COFFEE_RECIPES(Strength::Medium, Roast::Light).ratio == 17.0, "medium/light");
+static_assert(COFFEE_RECIPES(Strength::Medium, Roast::Medium).ratio == 16.0, "medium/medium");
+static_assert(COFFEE_RECIPES(Strength::Medium, Roast::Dark).ratio == 15.0, "medium/dark");
+static_assert(COFFEE_RECIPES(Strength::Weaker, Roast::Light).ratio == 19.0, "weaker/light");
+static_assert(COFFEE_RECIPES(Strength::Weaker, Roast::Medium).ratio == 18.0, "weaker/medium");
+static_assert(COFFEE_RECIPES(Strength::Weaker, Roast::Dark).ratio == 17.0, "weaker/dark");
+static_assert(COFFEE_RECIPES(Strength::Stronger, Roast::Medium).ratio == 0.0, "stronger is latte-only");
+
+static_assert(near(COFFEE_RECIPES(Strength::Medium, Roast::Medium).gramsPerCup, 15.0), "240 mL / 16");
+static_assert(near(COFFEE_RECIPES(Strength::Medium, Roast::Medium).tbspPerCup, 15.0 / 16.0), "g -> tbsp");
+static_assert(near(COFFEE_RECIPES(Strength::Bolder, Roast::Dark).gramsPerCup * 13.0, ML_PER_CUP), "240 mL / 13");
+
+static_assert(LATTE_RECIPES(ShotSize::Single, Strength::Stronger).espressoMLPerShot == 16.0, "8 g x 2.0");
+static_assert(LATTE_RECIPES(ShotSize::Single, Strength::Weaker).espressoMLPerShot == 20.0, "8 g x 2.5");
+static_assert(LATTE_RECIPES(ShotSize::Double, Strength::Stronger).espressoMLPerShot == 32.0, "16 g x 2.0");
+static_assert(LATTE_RECIPES(ShotSize::Double, Strength::Weaker).espressoMLPerShot == 40.0, "16 g x 2.5");
+static_assert(LATTE_RECIPES(ShotSize::Double, Strength::Weaker).tbspPerShot == 1.0, "16 g = 1 tbsp");
+static_assert(LATTE_RECIPES(ShotSize::Single, Strength::Bolder).brewRatio == 0.0, "bolder is coffee-only");
+static_assert(near(LATTE_RECIPES(ShotSize::Double, Strength::Weaker).espressoCupsPerShot, 40.0 / 240.0), "mL -> cups");
+
+static_assert(MILK_RATIO[indexOf(MilkStyle::Cortado)] == 1.0, "cortado 1:1");
+static_assert(MILK_RATIO[indexOf(MilkStyle::FlatWhite)] == 2.0, "flat white 2:1");
+static_assert(MILK_RATIO[indexOf(MilkStyle::Latte)] == 3.0, "latte 3:1");
+
+} // namespace recipe_checks
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef RESULTCACHE_HPP
+#define RESULTCACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/******************************************************************
+ * Struct: CacheStats
+ * ---------------------------------------------------------------
+ * Counters summed over all shards of a ResultCache.
+ ******************************************************************/
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t evictions = 0;
+    std::size_t   entries = 0;
+    std::size_t   capacity = 0;
+};
+
+/******************************************************************
+ * Class: ResultCache
+ * ---------------------------------------------------------------
+ * Bounded memo table from a packed 64-bit key to a plain result
+ * value, safe to share between threads. Keys are spread over
+ * power-of-two shards, each with its own mutex, so workers rarely
+ * wait on each other. Inside a shard every key maps to one set of
+ * WAYS entries; a full set evicts with CLOCK (second chance): an
+ * entry read since the hand last passed survives one more round.
+ * All memory is allocated up front. Key 0 means "not cacheable"
+ * and is never stored.
+ ******************************************************************/
+template <typename Value>
+class ResultCache {
+
+    public:
+
+        static constexpr std::size_t WAYS = 8;
+
+        ResultCache(std::size_t capacity, std::size_t shardCount) {
+            std::size_t shards = 1;
+            while (shards < shardCount) shards *= 2;
+            std::size_t sets = 1;
+            while (shards * sets * WAYS < capacity) sets *= 2;
+            shardMask = shards - 1;
+            setMask = sets - 1;
+            shardList.reset(new Shard[shards]);
+            for (std::size_t i = 0; i < shards; ++i) {
+                shardList[i].entries.reset(new Entry[sets * WAYS]());
+                shardList[i].hands.reset(new unsigned char[sets]());
+            }
+        }
+
+        ResultCache(const ResultCache&) = delete;
+        ResultCache& operator=(const ResultCache&) = delete;
+
+        // copies the cached value into out; counts a hit or a miss
+        bool lookup(std::uint64_t key, Value& out) {
+            if (key == 0) return false;
+            std::uint64_t h = mix(key);
+            Shard& shard = shardFor(h);
+            std::lock_guard<std::mutex> guard(shard.lock);
+            Entry* set = setFor(shard, h);
+            for (std::size_t w = 0; w < WAYS; ++w) {
+                if (set[w].key == key) {
+                    set[w].referenced = true;
+                    out = set[w].value;
+                    ++shard.hits;
+                    return true;
+                }
+            }
+            ++shard.misses;
+            return false;
+        }
+
+        void insert(std::uint64_t key, const Value& value) {
+            if (key == 0) return;
+            std::uint64_t h = mix(key);
+            Shard& shard = shardFor(h);
+            std::lock_guard<std::mutex> guard(shard.lock);
+            Entry* set = setFor(shard, h);
+
+            Entry* slot = nullptr;
+            for (std::size_t w = 0; w < WAYS && !slot; ++w) {
+                if (set[w].key == key || set[w].key == 0) slot = &set[w];
+            }
+            if (!slot) {
+                // CLOCK: clear reference bits until an unreferenced entry comes up
+                unsigned char& hand = shard.hands[(h >> 32) & setMask];
+                while (set[hand].referenced) {
+                    set[hand].referenced = false;
+                    hand = static_cast<unsigned char>((hand + 1) % WAYS);
+                }
+                slot = &set[hand];
+                hand = static_cast<unsigned char>((hand + 1) % WAYS);
+                ++shard.evictions;
+            }
+            slot->key = key;
+            slot->referenced = false;
+            slot->value = value;
+        }
+
+        // lookup, else compute (outside the lock) and remember a success
+        template <typename Compute>
+        bool getOrCompute(std::uint64_t key, Value& out, Compute compute) {
+            if (lookup(key, out)) return true;
+            if (!compute(out)) return false;
+            insert(key, out);
+            return true;
+        }
+
+        void clear() {
+            for (std::size_t s = 0; s <= shardMask; ++s) {
+                Shard& shard = shardList[s];
+                std::lock_guard<std::mutex> guard(shard.lock);
+                for (std::size_t i = 0; i < (setMask + 1) * WAYS; ++i)
+                    shard.entries[i] = Entry();
+                shard.hits = shard.misses = shard.evictions = 0;
+            }
+        }
+
+        CacheStats stats() const {
+            CacheStats total;
+            total.capacity = capacity();
+            for (std::size_t s = 0; s <= shardMask; ++s) {
+                Shard& shard = shardList[s];
+                std::lock_guard<std::mutex> guard(shard.lock);
+                total.hits += shard.hits;
+                total.misses += shard.misses;
+                total.evictions += shard.evictions;
+                for (std::size_t i = 0; i < (setMask + 1) * WAYS; ++i)
+                    total.entries += (shard.entries[i].key != 0);
+            }
+            return total;
+        }
+
+        std::size_t capacity() const { return (shardMask + 1) * (setMask + 1) * WAYS; }
+
+    private:
+
+        struct Entry {
+            std::uint64_t key = 0;
+            bool          referenced = false;
+            Value         value{};
+        };
+
+        // one cache line per shard header so shard locks do not false-share
+        struct alignas(64) Shard {
+            std::mutex lock;
+            std::unique_ptr<Entry[]> entries;
+            std::unique_ptr<unsigned char[]> hands;
+            std::uint64_t hits = 0;
+            std::uint64_t misses = 0;
+            std::uint64_t evictions = 0;
+        };
+
+        // splitmix64 finalizer: packed keys differ in few bits
+        static std::uint64_t mix(std::uint64_t x) {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9ULL;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111ebULL;
+            x ^= x >> 31;
+            return x;
+        }
+
+        Shard& shardFor(std::uint64_t h) const { return shardList[h & shardMask]; }
+        Entry* setFor(Shard& shard, std::uint64_t h) const {
+            return &shard.entries[((h >> 32) & setMask) * WAYS];
+        }
+
+        std::unique_ptr<Shard[]> shardList;
+        std::size_t shardMask = 0;
+        std::size_t setMask = 0;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef SESSIONARENA_HPP
+#define SESSIONARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// inline bytes per session; text answers past this spill to the heap
+constexpr std::size_t SESSION_ARENA_BYTES = 2048;
+
+/******************************************************************
+ * Class: SessionArena
+ * ---------------------------------------------------------------
+ * Memory for one order session (one pass from the main menu to a
+ * summary): a monotonic arena over an inline buffer, handed to the
+ * session's pmr containers. Frees inside a session are no-ops;
+ * release() drops everything at once and rewinds to the inline
+ * buffer, so ending a session costs O(1) and a normal session
+ * never touches the global heap. Only a session that outgrows the
+ * buffer (a very long typed name) borrows from the heap, counted
+ * by heapBlocks().
+ *
+ * Nothing allocated from the arena may be used after release():
+ * the owner clears its containers first.
+ ******************************************************************/
+class SessionArena {
+
+    public:
+
+        SessionArena() : arena(buffer, sizeof buffer, &upstream) {}
+
+        SessionArena(const SessionArena&) = delete;
+        SessionArena& operator=(const SessionArena&) = delete;
+
+        std::pmr::memory_resource* resource() { return &arena; }
+
+        // ends the session: every allocation is gone
+        void release() {
+            arena.release();
+            ++sessions;
+        }
+
+        std::uint64_t sessionsEnded() const { return sessions; }
+        std::uint64_t heapBlocks() const { return upstream.blocks; }
+
+    private:
+
+        // the global heap, counting what the arena had to borrow
+        struct Upstream : std::pmr::memory_resource {
+            std::uint64_t blocks = 0;
+
+            void* do_allocate(std::size_t bytes, std::size_t align) override {
+                ++blocks;
+                return std::pmr::new_delete_resource()->allocate(bytes, align);
+            }
+            void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+                std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+            }
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+                return this == &other;
+            }
+        };
+
+        alignas(std::max_align_t) std::byte buffer[SESSION_ARENA_BYTES];
+        Upstream upstream;
+        std::pmr::monotonic_buffer_resource arena;
+        std::uint64_t sessions = 0;
+};
+
+#endif
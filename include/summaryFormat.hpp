@@ -0,0 +1,53 @@
+#ifndef SUMMARYFORMAT_HPP
+#define SUMMARYFORMAT_HPP
+
+#include <cstddef>
+#include <string_view>
+#include "drinkTypes.hpp"
+#include "functions.hpp"
+
+// large enough for any summary either front end renders
+constexpr std::size_t SUMMARY_CAPACITY = 1024;
+
+/******************************************************************
+ * Class: SummaryWriter
+ * ---------------------------------------------------------------
+ * Appends text and numbers into a caller-provided fixed buffer.
+ * Numbers go through std::to_chars (fixed, 2 decimals for
+ * doubles), so formatting never touches the heap or a stream.
+ * The buffer is always NUL-terminated; output that does not fit
+ * is cut off and reported by truncated().
+ ******************************************************************/
+class SummaryWriter {
+
+    public:
+
+        SummaryWriter(char* buffer, std::size_t capacity);
+
+        template <std::size_t N>
+        explicit SummaryWriter(char (&buffer)[N]) : SummaryWriter(buffer, N) {}
+
+        SummaryWriter& append(std::string_view s);
+        SummaryWriter& append(char c);
+        SummaryWriter& appendInt(long long v);
+        SummaryWriter& appendFixed2(double v);
+
+        std::string_view view() const { return std::string_view(data, used); }
+        const char* c_str() const { return data; }
+        std::size_t size() const { return used; }
+        bool truncated() const { return overflow; }
+        void clear();
+
+    private:
+
+        char* data;
+        std::size_t capacity;   // usable bytes (one kept for the NUL)
+        std::size_t used = 0;
+        bool overflow = false;
+};
+
+// the console summaries (printCoffeeSummary / printLatteSummary)
+void formatCoffeeSummary(SummaryWriter& out, const CoffeeResult& r, Roast roast, Strength strength);
+void formatLatteSummary(SummaryWriter& out, const LatteResult& r, Strength strength);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef UIREPLAY_HPP
+#define UIREPLAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "uiStateMachine.hpp"
+
+/******************************************************************
+ * UI event traces
+ * ---------------------------------------------------------------
+ * A trace is plain text, one event per line ('#' comments and
+ * blank lines are skipped):
+ *
+ *   up | down | left | enter | esc | backspace | text <chars>
+ *
+ * "text abc" expands to one character event per letter. The GUI
+ * records traces in this format (--record); the replay driver
+ * pushes them through a UiMachine without a window.
+ ******************************************************************/
+
+// false (and the 1-based line in errorLine) on an unknown event
+bool parseUiTrace(std::string_view text, std::vector<UiEvent>& out, std::size_t& errorLine);
+
+// one trace line for the event
+void writeUiEvent(std::ostream& out, const UiEvent& event);
+
+struct ReplayStats {
+    std::size_t   events = 0;
+    std::size_t   handled = 0;     // events the machine used
+    std::size_t   summaries = 0;   // Summary screens reached
+    std::size_t   errors = 0;      // Error screens reached
+    std::uint64_t digest = 0;      // FNV-1a over screens and summary text
+};
+
+// replays events in order; onScreen (optional) sees each Summary/Error
+ReplayStats replayUiTrace(UiMachine& machine, const std::vector<UiEvent>& events,
+                          void (*onScreen)(const UiMachine&) = nullptr);
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef UISTATEMACHINE_HPP
+#define UISTATEMACHINE_HPP
+
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "drinkTypes.hpp"
+#include "functions.hpp"
+#include "orderRecord.hpp"
+#include "presetManager.hpp"
+#include "sessionArena.hpp"
+#include "summaryFormat.hpp"
+
+enum class Flow : unsigned char { None, Make, CreatePreset, LoadPreset };
+
+// order matches the screen table in uiStateMachine.cpp
+enum class Screen : unsigned char {
+    MainMenu,
+    ChooseDrink,
+    CoffeeRoast,
+    CoffeeStrength,
+    CoffeeCups,
+    LatteStrength,
+    LatteShotSize,
+    LatteShots,
+    LatteMilkStyle,
+    LatteMilkRatio,
+    PresetName,
+    LoadPresetList,
+    AddonsPrompt,
+    AddonsList,
+    ToppingInput,
+    ExtraShotsInput,
+    Summary,
+    Error
+};
+
+constexpr std::size_t SCREEN_COUNT = static_cast<std::size_t>(Screen::Error) + 1;
+constexpr std::size_t UI_MESSAGE_CAPACITY = 128;
+constexpr std::size_t UI_HISTORY_MAX = 32;
+
+// how a screen takes input
+enum class InputMode : unsigned char { Options, Value, Text, None };
+
+// toolkit-independent input; Char carries one printable character
+enum class UiKey : unsigned char { Up, Down, Left, Enter, Escape, Backspace, Char };
+
+struct UiEvent {
+    UiKey key = UiKey::Enter;
+    char  ch = 0;
+};
+
+/******************************************************************
+ * Struct: UiState
+ * ---------------------------------------------------------------
+ * Everything the calculator UI shows or has collected so far.
+ * Prompts, labels and static option lists point at constant
+ * tables; the message and summary live in fixed buffers, so
+ * moving between screens does not allocate. The typed answers are
+ * pmr strings on the session's arena (UiMachine's SessionArena),
+ * so they do not reach the global heap either.
+ ******************************************************************/
+struct UiState {
+    UiState() = default;
+    explicit UiState(std::pmr::memory_resource* session) noexcept
+        : textInput(session), topping(session), presetName(session) {}
+
+    Flow   flow = Flow::None;
+    Screen screen = Screen::MainMenu;
+    InputMode input = InputMode::None;
+    const char* prompt = "";
+    char message[UI_MESSAGE_CAPACITY] = {};
+    char summary[SUMMARY_CAPACITY] = {};
+
+    // selection list (static; LoadPresetList uses the machine's names)
+    const char* const* options = nullptr;
+    std::size_t optionCount = 0;
+    std::size_t selected = 0;
+
+    // numeric selection
+    double value = 0.0;
+    double step = 1.0;
+    double minValue = 0.0;
+    const char* valueLabel = "";
+
+    // text input
+    std::pmr::string textInput;
+
+    // captured inputs
+    DrinkType drinkType = DrinkType::Coffee;
+    Roast roastType = Roast::Light;
+    Strength coffeeStrength = Strength::Bolder;
+    double coffeeCups = 0.0;
+
+    Strength latteStrength = Strength::Stronger;
+    ShotSize latteShotSize = ShotSize::Single;
+    int latteShots = 0;
+    MilkStyle latteMilkStyle = MilkStyle::None;
+    double latteMilkRatio = 0.0;
+
+    // addons
+    bool isIced = false;
+    std::pmr::string topping;
+    int extraShots = 0;
+
+    // presets
+    std::pmr::string presetName;
+    Screen history[UI_HISTORY_MAX] = {};
+    std::size_t historySize = 0;
+
+    // stats (kept across returns to the main menu)
+    double dailyCaffeine = 0.0;
+    bool warningShown = false;
+};
+
+/******************************************************************
+ * Class: UiMachine
+ * ---------------------------------------------------------------
+ * Headless calculator UI. Each screen is one row of a flat table
+ * (prompt, input mode, options, enter and confirm handlers)
+ * indexed by Screen; handle() routes one key event through it.
+ * No toolkit types are involved, so the same machine drives the
+ * SFML front end, event replays and benchmarks.
+ *
+ * Each order session (main menu to main menu) draws its strings
+ * from one SessionArena, and resetToMenu() releases it whole.
+ ******************************************************************/
+class UiMachine {
+
+    public:
+
+        explicit UiMachine(PresetManager& presets);
+
+        UiMachine(const UiMachine&) = delete;
+        UiMachine& operator=(const UiMachine&) = delete;
+
+        // applies one event; returns false if it was ignored
+        bool handle(const UiEvent& event);
+
+        const UiState& state() const { return ui; }
+        std::size_t optionCount() const;
+        std::string_view option(std::size_t i) const;
+        bool hasMessage() const { return ui.message[0] != '\0'; }
+
+        // set when Quit is confirmed on the main menu
+        bool quitRequested() const { return quit; }
+        void clearQuit() { quit = false; }
+
+        // navigation and actions, used by the screen handlers
+        void goTo(Screen s);            // forward, remembers the current screen
+        void enterScreen(Screen s);     // configure s without touching history
+        void goBack();
+        void resetToMenu();
+        void setMessage(std::string_view text);
+        bool computeCoffee();
+        bool computeLatte();
+
+        UiState& mutableState() { return ui; }
+        const SessionArena& sessionArena() const { return session; }
+        PresetManager& presetManager() { return presets; }
+        std::vector<std::string_view>& presetNames() { return names; }
+        void requestQuit() { quit = true; }
+
+    private:
+
+        void confirm();
+        void recordDrink(const Order& order, const OrderResult& result);
+        void startSession();
+
+        SessionArena session;   // before ui, whose strings use it
+        UiState ui;
+        PresetManager& presets;
+        std::vector<std::string_view> names;   // LoadPresetList options
+        bool quit = false;
+};
+
+// the GUI summary layouts (differ from the console ones)
+void buildCoffeeSummary(SummaryWriter& out, const UiState& state, const CoffeeResult& r);
+void buildLatteSummary(SummaryWriter& out, const UiState& state, const LatteResult& r);
+
+#endif
@@ -0,0 +1,94 @@
+#include "addonRegistry.hpp"
+#include "constants.hpp"
+using namespace std;
+
+namespace {
+
+constexpr AddOnEffect NONE{};
+
+/******************************************************************
+ * The built-in menu. Adding a modifier is one row here: orders
+ * (as a flag), the console add-on prompts and the result math all
+ * pick it up. The first rows keep the ids in the header.
+ ******************************************************************/
+constexpr AddOnSpec ADDON_MENU[] = {
+    {"iced",           FOR_ANY,    NONE.scaled(Quantity::Water, ICED_WATER_FACTOR)
+                                       .scaled(Quantity::BrewRatio, ICED_BREW_FACTOR)},
+    {"extra-shot",     FOR_LATTE,  NONE.plus(Quantity::Shots, 1.0)},
+
+    // caffeine
+    {"decaf",          FOR_ANY,    NONE.scaled(Quantity::Caffeine, DECAF_CAFFEINE_FACTOR)},
+    {"half-caf",       FOR_ANY,    NONE.scaled(Quantity::Caffeine, 0.5)},
+
+    // brew
+    {"ristretto",      FOR_LATTE,  NONE.scaled(Quantity::BrewRatio, 0.75)},
+    {"lungo",          FOR_LATTE,  NONE.scaled(Quantity::BrewRatio, 1.5)},
+    {"strong",         FOR_COFFEE, NONE.scaled(Quantity::Grams, 1.15)
+                                       .scaled(Quantity::Caffeine, 1.15)},
+    {"mild",           FOR_COFFEE, NONE.scaled(Quantity::Grams, 0.85)
+                                       .scaled(Quantity::Caffeine, 0.85)},
+    {"short",          FOR_COFFEE, NONE.scaled(Quantity::Water, 0.8)
+                                       .scaled(Quantity::Grams, 0.8)
+                                       .scaled(Quantity::Caffeine, 0.8)},
+    {"americano-top",  FOR_COFFEE, NONE.plus(Quantity::Water, 60.0)},
+
+    // milk
+    {"extra-milk",     FOR_LATTE,  NONE.scaled(Quantity::Milk, 1.25)},
+    {"light-milk",     FOR_LATTE,  NONE.scaled(Quantity::Milk, 0.75)},
+    {"breve",          FOR_LATTE,  NONE},
+    {"extra-foam",     FOR_LATTE,  NONE.scaled(Quantity::Milk, 0.9)},
+
+    // flavours and toppings (no effect on volumes)
+    {"vanilla",        FOR_ANY,    NONE},
+    {"caramel",        FOR_ANY,    NONE},
+    {"hazelnut",       FOR_ANY,    NONE},
+    {"cinnamon",       FOR_ANY,    NONE},
+    {"whipped-cream",  FOR_ANY,    NONE},
+    {"chocolate",      FOR_ANY,    NONE.plus(Quantity::Caffeine, 5.0)},
+    {"extra-hot",      FOR_ANY,    NONE},
+};
+
+} // namespace
+
+AddOnId AddOnRegistry::add(const AddOnSpec& spec) {
+    if (!spec.name || !*spec.name || find(spec.name) != NO_ADDON || specs.size() >= NO_ADDON)
+        return NO_ADDON;
+    names.emplace_back(spec.name);
+    specs.push_back(spec);
+    specs.back().name = names.back().c_str();
+    return static_cast<AddOnId>(specs.size() - 1);
+}
+
+AddOnId AddOnRegistry::find(string_view name) const {
+    for (size_t i = 0; i < specs.size(); ++i) {
+        if (equalsIgnoreCase(name, specs[i].name)) return static_cast<AddOnId>(i);
+    }
+    return NO_ADDON;
+}
+
+/******************************************************************
+ * Function: AddOnRegistry::compile
+ * ---------------------------------------------------------------
+ * Folds the add-ons' coefficient vectors into one, skipping any
+ * that are unknown or not offered for the drink. Called per order
+ * (through a cache, see composeOrder), so it carries no probe.
+ ******************************************************************/
+AddOnEffect AddOnRegistry::compile(const AddOnId* ids, size_t count, DrinkType drink) const {
+    AddOnEffect fused;
+    for (size_t i = 0; i < count; ++i) {
+        if (appliesTo(ids[i], drink)) fused.then(specs[ids[i]].effect);
+    }
+    return fused;
+}
+
+const AddOnRegistry& defaultAddOns() {
+    static const AddOnRegistry registry = [] {
+        AddOnRegistry r;
+        for (const AddOnSpec& spec : ADDON_MENU) r.add(spec);
+        return r;
+    }();
+    return registry;
+}
+
+static_assert(ADDON_MENU[ADDON_ICED].drinks == FOR_ANY, "ADDON_ICED must be the first row");
+static_assert(ADDON_MENU[ADDON_EXTRA_SHOT].effect.offset[0] == 1.0, "ADDON_EXTRA_SHOT must add one shot");
@@ -1,35 +1,49 @@
 #include "addons.hpp"
-
-// --- Coffee Add-ons ---
-// --- Coffee Add-ons ---
-void applyCoffeeAddons(CoffeeResult& coffee, bool isIced, const std::string& topping) {
-    if (isIced) {
-        // Optional: reduce water slightly for ice
-        coffee.waterML *= 0.85;  // example adjustment
-        coffee.waterCups = coffee.waterML / ML_PER_CUP;
+#include "addonRegistry.hpp"
+#include "consoleInput.hpp"
+
+// lists the registry add-ons offered for the drink and adds the one typed
+static void chooseMenuAddOn(ConsoleInput& in, DrinkComposition& drink) {
+    const AddOnRegistry& menu = defaultAddOns();
+    cout << "Available:";
+    for (AddOnId id = 0; id < menu.size(); ++id) {
+        if (id != ADDON_ICED && id != ADDON_EXTRA_SHOT && menu.appliesTo(id, drink.drinkType()))
+            cout << ' ' << menu.spec(id).name;
     }
-    // Topping is just for display/record, doesn't change physics here
-    // but we could store it if CoffeeResult had a field for it.
-    // For now, GUI handles display separately.
+    cout << "\nEnter add-on: ";
+
+    AddOnId id = menu.find(in.word());
+    if (id != NO_ADDON && menu.appliesTo(id, drink.drinkType())) {
+        drink.addAddOn(id);
+        cout << "Added " << menu.spec(id).name << ".\n";
+    } else {
+        cout << "Unknown add-on.\n";
+    }
+}
+
+// toppings that are also menu add-ons (chocolate, cinnamon, ...) count as one
+static void addTopping(DrinkComposition& drink, string_view topping) {
+    AddOnId id = defaultAddOns().find(topping);
+    if (id != NO_ADDON) drink.addAddOn(id);
 }
 
-void handleCoffeeAddOns(CoffeeResult& coffee) {
-    char addOns;
+// --- Coffee Add-ons ---
+void handleCoffeeAddOns(ConsoleInput& in, DrinkComposition& coffee) {
     cout << "\nDo you want add-ons for your coffee? (y/n): ";
-    cin >> addOns;
-    addOns = tolower(addOns);
+    char addOns = in.letter();
 
     if (addOns != 'y') return;
 
-    int choice;
+    int choice = 0;
     cout << "\n--- Coffee Add-ons Menu ---\n";
     cout << "1) Add Ice (cold drink)\n";
     cout << "2) Toppings\n";
+    cout << "3) Other (decaf, strong, ...)\n";
     cout << "Enter your choice: ";
-    cin >> choice;
+    in.number(choice);
 
     bool isIced = false;
-    string topping;
+    string_view topping;
 
     switch(choice) {
         case 1:
@@ -38,75 +52,44 @@ void handleCoffeeAddOns(CoffeeResult& coffee) {
             break;
         case 2: {
             cout << "Enter topping type (whipped cream, cinnamon, chocolate): ";
-            cin >> topping;
+            topping = in.word();
             cout << "Added " << topping << " to your coffee!\n";
+            addTopping(coffee, topping);
             break;
         }
+        case 3:
+            chooseMenuAddOn(in, coffee);
+            break;
         default:
             cout << "Invalid choice.\n";
     }
-    applyCoffeeAddons(coffee, isIced, topping);
+    if (isIced) coffee.addAddOn(ADDON_ICED);
 }
 
 // --- Latte Add-ons ---
-void applyLatteAddons(LatteResult& latte, bool isIced, int extraShots, const std::string& topping) {
-    if (extraShots > 0) {
-        latte.shots += extraShots;
-
-        // Recalculate espresso
-        double gramsPerShot = (latte.shotSize == "single") ? 8.0 : 16.0;
-        latte.coffeeGrams = latte.shots * gramsPerShot;
-        latte.espressoML = latte.coffeeGrams * latte.brewRatio;
-        latte.espressoCups = latte.espressoML / ML_PER_CUP;
-
-        // Update milk if exists
-        if (latte.hasMilkTarget) {
-            latte.milkML = latte.espressoML * latte.milkToEspRatio;
-            latte.milkCups = latte.milkML / ML_PER_CUP;
-            latte.finalML = latte.espressoML + latte.milkML;
-            latte.finalCups = latte.finalML / ML_PER_CUP;
-        }
-    }
-
-    if (isIced) {
-        // Optional: reduce espresso/milk ratio for cold drink
-        latte.brewRatio *= 0.8;
-        latte.espressoML = latte.coffeeGrams * latte.brewRatio;
-        latte.espressoCups = latte.espressoML / ML_PER_CUP;
-
-        if (latte.hasMilkTarget) {
-            latte.milkML = latte.espressoML * latte.milkToEspRatio;
-            latte.milkCups = latte.milkML / ML_PER_CUP;
-            latte.finalML = latte.espressoML + latte.milkML;
-            latte.finalCups = latte.finalML / ML_PER_CUP;
-        }
-    }
-}
-
-void handleLatteAddOns(LatteResult& latte) {
-    char addOns;
+void handleLatteAddOns(ConsoleInput& in, DrinkComposition& latte) {
     cout << "\nDo you want add-ons for your latte? (y/n): ";
-    cin >> addOns;
-    addOns = tolower(addOns);
+    char addOns = in.letter();
 
     if (addOns != 'y') return;
 
-    int choice;
+    int choice = 0;
     cout << "\n--- Latte Add-ons Menu ---\n";
     cout << "1) Extra Espresso Shots\n";
     cout << "2) Add Ice (cold latte)\n";
     cout << "3) Toppings\n";
+    cout << "4) Other (decaf, ristretto, extra-milk, ...)\n";
     cout << "Enter your choice: ";
-    cin >> choice;
+    in.number(choice);
 
     bool isIced = false;
     int extraShots = 0;
-    string topping;
+    string_view topping;
 
     switch(choice) {
         case 1: {
             cout << "How many extra shots? ";
-            cin >> extraShots;
+            in.number(extraShots);
             break;
         }
         case 2:
@@ -115,12 +98,17 @@ void handleLatteAddOns(LatteResult& latte) {
             break;
         case 3: {
             cout << "Enter topping type (whipped cream, cinnamon, chocolate): ";
-            cin >> topping;
+            topping = in.word();
             cout << "Added " << topping << " to your latte!\n";
+            addTopping(latte, topping);
             break;
         }
+        case 4:
+            chooseMenuAddOn(in, latte);
+            break;
         default:
             cout << "Invalid choice.\n";
     }
-    applyLatteAddons(latte, isIced, extraShots, topping);
+    if (isIced) latte.addAddOn(ADDON_ICED);
+    if (extraShots > 0) latte.addExtraShots(extraShots);
 }
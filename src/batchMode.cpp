@@ -0,0 +1,367 @@
+#include "batchMode.hpp"
+#include "fixedRecipe.hpp"
+#include "instrumentation.hpp"
+#include "inventoryForecast.hpp"
+#include "menuTable.hpp"
+#include "orderAnalytics.hpp"
+#include "orderPipeline.hpp"
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr size_t READ_CHUNK = 1 << 20;
+constexpr size_t MEMORY_START = 64 * 1024;
+
+// longest to_chars output: sign and 19 digits; sign, 309 digits, point and 2 decimals
+constexpr size_t INT_MAX_CHARS = 24;
+constexpr size_t FIXED2_MAX_CHARS = 320;
+
+long readSome(int fd, char* dst, size_t len) {
+#ifdef _WIN32
+    return _read(fd, dst, static_cast<unsigned>(len));
+#else
+    return static_cast<long>(::read(fd, dst, len));
+#endif
+}
+
+bool writeAll(int fd, const char* src, size_t len) {
+    while (len > 0) {
+#ifdef _WIN32
+        long n = _write(fd, src, static_cast<unsigned>(len));
+#else
+        long n = static_cast<long>(::write(fd, src, len));
+#endif
+        if (n <= 0) return false;
+        src += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int openInput(const string& path) {
+    if (path.empty() || path == "-") return 0;
+#ifdef _WIN32
+    return _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+    return ::open(path.c_str(), O_RDONLY);
+#endif
+}
+
+void closeInput(int fd) {
+    if (fd <= 0) return;
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+}
+
+} // namespace
+
+OutputBuffer::OutputBuffer(int fd, size_t capacity)
+    : fd(fd), data(new char[capacity]), capacity(capacity) {}
+
+OutputBuffer::OutputBuffer()
+    : fd(-1), data(new char[MEMORY_START]), capacity(MEMORY_START) {}
+
+OutputBuffer::~OutputBuffer() {
+    flush();
+    delete[] data;
+}
+
+// memory mode grows the block; fd mode drains it (so at most capacity bytes)
+void OutputBuffer::reserve(size_t n) {
+    if (capacity - used >= n) return;
+    if (fd >= 0) {
+        flush();
+        return;
+    }
+    size_t grown = capacity * 2;
+    while (grown - used < n) grown *= 2;
+    char* bigger = new char[grown];
+    memcpy(bigger, data, used);
+    delete[] data;
+    data = bigger;
+    capacity = grown;
+}
+
+void OutputBuffer::append(string_view s) {
+    if (s.size() > capacity - used) {
+        if (fd < 0) {
+            reserve(s.size());
+        } else {
+            flush();
+            if (s.size() > capacity) {
+                writeFailed |= !writeAll(fd, s.data(), s.size());
+                return;
+            }
+        }
+    }
+    memcpy(data + used, s.data(), s.size());
+    used += s.size();
+}
+
+void OutputBuffer::append(char c) {
+    reserve(1);
+    data[used++] = c;
+}
+
+// formatted in place; through a local buffer if an fd buffer is smaller than that
+void OutputBuffer::appendInt(long long v) {
+    reserve(INT_MAX_CHARS);
+    auto res = to_chars(data + used, data + capacity, v);
+    if (res.ec == errc()) {
+        used = static_cast<size_t>(res.ptr - data);
+        return;
+    }
+    char text[INT_MAX_CHARS];
+    res = to_chars(text, text + sizeof text, v);
+    append(string_view(text, static_cast<size_t>(res.ptr - text)));
+}
+
+void OutputBuffer::appendFixed2(double v) {
+    reserve(FIXED2_MAX_CHARS);
+    auto res = to_chars(data + used, data + capacity, v, chars_format::fixed, 2);
+    if (res.ec == errc()) {
+        used = static_cast<size_t>(res.ptr - data);
+        return;
+    }
+    char text[FIXED2_MAX_CHARS];
+    res = to_chars(text, text + sizeof text, v, chars_format::fixed, 2);
+    append(string_view(text, static_cast<size_t>(res.ptr - text)));
+}
+
+bool OutputBuffer::flush() {
+    if (fd < 0) return true;
+    bool ok = writeAll(fd, data, used);
+    used = 0;
+    writeFailed |= !ok;
+    return ok;
+}
+
+void writeOrderHeader(OutputBuffer& out, OutputFormat format) {
+    if (format == OutputFormat::Csv)
+        out.append("line,drink,status,ratio,coffee_g,tbsp,water_ml,espresso_ml,milk_ml,final_ml,error\n");
+}
+
+/******************************************************************
+ * Function: writeOrderRow
+ * ---------------------------------------------------------------
+ * Appends one result as a CSV row or a JSON object line. Coffee
+ * rows report water; latte rows report espresso, milk and final
+ * volume. ratio is the brew ratio of either drink.
+ ******************************************************************/
+void writeOrderRow(OutputBuffer& out, OutputFormat format, size_t lineNo,
+                   const OrderResult& result, const char* error) {
+    bool ok = result.ok && !error;
+    bool coffee = result.drink == DrinkType::Coffee;
+    const CoffeeResult& c = result.coffee;
+    const LatteResult& l = result.latte;
+
+    if (format == OutputFormat::Csv) {
+        out.appendInt(static_cast<long long>(lineNo));
+        if (!ok) {
+            out.append(",,error,,,,,,,,\"");
+            out.append(error ? error : "calculation error");
+            out.append("\"\n");
+            return;
+        }
+        out.append(coffee ? ",coffee,ok," : ",latte,ok,");
+        out.appendFixed2(coffee ? c.ratio : l.brewRatio);         out.append(',');
+        out.appendFixed2(coffee ? c.coffeeGrams : l.coffeeGrams); out.append(',');
+        out.appendFixed2(coffee ? c.tablespoons : l.tablespoons); out.append(',');
+        out.appendFixed2(coffee ? c.waterML : 0.0);               out.append(',');
+        out.appendFixed2(coffee ? 0.0 : l.espressoML);            out.append(',');
+        out.appendFixed2(coffee ? 0.0 : l.milkML);                out.append(',');
+        out.appendFixed2(coffee ? c.waterML : (l.hasMilkTarget ? l.finalML : l.espressoML));
+        out.append(",\n");
+        return;
+    }
+
+    out.append("{\"line\":");
+    out.appendInt(static_cast<long long>(lineNo));
+    if (!ok) {
+        out.append(",\"ok\":false,\"error\":\"");
+        out.append(error ? error : "calculation error");
+        out.append("\"}\n");
+        return;
+    }
+    if (coffee) {
+        out.append(",\"drink\":\"coffee\",\"ok\":true,\"ratio\":");
+        out.appendFixed2(c.ratio);
+        out.append(",\"coffee_g\":");  out.appendFixed2(c.coffeeGrams);
+        out.append(",\"tbsp\":");      out.appendFixed2(c.tablespoons);
+        out.append(",\"water_ml\":");  out.appendFixed2(c.waterML);
+    } else {
+        out.append(",\"drink\":\"latte\",\"ok\":true,\"ratio\":");
+        out.appendFixed2(l.brewRatio);
+        out.append(",\"shots\":");        out.appendInt(l.shots);
+        out.append(",\"coffee_g\":");     out.appendFixed2(l.coffeeGrams);
+        out.append(",\"tbsp\":");         out.appendFixed2(l.tablespoons);
+        out.append(",\"espresso_ml\":");  out.appendFixed2(l.espressoML);
+        out.append(",\"milk_ml\":");      out.appendFixed2(l.milkML);
+        out.append(",\"final_ml\":");
+        out.appendFixed2(l.hasMilkTarget ? l.finalML : l.espressoML);
+    }
+    out.append("}\n");
+}
+
+/******************************************************************
+ * Function: processRecords
+ * ---------------------------------------------------------------
+ * Runs every record in a block of whole lines through parse ->
+ * calc -> add-ons -> format. Each line ends in '\n' except
+ * possibly the last one. Standard orders are answered from
+ * sharedMenuTable(), the rest are computed; with the fixed-point
+ * engine every order is computed by computeOrderFixed (the table
+ * holds double results). Shared by the single-threaded loop and the
+ * pipeline workers. Valid orders are also recorded in
+ * sharedAnalytics() (untimed records count as processed now).
+ *
+ * Parameters:
+ *   text      - the records
+ *   firstLine - line number of the first record (1-based)
+ *   out       - rows are appended here
+ *   counts    - processed / failed totals are added here
+ *   inventory - optional; valid orders are consumed from it
+ *   engine    - double or fixed-point recipe math
+ *
+ * Returns:
+ *   number of lines in text.
+ ******************************************************************/
+size_t processRecords(string_view text, size_t firstLine, OutputBuffer& out,
+                      OutputFormat format, BatchCounts& counts, InventoryForecast* inventory,
+                      CalcEngine engine) {
+    PROBE_SCOPE("batch.block");
+    Order order;
+    OrderResult result;
+    size_t lineNo = firstLine;
+    size_t start = 0;
+    OrderAnalytics& analytics = sharedAnalytics();
+    const MenuTable& menu = sharedMenuTable();
+    int64_t now = analyticsNow();
+
+    while (start < text.size()) {
+        const void* nl = memchr(text.data() + start, '\n', text.size() - start);
+        size_t end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - text.data())
+                        : text.size();
+        string_view line = text.substr(start, end - start);
+        start = end + 1;
+
+        if (!isSkippableLine(line)) {
+            const char* error = nullptr;
+            if (parseOrderLine(line, order, error)) {
+                if (engine == CalcEngine::Fixed) computeOrderFixed(order, result);
+                else computeOrderFromMenu(order, result, menu);
+                recordOrder(analytics, order, result, now);
+                if (inventory) inventory->consume(order.time ? order.time : now, result);
+            } else {
+                result.ok = false;
+            }
+            writeOrderRow(out, format, lineNo, result, error);
+            ++counts.processed;
+            counts.failed += !(result.ok && !error);
+        }
+        ++lineNo;
+    }
+    PROBE_COUNT("batch.lines", lineNo - firstLine);
+    return lineNo - firstLine;
+}
+
+/******************************************************************
+ * Function: runBatch
+ * ---------------------------------------------------------------
+ * Streams newline-delimited order records from a file or stdin
+ * in 1 MiB reads and writes one output row per record to stdout.
+ * Blank and '#' lines are skipped (but still counted for line
+ * numbers). With more than one thread the work goes through
+ * runPipeline; output is identical either way. A summary goes to
+ * stderr.
+ *
+ * Returns:
+ *   0 on success, 1 if the input cannot be opened or read or the
+ *   output cannot be written.
+ ******************************************************************/
+int runBatch(const BatchOptions& options) {
+    int in = openInput(options.inputPath);
+    if (in < 0) {
+        cerr << "batch: cannot open " << options.inputPath << "\n";
+        return 1;
+    }
+
+    if (!options.menuPath.empty() && !sharedMenuTable().load(options.menuPath))
+        cerr << "batch: menu table " << options.menuPath << " is missing or stale; using the built-in one\n";
+
+    OutputBuffer out(1);
+    writeOrderHeader(out, options.format);
+
+    BatchCounts counts;
+    bool ioError = false;
+    InventoryForecast forecast;
+    forecast.restock(Ingredient::Beans, options.beansStockG);
+    forecast.restock(Ingredient::Milk, options.milkStockML);
+    InventoryForecast* inventory = options.inventory ? &forecast : nullptr;
+    unsigned threads = resolveThreadCount(options.threads);
+
+    if (threads > 1) {
+        ioError = !out.flush();
+        PipelineOptions pipeline;
+        pipeline.threads = threads;
+        pipeline.engine = options.engine;
+        ioError |= !runPipeline(
+            [in](char* dst, size_t len) { return readSome(in, dst, len); },
+            [](const char* src, size_t len) { return writeAll(1, src, len); },
+            options.format, pipeline, counts, inventory);
+    } else {
+        vector<char> buf(READ_CHUNK);
+        size_t carry = 0;
+        size_t lineNo = 1;
+
+        for (;;) {
+            if (carry == buf.size()) buf.resize(buf.size() * 2);   // very long line
+            long n = readSome(in, buf.data() + carry, buf.size() - carry);
+            if (n < 0) { ioError = true; break; }
+            if (n == 0) break;
+
+            size_t end = carry + static_cast<size_t>(n);
+            size_t last = string_view(buf.data(), end).rfind('\n');
+            if (last == string_view::npos) { carry = end; continue; }
+
+            size_t whole = last + 1;
+            lineNo += processRecords(string_view(buf.data(), whole), lineNo,
+                                     out, options.format, counts, inventory, options.engine);
+            carry = end - whole;
+            memmove(buf.data(), buf.data() + whole, carry);
+        }
+        if (carry > 0)
+            processRecords(string_view(buf.data(), carry), lineNo, out, options.format, counts,
+                           inventory, options.engine);
+    }
+
+    if (!out.flush() || out.failed()) ioError = true;
+    closeInput(in);
+
+    cerr << "batch: " << counts.processed << " orders, " << counts.failed << " invalid";
+    if (threads > 1) cerr << " (" << threads << " threads)";
+    cerr << "\n";
+    if (options.stats) printAnalytics(sharedAnalytics(), analyticsNow(), cerr);
+    if (inventory) printForecast(*inventory, cerr);
+    if (ioError) {
+        cerr << "batch: I/O error\n";
+        return 1;
+    }
+    return 0;
+}
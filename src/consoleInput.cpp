@@ -0,0 +1,139 @@
+#include "consoleInput.hpp"
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+bool isBlank(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+template <typename T>
+bool parseWhole(string_view w, T& out) {
+    if (!w.empty() && w.front() == '+') w.remove_prefix(1);   // cin accepts a leading '+'
+    if (w.empty()) return false;
+    auto res = from_chars(w.data(), w.data() + w.size(), out);
+    return res.ec == errc() && res.ptr == w.data() + w.size();
+}
+
+} // namespace
+
+bool parseNumber(string_view word, int& out) { return parseWhole(word, out); }
+
+bool parseNumber(string_view word, double& out) { return parseWhole(word, out); }
+
+ConsoleInput::ConsoleInput(int fd, size_t capacity) : fd(fd), buf(capacity) {}
+
+/******************************************************************
+ * Function: ConsoleInput::fill
+ * ---------------------------------------------------------------
+ * Keeps the unread bytes, moved to the front of the buffer (so a
+ * word can grow across reads), and appends one read's worth. The
+ * buffer doubles if a single word fills it.
+ ******************************************************************/
+bool ConsoleInput::fill() {
+    if (ended) return false;
+    cout.flush();
+
+    if (pos > 0) {
+        memmove(buf.data(), buf.data() + pos, len - pos);
+        len -= pos;
+        pos = 0;
+    }
+    if (len == buf.size()) buf.resize(buf.size() * 2);
+
+    long n;
+#ifdef _WIN32
+    n = _read(fd, buf.data() + len, static_cast<unsigned>(buf.size() - len));
+#else
+    n = static_cast<long>(::read(fd, buf.data() + len, buf.size() - len));
+#endif
+    if (n <= 0) {
+        ended = true;
+        return false;
+    }
+    len += static_cast<size_t>(n);
+    return true;
+}
+
+bool ConsoleInput::skipBlanks() {
+    for (;;) {
+        while (pos < len && isBlank(buf[pos])) ++pos;
+        if (pos < len) return true;
+        if (!fill()) return false;
+    }
+}
+
+string_view ConsoleInput::word() {
+    if (!skipBlanks()) return string_view();
+    size_t end = pos;
+    for (;;) {
+        while (end < len && !isBlank(buf[end])) ++end;
+        if (end < len) break;
+        size_t start = pos;
+        if (!fill()) break;
+        end -= start;   // fill() moved the word to the front
+    }
+    string_view w(buf.data() + pos, end - pos);
+    pos = end;
+    return w;
+}
+
+char ConsoleInput::letter() {
+    if (!skipBlanks()) return '\0';
+    return static_cast<char>(tolower(static_cast<unsigned char>(buf[pos++])));
+}
+
+bool ConsoleInput::number(int& out) {
+    if (parseNumber(word(), out)) return true;
+    skipLine();
+    return false;
+}
+
+bool ConsoleInput::number(double& out) {
+    if (parseNumber(word(), out)) return true;
+    skipLine();
+    return false;
+}
+
+void ConsoleInput::skipLine() {
+    for (;;) {
+        const void* nl = memchr(buf.data() + pos, '\n', len - pos);
+        if (nl) {
+            pos = static_cast<size_t>(static_cast<const char*>(nl) - buf.data()) + 1;
+            return;
+        }
+        pos = len;
+        if (!fill()) return;
+    }
+}
+
+bool ConsoleInput::atEnd() {
+    return !skipBlanks();
+}
+
+ConsoleInput& consoleIn() {
+    static ConsoleInput in(0);
+    return in;
+}
+
+char promptYesNo(ConsoleInput& in, const char* prompt, const char* error) {
+    cout << prompt;
+    char c = in.letter();
+    while (c != 'y' && c != 'n') {
+        if (c == '\0') return 'n';
+        in.skipLine();
+        cout << error;
+        c = in.letter();
+    }
+    return c;
+}
@@ -0,0 +1,121 @@
+#include "drinkComposition.hpp"
+#include "constants.hpp"
+#include "recipeKernels.hpp"
+#include <cmath>
+using namespace std;
+
+bool wholeShots(double shots, int& out) {
+    if (!isfinite(shots)) return false;
+    double rounded = shots < 0.0 ? shots - 0.5 : shots + 0.5;
+    if (fabs(rounded) >= MAX_TOTAL_SHOTS + 1.0) return false;   // truncates past the limit
+    out = static_cast<int>(rounded);
+    return true;
+}
+
+void DrinkComposition::setCoffee(Strength strength, Roast roast, double cups) {
+    base = Base();
+    base.drink = DrinkType::Coffee;
+    base.strength = strength;
+    base.roast = roast;
+    base.cups = cups;
+}
+
+void DrinkComposition::setLatte(Strength strength, ShotSize shotSize, int shots) {
+    base = Base();
+    base.drink = DrinkType::Latte;
+    base.strength = strength;
+    base.shotSize = shotSize;
+    base.shots = shots;
+}
+
+void DrinkComposition::addExtraShots(int count) {
+    if (count > 0 && base.drink == DrinkType::Latte)
+        addons.then(AddOnEffect().plus(Quantity::Shots, count));
+}
+
+void DrinkComposition::setMilkTarget(MilkStyle style, double ratio) {
+    milk.style = style;
+    milk.ratio = (style == MilkStyle::None) ? 0.0 : ratio;
+}
+
+bool DrinkComposition::valid() const {
+    if (base.drink == DrinkType::Coffee)
+        return base.cups > 0.0 && COFFEE_RECIPES(base.strength, base.roast).ratio != 0.0;
+    return base.shots > 0 && LATTE_RECIPES(base.shotSize, base.strength).brewRatio != 0.0;
+}
+
+bool DrinkComposition::totalShots(int& out) const {
+    return wholeShots(addons.apply(Quantity::Shots, base.shots), out);
+}
+
+/******************************************************************
+ * Function: DrinkComposition::evaluate (coffee)
+ * ---------------------------------------------------------------
+ * Base recipe, then the fused add-on coefficients for grounds and
+ * water. Untouched quantities keep the recipe's values exactly.
+ ******************************************************************/
+bool DrinkComposition::evaluate(CoffeeResult& out) const {
+    if (base.drink != DrinkType::Coffee) return false;
+    if (!calcCoffee(base.strength, base.roast, base.cups, out)) return false;
+
+    if (!addons.isIdentity(Quantity::Grams)) {
+        out.coffeeGrams = addons.apply(Quantity::Grams, out.coffeeGrams);
+        out.tablespoons = out.coffeeGrams / GRAMS_PER_TBSP;
+    }
+    if (!addons.isIdentity(Quantity::Water)) {
+        out.waterML = addons.apply(Quantity::Water, out.waterML);
+        out.waterCups = out.waterML / ML_PER_CUP;
+    }
+    return true;
+}
+
+/******************************************************************
+ * Function: DrinkComposition::evaluate (latte)
+ * ---------------------------------------------------------------
+ * One pass: added shots join the base shots before the recipe is
+ * applied (so grounds, tablespoons and espresso all include them),
+ * then grounds and brew ratio take their coefficients, and the
+ * milk target is sized from the final espresso volume.
+ ******************************************************************/
+bool DrinkComposition::evaluate(LatteResult& out) const {
+    if (base.drink != DrinkType::Latte) return false;
+    int shots;
+    if (base.shots <= 0 || !totalShots(shots)) return false;
+    if (!calcLatteFromShots(base.strength, base.shotSize, shots, out)) return false;
+
+    bool grams = !addons.isIdentity(Quantity::Grams);
+    if (grams) {
+        out.coffeeGrams = addons.apply(Quantity::Grams, out.coffeeGrams);
+        out.tablespoons = out.coffeeGrams / GRAMS_PER_TBSP;
+    }
+    if (grams || !addons.isIdentity(Quantity::BrewRatio)) {
+        out.brewRatio = addons.apply(Quantity::BrewRatio, out.brewRatio);
+        out.espressoML = out.coffeeGrams * out.brewRatio;
+        out.espressoCups = out.espressoML / ML_PER_CUP;
+    }
+
+    if (milk.style != MilkStyle::None) {
+        out.hasMilkTarget = true;
+        out.milkStyle = milk.style;
+        out.milkToEspRatio = milk.ratio;
+        out.milkML = addons.apply(Quantity::Milk, out.espressoML * milk.ratio);
+        out.milkCups = out.milkML / ML_PER_CUP;
+        out.finalML = out.espressoML + out.milkML;
+        out.finalCups = out.finalML / ML_PER_CUP;
+    }
+    return true;
+}
+
+// brewed coffee by the cup, espresso by the (single-shot) gram; 0 if it cannot be made
+double DrinkComposition::caffeineMg() const {
+    double mg;
+    if (base.drink == DrinkType::Coffee) {
+        mg = base.cups * CAFFEINE_PER_CUP_COFFEE;
+    } else {
+        int shots;
+        if (!totalShots(shots)) return 0.0;
+        double singles = GRAMS_PER_SHOT[indexOf(base.shotSize)] / GRAMS_PER_SHOT[indexOf(ShotSize::Single)];
+        mg = shots * singles * CAFFEINE_PER_SINGLE_SHOT;
+    }
+    return addons.apply(Quantity::Caffeine, mg);
+}
@@ -0,0 +1,93 @@
+#include "drinkTypes.hpp"
+#include <cctype>
+using namespace std;
+
+namespace {
+
+template <typename E>
+struct Keyword {
+    string_view word;
+    E value;
+};
+
+// Keyword tables: every accepted spelling maps to one enum value.
+// The first entry for a value is its canonical name.
+constexpr Keyword<DrinkType> DRINK_KEYWORDS[] = {
+    {"coffee", DrinkType::Coffee},
+    {"latte",  DrinkType::Latte},
+};
+
+constexpr Keyword<Roast> ROAST_KEYWORDS[] = {
+    {"light",  Roast::Light},
+    {"medium", Roast::Medium},
+    {"dark",   Roast::Dark},
+};
+
+constexpr Keyword<Strength> STRENGTH_KEYWORDS[] = {
+    {"bolder",   Strength::Bolder},
+    {"medium",   Strength::Medium},
+    {"weaker",   Strength::Weaker},
+    {"stronger", Strength::Stronger},
+};
+
+constexpr Keyword<ShotSize> SHOT_SIZE_KEYWORDS[] = {
+    {"single", ShotSize::Single},
+    {"double", ShotSize::Double},
+};
+
+constexpr Keyword<MilkStyle> MILK_STYLE_KEYWORDS[] = {
+    {"none",       MilkStyle::None},
+    {"cortado",    MilkStyle::Cortado},
+    {"flatwhite",  MilkStyle::FlatWhite},
+    {"flat_white", MilkStyle::FlatWhite},
+    {"latte",      MilkStyle::Latte},
+    {"custom",     MilkStyle::Custom},
+};
+
+/******************************************************************
+ * Function: matchKeyword
+ * ---------------------------------------------------------------
+ * Shared table-driven parser behind every parseXxx function.
+ * Table words are lowercase; input is compared case-insensitively.
+ ******************************************************************/
+template <typename E, size_t N>
+bool matchKeyword(string_view in, const Keyword<E> (&table)[N], E& out) {
+    for (const auto& k : table) {
+        if (equalsIgnoreCase(in, k.word)) {
+            out = k.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename E, size_t N>
+const char* nameOf(E value, const Keyword<E> (&table)[N]) {
+    for (const auto& k : table) {
+        if (k.value == value) return k.word.data();
+    }
+    return "";
+}
+
+} // namespace
+
+bool equalsIgnoreCase(string_view a, string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (tolower(static_cast<unsigned char>(a[i])) != tolower(static_cast<unsigned char>(b[i])))
+            return false;
+    }
+    return true;
+}
+
+bool parseDrinkType(string_view in, DrinkType& out) { return matchKeyword(in, DRINK_KEYWORDS, out); }
+bool parseRoast(string_view in, Roast& out)         { return matchKeyword(in, ROAST_KEYWORDS, out); }
+bool parseStrength(string_view in, Strength& out)   { return matchKeyword(in, STRENGTH_KEYWORDS, out); }
+bool parseShotSize(string_view in, ShotSize& out)   { return matchKeyword(in, SHOT_SIZE_KEYWORDS, out); }
+bool parseMilkStyle(string_view in, MilkStyle& out) { return matchKeyword(in, MILK_STYLE_KEYWORDS, out); }
+
+const char* toString(DrinkType d) { return nameOf(d, DRINK_KEYWORDS); }
+const char* toString(Roast r)     { return nameOf(r, ROAST_KEYWORDS); }
+const char* toString(Strength s)  { return nameOf(s, STRENGTH_KEYWORDS); }
+const char* toString(ShotSize s)  { return nameOf(s, SHOT_SIZE_KEYWORDS); }
+const char* toString(MilkStyle m) { return nameOf(m, MILK_STYLE_KEYWORDS); }
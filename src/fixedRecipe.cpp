@@ -0,0 +1,280 @@
+#include "fixedRecipe.hpp"
+#include <vector>
+#include "constants.hpp"
+#include "drinkComposition.hpp"
+#include "instrumentation.hpp"
+#include "recipeKernels.hpp"
+using namespace std;
+
+namespace {
+
+/******************************************************************
+ * Recipe factors in Q32.32, from the same COFFEE_RECIPES and
+ * LATTE_RECIPES rows the double path uses. Coffee keeps its ratio
+ * as a divisor (grounds = water / ratio); every latte factor is a
+ * whole number or a binary fraction, so it converts exactly.
+ ******************************************************************/
+struct FixedCoffeeRecipe {
+    bool         valid = false;
+    FixedDivisor ratio;
+};
+
+struct FixedLatteRecipe {
+    bool  valid = false;
+    Fixed gramsPerShot = 0;
+    Fixed brewRatio = 0;
+    Fixed espressoMLPerShot = 0;
+    Fixed caffeinePerShot = 0;
+};
+
+struct FixedRecipeTables {
+    FixedCoffeeRecipe coffee[STRENGTH_COUNT][ROAST_COUNT];
+    FixedLatteRecipe  latte[SHOT_SIZE_COUNT][STRENGTH_COUNT];
+
+    constexpr FixedRecipeTables() : coffee{}, latte{} {
+        for (size_t s = 0; s < STRENGTH_COUNT; ++s) {
+            for (size_t r = 0; r < ROAST_COUNT; ++r) {
+                const CoffeeRecipe& rec = COFFEE_RECIPES.entry[s][r];
+                if (rec.ratio == 0.0) continue;
+                coffee[s][r].valid = true;
+                coffee[s][r].ratio = FixedDivisor(static_cast<uint64_t>(rec.ratio));
+            }
+        }
+        double singleGrams = GRAMS_PER_SHOT[indexOf(ShotSize::Single)];
+        for (size_t z = 0; z < SHOT_SIZE_COUNT; ++z) {
+            for (size_t s = 0; s < STRENGTH_COUNT; ++s) {
+                const LatteRecipe& rec = LATTE_RECIPES.entry[z][s];
+                if (rec.brewRatio == 0.0) continue;
+                FixedLatteRecipe& out = latte[z][s];
+                out.valid = true;
+                out.gramsPerShot = toFixed(rec.gramsPerShot);
+                out.brewRatio = toFixed(rec.brewRatio);
+                out.espressoMLPerShot = toFixed(rec.espressoMLPerShot);
+                out.caffeinePerShot = toFixed(rec.gramsPerShot / singleGrams * CAFFEINE_PER_SINGLE_SHOT);
+            }
+        }
+    }
+
+    // every factor is a whole divisor or exact in binary
+    constexpr bool exact() const {
+        for (size_t s = 0; s < STRENGTH_COUNT; ++s) {
+            for (size_t r = 0; r < ROAST_COUNT; ++r) {
+                double ratio = COFFEE_RECIPES.entry[s][r].ratio;
+                if (ratio != 0.0 && (ratio < 1.0 || ratio > 256.0 ||
+                                     static_cast<double>(coffee[s][r].ratio.d) != ratio))
+                    return false;
+            }
+        }
+        for (size_t z = 0; z < SHOT_SIZE_COUNT; ++z) {
+            for (size_t s = 0; s < STRENGTH_COUNT; ++s) {
+                const LatteRecipe& rec = LATTE_RECIPES.entry[z][s];
+                const FixedLatteRecipe& f = latte[z][s];
+                if (rec.brewRatio != 0.0 && (toDouble(f.gramsPerShot) != rec.gramsPerShot ||
+                                             toDouble(f.brewRatio) != rec.brewRatio ||
+                                             toDouble(f.espressoMLPerShot) != rec.espressoMLPerShot))
+                    return false;
+            }
+        }
+        return true;
+    }
+};
+
+constexpr FixedRecipeTables FIXED_RECIPES{};
+static_assert(FIXED_RECIPES.exact(), "recipe factors must convert to fixed point exactly");
+
+constexpr Fixed FIXED_CAFFEINE_PER_CUP = toFixed(CAFFEINE_PER_CUP_COFFEE);
+constexpr Fixed FIXED_ML_PER_CUP = toFixed(ML_PER_CUP);
+constexpr FixedDivisor CUP_DIVISOR(static_cast<uint64_t>(ML_PER_CUP));
+constexpr FixedDivisor TBSP_DIVISOR(static_cast<uint64_t>(GRAMS_PER_TBSP));
+static_assert(ML_PER_CUP == 240.0 && GRAMS_PER_TBSP == 16.0, "whole-number unit divisors");
+
+/******************************************************************
+ * The default add-on menu in Q32.32, built once. An add-on whose
+ * coefficients do not fit is marked, and orders using it take the
+ * double path.
+ ******************************************************************/
+struct FixedAddOnMenu {
+    vector<FixedEffect>   effect;
+    vector<unsigned char> fits;
+};
+
+const FixedAddOnMenu& fixedAddOns() {
+    static const FixedAddOnMenu menu = [] {
+        const AddOnRegistry& registry = defaultAddOns();
+        FixedAddOnMenu m;
+        m.effect.resize(registry.size());
+        m.fits.resize(registry.size());
+        for (size_t i = 0; i < registry.size(); ++i)
+            m.fits[i] = toFixedEffect(registry.spec(static_cast<AddOnId>(i)).effect, m.effect[i]);
+        return m;
+    }();
+    return menu;
+}
+
+// composeOrder's add-on stages, folded in fixed point; false if one does not fit
+bool composeAddOns(const Order& order, FixedMath& math, FixedEffect& out) {
+    const AddOnRegistry& registry = defaultAddOns();
+    const FixedAddOnMenu& menu = fixedAddOns();
+    out = FixedEffect();
+
+    if (order.iced && registry.appliesTo(ADDON_ICED, order.drink)) {
+        if (!menu.fits[ADDON_ICED]) return false;
+        math.then(out, menu.effect[ADDON_ICED]);
+    }
+    if (order.extraShots > 0 && order.drink == DrinkType::Latte) {
+        size_t shots = indexOf(Quantity::Shots);
+        out.offset[shots] = math.add(out.offset[shots], math.in(order.extraShots));
+    }
+    for (size_t i = 0; i < order.addOnCount; ++i) {
+        AddOnId id = order.addOns[i];
+        if (!registry.appliesTo(id, order.drink)) continue;
+        if (!menu.fits[id]) return false;
+        math.then(out, menu.effect[id]);
+    }
+    return true;
+}
+
+/******************************************************************
+ * Function: evaluateCoffee
+ * ---------------------------------------------------------------
+ * DrinkComposition::evaluate (coffee) and caffeineMg: water is
+ * cups * 240 (exact), grounds water / ratio, then the fused
+ * coefficients for grounds and water.
+ ******************************************************************/
+bool evaluateCoffee(const Order& order, FixedMath& math, const FixedEffect& addons,
+                    OrderResult& out) {
+    const FixedCoffeeRecipe& rec = FIXED_RECIPES.coffee[indexOf(order.strength)][indexOf(order.roast)];
+    if (!rec.valid || order.cups <= 0.0) {
+        out.ok = false;
+        return true;
+    }
+
+    Fixed cups = math.in(order.cups);
+    Fixed water = math.mul(cups, FIXED_ML_PER_CUP);
+    Fixed grams = math.div(water, rec.ratio);
+    Fixed tbsp = math.div(grams, TBSP_DIVISOR);
+    double waterCups = order.cups;
+
+    if (!addons.isIdentity(Quantity::Grams)) {
+        grams = math.apply(addons, Quantity::Grams, grams);
+        tbsp = math.div(grams, TBSP_DIVISOR);
+    }
+    if (!addons.isIdentity(Quantity::Water)) {
+        water = math.apply(addons, Quantity::Water, water);
+        waterCups = toDouble(math.div(water, CUP_DIVISOR));
+    }
+    Fixed caffeine = math.apply(addons, Quantity::Caffeine, math.mul(cups, FIXED_CAFFEINE_PER_CUP));
+    if (math.overflowed()) return false;
+
+    out.ok = true;
+    out.coffee = {waterCups, toDouble(water), toDouble(grams),
+                  static_cast<double>(rec.ratio.d), toDouble(tbsp)};
+    out.caffeineMg = toDouble(caffeine);
+    return true;
+}
+
+/******************************************************************
+ * Function: evaluateLatte
+ * ---------------------------------------------------------------
+ * DrinkComposition::evaluate (latte) and caffeineMg: added shots
+ * join the base before the recipe, grounds and brew ratio take
+ * their coefficients, and the milk target is sized last.
+ ******************************************************************/
+bool evaluateLatte(const Order& order, FixedMath& math, const FixedEffect& addons,
+                   OrderResult& out) {
+    const FixedLatteRecipe& rec = FIXED_RECIPES.latte[indexOf(order.shotSize)][indexOf(order.strength)];
+    if (!rec.valid || order.shots <= 0) {
+        out.ok = false;
+        return true;
+    }
+
+    // nearest whole shot, halves up (as wholeShots())
+    Fixed shots = math.apply(addons, Quantity::Shots, math.in(order.shots));
+    Fixed count = (shots + (FIXED_ONE >> 1)) & ~(FIXED_ONE - 1);
+    if (math.overflowed()) return false;
+    if (count == 0 || count > Fixed(MAX_TOTAL_SHOTS) << FIXED_FRACTION_BITS) {
+        out.ok = false;
+        return true;
+    }
+
+    Fixed grams = math.mul(count, rec.gramsPerShot);
+    Fixed brewRatio = rec.brewRatio;
+    Fixed espresso = math.mul(count, rec.espressoMLPerShot);
+    Fixed tbsp = math.div(grams, TBSP_DIVISOR);
+
+    bool gramsChanged = !addons.isIdentity(Quantity::Grams);
+    if (gramsChanged) {
+        grams = math.apply(addons, Quantity::Grams, grams);
+        tbsp = math.div(grams, TBSP_DIVISOR);
+    }
+    if (gramsChanged || !addons.isIdentity(Quantity::BrewRatio)) {
+        brewRatio = math.apply(addons, Quantity::BrewRatio, brewRatio);
+        espresso = math.mul(grams, brewRatio);
+    }
+
+    LatteResult latte(static_cast<int>(count >> FIXED_FRACTION_BITS), order.shotSize,
+                      toDouble(grams), toDouble(brewRatio), toDouble(espresso),
+                      toDouble(math.div(espresso, CUP_DIVISOR)), toDouble(tbsp));
+
+    if (order.milkStyle != MilkStyle::None) {
+        Fixed milk = math.apply(addons, Quantity::Milk, math.mul(espresso, math.in(order.milkRatio)));
+        Fixed total = math.add(espresso, milk);
+        latte.hasMilkTarget = true;
+        latte.milkStyle = order.milkStyle;
+        latte.milkToEspRatio = order.milkRatio;
+        latte.milkML = toDouble(milk);
+        latte.milkCups = toDouble(math.div(milk, CUP_DIVISOR));
+        latte.finalML = toDouble(total);
+        latte.finalCups = toDouble(math.div(total, CUP_DIVISOR));
+    }
+    Fixed caffeine = math.apply(addons, Quantity::Caffeine, math.mul(count, rec.caffeinePerShot));
+    if (math.overflowed()) return false;
+
+    out.ok = true;
+    out.latte = latte;
+    out.caffeineMg = toDouble(caffeine);
+    return true;
+}
+
+} // namespace
+
+bool toFixedEffect(const AddOnEffect& effect, FixedEffect& out) {
+    FixedMath math;
+    FixedEffect f;
+    for (size_t i = 0; i < QUANTITY_COUNT; ++i) {
+        f.scale[i] = math.in(effect.scale[i]);
+        f.offset[i] = math.in(effect.offset[i]);
+    }
+    if (math.overflowed()) return false;
+    out = f;
+    return true;
+}
+
+/******************************************************************
+ * Function: evaluateOrderFixed
+ * ---------------------------------------------------------------
+ * computeOrder on the fixed-point engine: the same stages
+ * (composeOrder's add-ons, evaluate, caffeineMg) with every value
+ * in Q32.32. Invalid orders come back with ok == false, as from
+ * computeOrder.
+ *
+ * Returns:
+ *   false if the order does not fit the engine (out unspecified).
+ ******************************************************************/
+bool evaluateOrderFixed(const Order& order, OrderResult& out) {
+    FixedMath math;
+    FixedEffect addons;
+    if (!composeAddOns(order, math, addons) || math.overflowed()) return false;
+
+    out.drink = order.drink;
+    out.caffeineMg = 0.0;
+    return (order.drink == DrinkType::Coffee) ? evaluateCoffee(order, math, addons, out)
+                                              : evaluateLatte(order, math, addons, out);
+}
+
+bool computeOrderFixed(const Order& order, OrderResult& out) {
+    PROBE_SCOPE("order.fixed");
+    if (evaluateOrderFixed(order, out)) return out.ok;
+    PROBE_COUNT("order.fixed_fallback", 1);
+    return computeOrder(order, out);
+}
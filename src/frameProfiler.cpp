@@ -0,0 +1,150 @@
+#include "frameProfiler.hpp"
+#include <algorithm>
+#include <iomanip>
+#include "summaryFormat.hpp"
+using namespace std;
+
+namespace frame_detail {
+atomic<uint64_t> allocations{0};
+atomic<uint64_t> allocatedBytes{0};
+}
+
+namespace {
+
+// p in [0,1] over the first n values (reorders them)
+double percentileOf(array<double, FRAME_HISTORY>& values, size_t n, double p) {
+    if (n == 0) return 0.0;
+    size_t k = min(n - 1, static_cast<size_t>(p * static_cast<double>(n)));
+    nth_element(values.begin(), values.begin() + k, values.begin() + n);
+    return values[k];
+}
+
+} // namespace
+
+void WakeupMeter::advance(TimePoint now) {
+    if (count == 0) return;
+    int64_t target = chrono::duration_cast<chrono::seconds>(now - start).count();
+    // clear the buckets of the seconds that passed without a wakeup
+    for (int64_t s = second + 1; s <= target && s <= second + static_cast<int64_t>(WAKEUP_WINDOW); ++s)
+        perSecond[static_cast<size_t>(s) % WAKEUP_WINDOW] = 0;
+    if (target > second) second = target;
+}
+
+void WakeupMeter::wake(TimePoint now) {
+    if (count == 0) start = now;
+    else advance(now);
+    ++perSecond[static_cast<size_t>(second) % WAKEUP_WINDOW];
+    ++count;
+}
+
+uint64_t WakeupMeter::lastMinute(TimePoint now) {
+    advance(now);
+    uint64_t sum = 0;
+    for (uint32_t n : perSecond) sum += n;
+    return sum;
+}
+
+double WakeupMeter::perMinute(TimePoint now) const {
+    if (count == 0) return 0.0;
+    double minutes = chrono::duration<double>(now - start).count() / 60.0;
+    return minutes > 0.0 ? static_cast<double>(count) / minutes : 0.0;
+}
+
+bool FrameProfiler::openCsv(const string& path) {
+    csv.open(path, ios::trunc);
+    if (!csv) return false;
+    csv << "frame,frame_ms,work_ms,events_ms,build_ms,draw_ms,draw_calls,texts_created,"
+           "allocations,allocated_bytes\n"
+        << fixed << setprecision(3);
+    return true;
+}
+
+void FrameProfiler::beginFrame() {
+    current = FrameSample();
+    current.frame = frameCount;
+    allocStart = frame_detail::allocations.load(memory_order_relaxed);
+    bytesStart = frame_detail::allocatedBytes.load(memory_order_relaxed);
+}
+
+/******************************************************************
+ * Function: FrameProfiler::endFrame
+ * ---------------------------------------------------------------
+ * Closes the frame begun by beginFrame(): stores it in the ring
+ * and, if a CSV is open, appends its row.
+ ******************************************************************/
+void FrameProfiler::endFrame(double frameMs, double eventsMs, double buildMs, double drawMs) {
+    current.frameMs = frameMs;
+    current.eventsMs = eventsMs;
+    current.buildMs = buildMs;
+    current.drawMs = drawMs;
+    current.workMs = eventsMs + buildMs + drawMs;
+    current.allocations = frame_detail::allocations.load(memory_order_relaxed) - allocStart;
+    current.allocatedBytes = frame_detail::allocatedBytes.load(memory_order_relaxed) - bytesStart;
+
+    history[next] = current;
+    next = (next + 1) % FRAME_HISTORY;
+    filled = min(filled + 1, FRAME_HISTORY);
+    ++frameCount;
+
+    if (csv.is_open()) {
+        csv << current.frame << ',' << current.frameMs << ',' << current.workMs << ','
+            << current.eventsMs << ',' << current.buildMs << ',' << current.drawMs << ','
+            << current.drawCalls << ',' << current.textsCreated << ',' << current.allocations
+            << ',' << current.allocatedBytes << '\n';
+    }
+}
+
+FramePercentiles FrameProfiler::percentiles() const {
+    FramePercentiles out;
+    out.frames = filled;
+    if (filled == 0) return out;
+
+    array<double, FRAME_HISTORY> frameMs, workMs;
+    double draws = 0.0, texts = 0.0, allocs = 0.0;
+    for (size_t i = 0; i < filled; ++i) {
+        const FrameSample& s = history[i];
+        frameMs[i] = s.frameMs;
+        workMs[i] = s.workMs;
+        draws += s.drawCalls;
+        texts += s.textsCreated;
+        allocs += static_cast<double>(s.allocations);
+    }
+    out.frameMax = *max_element(frameMs.begin(), frameMs.begin() + filled);
+    out.frameP50 = percentileOf(frameMs, filled, 0.50);
+    out.frameP95 = percentileOf(frameMs, filled, 0.95);
+    out.frameP99 = percentileOf(frameMs, filled, 0.99);
+    out.workP50 = percentileOf(workMs, filled, 0.50);
+    out.workP99 = percentileOf(workMs, filled, 0.99);
+
+    double n = static_cast<double>(filled);
+    out.drawCalls = draws / n;
+    out.textsCreated = texts / n;
+    out.allocations = allocs / n;
+    return out;
+}
+
+/******************************************************************
+ * Function: formatFrameHud
+ * ---------------------------------------------------------------
+ * The HUD text: rolling percentiles, then the last frame's counts.
+ ******************************************************************/
+void formatFrameHud(char* buffer, size_t capacity, const FramePercentiles& stats,
+                    const FrameSample& last, uint64_t wakeupsLastMinute, bool recording) {
+    SummaryWriter out(buffer, capacity);
+    out.append("frame ms  p50 ").appendFixed2(stats.frameP50)
+       .append("  p95 ").appendFixed2(stats.frameP95)
+       .append("  p99 ").appendFixed2(stats.frameP99)
+       .append("  max ").appendFixed2(stats.frameMax).append('\n');
+    out.append("work ms   p50 ").appendFixed2(stats.workP50)
+       .append("  p99 ").appendFixed2(stats.workP99)
+       .append("  (last ").appendInt(static_cast<long long>(stats.frames)).append(" frames)\n");
+    out.append("per frame draws ").appendFixed2(stats.drawCalls)
+       .append("  texts ").appendFixed2(stats.textsCreated)
+       .append("  allocs ").appendFixed2(stats.allocations).append('\n');
+    out.append("last: draws ").appendInt(last.drawCalls)
+       .append("  texts ").appendInt(last.textsCreated)
+       .append("  allocs ").appendInt(static_cast<long long>(last.allocations))
+       .append(" (").appendInt(static_cast<long long>(last.allocatedBytes)).append(" B)\n");
+    out.append("wakeups last minute ").appendInt(static_cast<long long>(wakeupsLastMinute));
+    if (recording) out.append("\nrecording CSV");
+}
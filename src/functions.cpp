@@ -1,5 +1,8 @@
 #include "functions.hpp"
 #include "constants.hpp"
+#include "instrumentation.hpp"
+#include "recipeKernels.hpp"
+#include "summaryFormat.hpp"
 #include <iostream>
 using namespace std;
 
@@ -38,61 +41,43 @@ double gramsToTablespoons(double grams) {
 /******************************************************************
  * Function: milkStyleToRatio
  * ---------------------------------------------------------------
- * Maps a milk style keyword to its corresponding milk-to-espresso
- * ratio. Returns -1 for custom, -2 for invalid style.
+ * Maps a milk style to its corresponding milk-to-espresso ratio.
+ * Returns -1 for custom (the caller supplies the ratio).
  *
  * Parameters:
- *   styleIn - user-entered milk style string
+ *   style - parsed milk style
  *
  * Returns:
- *   Ratio as a double, or a negative code for special handling.
+ *   Ratio as a double, or -1 for custom.
  ******************************************************************/
-double milkStyleToRatio(const string& styleIn) {
-    string s = toLowerCopy(styleIn);
-    if (s == "cortado") return 1.0;
-    if (s == "flatwhite" || s == "flat_white") return 2.0;
-    if (s == "latte") return 3.0;
-    if (s == "none") return 0.0;
-    if (s == "custom") return -1.0;
-    return -2.0;
+double milkStyleToRatio(MilkStyle style) {
+    return MILK_RATIO[indexOf(style)];
 }
 
 /******************************************************************
  * Function: calcCoffee
  * ---------------------------------------------------------------
  * Calculates required coffee grinds and water amounts based on
- * strength, roast type, and number of cups desired.
+ * strength, roast type, and number of cups desired. The recipe
+ * comes from the compile-time COFFEE_RECIPES table.
  *
  * Parameters:
- *   strengthIn - coffee strength (bolder, medium, weaker)
- *   roastIn    - roast type (light, medium, dark)
- *   cups       - desired number of cups
- *   out        - reference to CoffeeResult struct for storing results
+ *   strength - coffee strength (bolder, medium, weaker)
+ *   roast    - roast type (light, medium, dark)
+ *   cups     - desired number of cups
+ *   out      - reference to CoffeeResult struct for storing results
  *
  * Returns:
  *   true if calculation successful, false if invalid input.
  ******************************************************************/
-bool calcCoffee(const string& strengthIn, const string& roastIn,
+bool calcCoffee(Strength strength, Roast roast,
                 double cups, CoffeeResult& out) {
-    string strength = toLowerCopy(strengthIn);
-    string roast    = toLowerCopy(roastIn);
+    PROBE_SCOPE("calc.coffee");
+    const CoffeeRecipe& rec = COFFEE_RECIPES(strength, roast);
+    if (rec.ratio == 0.0 || cups <= 0.0) return false;
 
-    double baseRatio = 0.0;
-    if (strength == "bolder") baseRatio = 14.0;
-    else if (strength == "medium") baseRatio = 16.0;
-    else if (strength == "weaker") baseRatio = 18.0;
-    else return false;
-
-    if (roast == "light") baseRatio += 1.0;
-    else if (roast == "dark") baseRatio -= 1.0;
-
-    if (cups <= 0.0) return false;
-
-    double waterML = cups * ML_PER_CUP;
-    double grams   = waterML / baseRatio;
-    double tbsp    = gramsToTablespoons(grams);
-
-    out = {cups, waterML, grams, baseRatio, tbsp};
+    out = {cups, cups * ML_PER_CUP, cups * rec.gramsPerCup, rec.ratio,
+           cups * rec.tbspPerCup};
     return true;
 }
 
@@ -100,41 +85,28 @@ bool calcCoffee(const string& strengthIn, const string& roastIn,
  * Function: calcLatteFromShots
  * ---------------------------------------------------------------
  * Calculates espresso and optional milk volumes for a latte based
- * on shot size, shot count, and brew strength.
+ * on shot size, shot count, and brew strength. The recipe comes
+ * from the compile-time LATTE_RECIPES table.
  *
  * Parameters:
- *   strengthIn - latte brew strength (stronger or weaker)
- *   shotSizeIn - shot size (single/double)
- *   shotCount  - number of espresso shots
- *   out        - reference to LatteResult struct for storing results
+ *   strength  - latte brew strength (stronger or weaker)
+ *   shotSize  - shot size (single/double)
+ *   shotCount - number of espresso shots
+ *   out       - reference to LatteResult struct for storing results
  *
  * Returns:
  *   true if calculation successful, false if invalid input.
  ******************************************************************/
-bool calcLatteFromShots(const string& strengthIn, const string& shotSizeIn,
+bool calcLatteFromShots(Strength strength, ShotSize shotSize,
                         int shotCount, LatteResult& out) {
-    string strength = toLowerCopy(strengthIn);
-    string shotSize = toLowerCopy(shotSizeIn);
-
-    if (shotCount <= 0) return false;
-
-    double gramsPerShot = 0.0;
-    if (shotSize == "single")      gramsPerShot = 8.0;
-    else if (shotSize == "double") gramsPerShot = 16.0;
-    else return false;
+    PROBE_SCOPE("calc.latte");
+    const LatteRecipe& rec = LATTE_RECIPES(shotSize, strength);
+    if (rec.brewRatio == 0.0 || shotCount <= 0) return false;
 
-    double brewRatio = 0.0;
-    if (strength == "stronger")      brewRatio = 2.0;
-    else if (strength == "weaker")   brewRatio = 2.5;
-    else return false;
-
-    double totalGrams   = gramsPerShot * shotCount;
-    double espressoML   = totalGrams * brewRatio;
-    double espressoCups = espressoML / ML_PER_CUP;
-    double tbsp         = gramsToTablespoons(totalGrams);
-
-    out = LatteResult(shotCount, shotSizeIn, totalGrams,
-                  brewRatio, espressoML, espressoCups, tbsp);
+    out = LatteResult(shotCount, shotSize, shotCount * rec.gramsPerShot,
+                  rec.brewRatio, shotCount * rec.espressoMLPerShot,
+                  shotCount * rec.espressoCupsPerShot,
+                  shotCount * rec.tbspPerShot);
 
     return true;
 }
@@ -143,51 +115,32 @@ bool calcLatteFromShots(const string& strengthIn, const string& shotSizeIn,
 // constructors
 
 LatteResult::LatteResult() 
-    : shots(0), shotSize(""), coffeeGrams(0.0), brewRatio(0.0),
+    : shots(0), shotSize(ShotSize::Single), coffeeGrams(0.0), brewRatio(0.0),
       espressoML(0.0), espressoCups(0.0), tablespoons(0.0),
-      hasMilkTarget(false), milkStyle(""), milkToEspRatio(0.0),
+      hasMilkTarget(false), milkStyle(MilkStyle::None), milkToEspRatio(0.0),
       milkML(0.0), milkCups(0.0), finalML(0.0), finalCups(0.0)
 {}
 
-LatteResult::LatteResult(int s, const std::string& size, double grams,
+LatteResult::LatteResult(int s, ShotSize size, double grams,
             double ratio, double espML, double espCups, double tbsp)
     : shots(s), shotSize(size), coffeeGrams(grams), brewRatio(ratio),
       espressoML(espML), espressoCups(espCups), tablespoons(tbsp),
-      hasMilkTarget(false), milkStyle(""), milkToEspRatio(0.0),
+      hasMilkTarget(false), milkStyle(MilkStyle::None), milkToEspRatio(0.0),
       milkML(0.0), milkCups(0.0), finalML(0.0), finalCups(0.0)
 {}
 
-void printCoffeeSummary(const CoffeeResult& r,
-                        const string& roastType,
-                        const string& strength)
+void printCoffeeSummary(const CoffeeResult& r, Roast roast, Strength strength)
 {
-    cout << "\n--- Coffee Summary ---\n";
-    cout << "Roast Type:         " << roastType << '\n';
-    cout << "Strength:           " << strength << " (1:" << r.ratio << ")\n";
-    cout << "Required Water:     " << r.waterCups << " cup(s) (" << r.waterML << " mL)\n";
-    cout << "Coffee Grounds:     " << r.coffeeGrams << " g (" << r.tablespoons << " tbsp)\n";
-    cout << "Enjoy your coffee!\n";
+    char buffer[SUMMARY_CAPACITY];
+    SummaryWriter out(buffer);
+    formatCoffeeSummary(out, r, roast, strength);
+    cout.write(out.c_str(), static_cast<streamsize>(out.size()));
 }
 
-void printLatteSummary(const LatteResult& r,
-                       const string& strength,
-                       const string& shotSize)
+void printLatteSummary(const LatteResult& r, Strength strength)
 {
-    cout << "\n--- Latte Summary ---\n";
-    cout << "Strength (brew):      " << strength << " (espresso 1:" << r.brewRatio << ")\n";
-    cout << "Shot Plan:            " << r.shots << " x " << r.shotSize << " shot(s)\n";
-    cout << "Coffee Grounds:       " << r.coffeeGrams  << " g (" << r.tablespoons << " tbsp)\n";
-    cout << "Espresso Output:      " << r.espressoCups << " cup(s) (" << r.espressoML << " mL)\n";
-
-    if (r.hasMilkTarget) {
-        cout << "Milk Style Target:    " << r.milkStyle
-             << " (milk:espresso = " << r.milkToEspRatio << ":1)\n";
-        cout << "Milk Volume:          " << r.milkCups << " cup(s) (" << r.milkML << " mL)\n";
-        cout << "Estimated Final Size: " << r.finalCups << " cup(s) (" << r.finalML << " mL)\n";
-    } else {
-        cout << "Milk:                 to taste (add milk to reach your preferred latte size)\n";
-    }
-
-    cout << "Enjoy your latte!\n";
+    char buffer[SUMMARY_CAPACITY];
+    SummaryWriter out(buffer);
+    formatLatteSummary(out, r, strength);
+    cout.write(out.c_str(), static_cast<streamsize>(out.size()));
 }
-
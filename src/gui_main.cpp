@@ -1,54 +1,63 @@
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 #include <SFML/System.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <optional>
 #include <string>
 #include <vector>
-#include <sstream>
-#include <iomanip>
-#include <iostream>
-#include <algorithm>
-#include <functional>
 
-#include "functions.hpp"
-#include "presets.hpp"
+#include "frameProfiler.hpp"
+#include "instrumentation.hpp"
 #include "presetManager.hpp"
-#include "addons.hpp"
-#include "constants.hpp"
+#include "presetStore.hpp"
+#include "summaryFormat.hpp"
+#include "uiReplay.hpp"
+#include "uiStateMachine.hpp"
+
+// counting replacements for the global allocation functions (the HUD's allocs/frame)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t size) {
+  noteAllocation(size);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { ::operator delete(p); }
+void operator delete(void *p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void *p, std::size_t) noexcept { ::operator delete(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
 
 namespace {
 
-enum class Flow { None, Make, CreatePreset, LoadPreset };
-
-enum class Screen {
-  MainMenu,
-  ChooseDrink,
-  CoffeeRoast,
-  CoffeeStrength,
-  CoffeeCups,
-  LatteStrength,
-  LatteShotSize,
-  LatteShots,
-  LatteMilkStyle,
-  LatteMilkRatio,
-  PresetName,
-  LoadPresetList,
-  AddonsPrompt,
-  AddonsList,
-  ToppingInput,
-  ExtraShotsInput,
-  Summary,
-  Error
-};
+using FrameClock = std::chrono::steady_clock;
 
-/******************************************************************
- * Function: formatDouble
- * ---------------------------------------------------------------
- * Formats a double to 2 decimal places.
- ******************************************************************/
-std::string formatDouble(double x) {
-  std::ostringstream oss;
-  oss << std::fixed << std::setprecision(2) << x;
-  return oss.str();
+// event-driven loop: longest sleep in waitEvent, and the shorter one while
+// the HUD is up so its figures keep moving
+constexpr std::int32_t GUI_IDLE_WAKE_MS = 1000;
+constexpr std::int32_t GUI_HUD_WAKE_MS  = 250;
+
+// sf::Text objects made since the frame began (for the HUD)
+std::uint32_t textsCreated = 0;
+
+double msBetween(FrameClock::time_point from, FrameClock::time_point to) {
+  return std::chrono::duration<double, std::milli>(to - from).count();
 }
 
 /******************************************************************
@@ -71,7 +80,8 @@ bool loadFont(sf::Font &font) {
  * ---------------------------------------------------------------
  * Builds an SFML text object with the default light color.
  ******************************************************************/
-sf::Text makeText(const sf::Font &font, const std::string &str, unsigned size) {
+sf::Text makeText(const sf::Font &font, const sf::String &str, unsigned size) {
+  ++textsCreated;
   sf::Text t(font, str, size);
   t.setFillColor(sf::Color(240, 240, 240));
   return t;
@@ -89,134 +99,243 @@ void centerHoriz(sf::Text &text, float y, float width) {
 }
 
 /******************************************************************
- * Function: drawOptions
+ * Function: toUiEvent
+ * ---------------------------------------------------------------
+ * Translates an SFML event into the state machine's input, or
+ * nothing for events the UI does not use.
+ ******************************************************************/
+std::optional<UiEvent> toUiEvent(const sf::Event &event) {
+  if (const auto *key = event.getIf<sf::Event::KeyPressed>()) {
+    switch (key->code) {
+    case sf::Keyboard::Key::Up:        return UiEvent{UiKey::Up, 0};
+    case sf::Keyboard::Key::Down:      return UiEvent{UiKey::Down, 0};
+    case sf::Keyboard::Key::Left:      return UiEvent{UiKey::Left, 0};
+    case sf::Keyboard::Key::Enter:     return UiEvent{UiKey::Enter, 0};
+    case sf::Keyboard::Key::Escape:    return UiEvent{UiKey::Escape, 0};
+    case sf::Keyboard::Key::Backspace: return UiEvent{UiKey::Backspace, 0};
+    default:                           return std::nullopt;
+    }
+  }
+  if (const auto *text = event.getIf<sf::Event::TextEntered>()) {
+    if (text->unicode >= 32 && text->unicode < 127)
+      return UiEvent{UiKey::Char, static_cast<char>(text->unicode)};
+  }
+  return std::nullopt;
+}
+
+/******************************************************************
+ * Struct: Scene
+ * ---------------------------------------------------------------
+ * Retained render state: the text objects and highlight for the
+ * current screen, already laid out. Rebuilt only when the UI state
+ * or the window size changes (dirty); other frames just redraw it.
+ * sf::Text keeps its glyph vertex array between draws and sf::Font
+ * caches rasterized glyphs, so a clean frame does no layout work.
+ ******************************************************************/
+struct Scene {
+  std::vector<sf::Text> texts;
+  sf::RectangleShape highlight;
+  bool hasHighlight = false;
+  bool dirty = true;
+};
+
+/******************************************************************
+ * Function: addOptions
  * ---------------------------------------------------------------
- * Renders a vertical list of options with a highlight for selection.
+ * Lays out a vertical list of options with a highlight for the
+ * selection.
  ******************************************************************/
-void drawOptions(sf::RenderWindow &window, const sf::Font &font,
-                 const std::vector<std::string> &opts, std::size_t selected,
-                 float startY) {
+void addOptions(Scene &scene, const sf::Font &font, const UiMachine &machine,
+                float startY, float width) {
   float y = startY;
-  for (std::size_t i = 0; i < opts.size(); ++i) {
-    sf::Text t = makeText(font, opts[i], 18);
+  for (std::size_t i = 0; i < machine.optionCount(); ++i) {
+    sf::Text t = makeText(font, std::string(machine.option(i)), 18);
     sf::FloatRect b = t.getLocalBounds();
-    if (i == selected) {
-      sf::RectangleShape bg(
-          sf::Vector2f(b.size.x + 24.0f, b.size.y + 14.0f));
-      bg.setFillColor(sf::Color(60, 90, 160));
-      bg.setOrigin({bg.getSize().x / 2.0f, bg.getSize().y / 2.0f});
-      bg.setPosition({window.getSize().x / 2.0f, y + b.size.y / 2.0f});
-      window.draw(bg);
+    if (i == machine.state().selected) {
+      scene.highlight.setSize(sf::Vector2f(b.size.x + 24.0f, b.size.y + 14.0f));
+      scene.highlight.setFillColor(sf::Color(60, 90, 160));
+      scene.highlight.setOrigin({scene.highlight.getSize().x / 2.0f,
+                                 scene.highlight.getSize().y / 2.0f});
+      scene.highlight.setPosition({width / 2.0f, y + b.size.y / 2.0f});
+      scene.hasHighlight = true;
     }
-    centerHoriz(t, y + b.size.y / 2.0f, window.getSize().x);
-    window.draw(t);
+    centerHoriz(t, y + b.size.y / 2.0f, width);
+    scene.texts.push_back(t);
     y += 38.0f;
   }
 }
 
-struct UiState {
-  Flow flow = Flow::None;
-  Screen screen = Screen::MainMenu;
-  std::string prompt;
-  std::string message;
-  std::string summary;
-
-  // selection list
-  std::vector<std::string> options;
-  std::size_t selected = 0;
-
-  // numeric selection
-  bool valueMode = false;
-  double value = 0.0;
-  double step = 1.0;
-  double minValue = 0.0;
-  std::string valueLabel;
-
-  // text input
-  bool textMode = false;
-  std::string textInput;
-
-  // captured inputs
-  std::string drinkType;
-  std::string roastType;
-  std::string coffeeStrength;
-  double coffeeCups = 0.0;
-
-  std::string latteStrength;
-  std::string latteShotSize;
-  int latteShots = 0;
-  std::string latteMilkStyle;
-  double latteMilkRatio = 0.0;
-  bool needsCustomRatio = false;
-
-  // addons
-  bool isIced = false;
-  std::string topping;
-  int extraShots = 0;
-
-  // presets
-  std::string presetName;
-  PresetManager presets;
-  std::vector<Screen> history;
+/******************************************************************
+ * Function: buildScene
+ * ---------------------------------------------------------------
+ * Builds and positions every text object for the current screen.
+ ******************************************************************/
+void buildScene(Scene &scene, const UiMachine &machine, const sf::Font &font,
+                float width, float height) {
+  const UiState &state = machine.state();
+  scene.texts.clear();
+  scene.hasHighlight = false;
+
+  // Calculate content height to center it vertically
+  float bodyHeight = 0.0f;
+  if (state.screen == Screen::Summary) {
+      bodyHeight = 200.0f; 
+  } else if (state.input == InputMode::Value || state.input == InputMode::Text) {
+      bodyHeight = 60.0f;
+  } else if (machine.optionCount() > 0) {
+      bodyHeight = machine.optionCount() * 38.0f;
+  }
 
-  // stats
-  double dailyCaffeine = 0.0;
-  bool warningShown = false;
-};
+  // Header (Title + Prompt + Message) ~ 140px reserved
+  float totalContentHeight = 140.0f + bodyHeight; 
+  float availableHeight = height - 40.0f; // Reserve space for bottom hint
+  float baseY = (availableHeight - totalContentHeight) / 2.0f;
+  if (baseY < 10.0f) baseY = 10.0f;
+
+  sf::Text title = makeText(font, "Coffee & Latte Ratio Calculator", 26);
+  centerHoriz(title, baseY, width);
+  scene.texts.push_back(title);
+
+  if (state.screen == Screen::MainMenu) {
+      char statsBuf[64];
+      SummaryWriter statsLine(statsBuf);
+      statsLine.append("Daily Caffeine: ").appendFixed2(state.dailyCaffeine).append(" mg");
+      sf::Text stats = makeText(font, statsLine.c_str(), 16);
+      stats.setFillColor(sf::Color(150, 200, 255));
+      centerHoriz(stats, baseY + 35.0f, width);
+      scene.texts.push_back(stats);
+  }
+
+  sf::Text promptText = makeText(font, state.prompt, 18);
+  centerHoriz(promptText, baseY + 70.0f, width);
+  scene.texts.push_back(promptText);
+
+  if (machine.hasMessage()) {
+    sf::Text msg = makeText(font, state.message, 16);
+    msg.setFillColor(sf::Color(255, 120, 120));
+    centerHoriz(msg, baseY + 110.0f, width);
+    scene.texts.push_back(msg);
+  }
+
+  float bodyY = baseY + 140.0f;
+  const char *hint = nullptr;
+
+  if (state.screen == Screen::Summary) {
+    sf::Text sum = makeText(font, state.summary, 16);
+    sum.setPosition({width / 2.0f - sum.getLocalBounds().size.x / 2.0f, bodyY});
+    scene.texts.push_back(sum);
+    hint = "Enter to return to menu, Esc to restart";
+  } else if (state.input == InputMode::Value) {
+    char valueBuf[128];
+    SummaryWriter valueLine(valueBuf);
+    valueLine.append(state.valueLabel).append(": ").appendFixed2(state.value);
+    sf::Text v = makeText(font, valueLine.c_str(), 20);
+    centerHoriz(v, bodyY, width);
+    scene.texts.push_back(v);
+    hint = "Up/Down to adjust, Enter to confirm, Esc to restart";
+  } else if (state.input == InputMode::Text) {
+    sf::Text t = makeText(font, state.textInput.empty() ? std::string("_") : std::string(state.textInput), 20);
+    centerHoriz(t, bodyY, width);
+    scene.texts.push_back(t);
+    hint = "Type to edit, Enter to confirm, Esc to restart";
+  } else if (machine.optionCount() > 0) {
+    addOptions(scene, font, machine, bodyY, width);
+    hint = "Up/Down to move, Enter to confirm, Left to go back, Esc to restart";
+  }
+
+  if (hint) {
+    sf::Text h = makeText(font, hint, 14);
+    centerHoriz(h, height - 30.0f, width);
+    scene.texts.push_back(h);
+  }
+  scene.dirty = false;
+}
 
 /******************************************************************
- * Function: buildCoffeeSummary
+ * Function: drawScene
  * ---------------------------------------------------------------
- * Formats a coffee result into a multi-line summary string.
+ * Draws the retained scene as-is.
+ *
+ * Returns the number of draw calls made.
  ******************************************************************/
-std::string buildCoffeeSummary(const UiState &state, const CoffeeResult &r) {
-  std::string s;
-  s += "Coffee Summary\n";
-  s += "Roast: " + state.roastType + "\n";
-  s += "Strength: " + state.coffeeStrength + " (1:" +
-       std::to_string(static_cast<int>(r.ratio)) + ")\n";
-  s += "Water: " + formatDouble(r.waterML) + " mL\n";
-  s += "Coffee: " + formatDouble(r.coffeeGrams) + " g (" + formatDouble(r.tablespoons) + " tbsp)\n";
-  if (state.isIced) s += "Addons: Iced\n";
-  if (!state.topping.empty()) s += "Topping: " + state.topping;
-  return s;
+std::uint32_t drawScene(sf::RenderWindow &window, const Scene &scene) {
+  if (scene.hasHighlight)
+    window.draw(scene.highlight);
+  for (const sf::Text &t : scene.texts)
+    window.draw(t);
+  return static_cast<std::uint32_t>(scene.texts.size()) + (scene.hasHighlight ? 1 : 0);
 }
 
 /******************************************************************
- * Function: buildLatteSummary
+ * Struct: PerfHud
  * ---------------------------------------------------------------
- * Formats a latte result into a multi-line summary string.
+ * The F3 overlay: one text block on a translucent panel in the
+ * top-left corner. Its string is rebuilt every FRAME_HUD_REFRESH
+ * frames when redrawing continuously, every drawn frame otherwise
+ * (so the HUD's own allocations show up at that rate), and its two
+ * draw calls are counted like any other.
  ******************************************************************/
-std::string buildLatteSummary(const UiState &state, const LatteResult &r) {
-  std::string s;
-  s += "Latte Summary\n";
-  s += "Strength: " + state.latteStrength + "\n";
-  s += "Shots: " + std::to_string(state.latteShots) + " x " +
-       state.latteShotSize + "\n";
-  s += "Coffee: " + formatDouble(r.coffeeGrams) + " g (" + formatDouble(r.tablespoons) + " tbsp)\n";
-  s += "Espresso: " + formatDouble(r.espressoML) + " mL\n";
-  if (r.hasMilkTarget) {
-    s += "Milk: " + formatDouble(r.milkML) + " mL (style " + state.latteMilkStyle + ")\n";
-    s += "Final: " + formatDouble(r.finalML) + " mL\n";
+struct PerfHud {
+  explicit PerfHud(const sf::Font &font) : text(font, "", 13) {
+    text.setFillColor(sf::Color(170, 255, 170));
+    text.setPosition({12.0f, 10.0f});
+    panel.setFillColor(sf::Color(0, 0, 0, 180));
+    panel.setPosition({6.0f, 6.0f});
+  }
+
+  void refresh(FrameProfiler &profiler) {
+    char buf[512];
+    formatFrameHud(buf, sizeof buf, profiler.percentiles(), profiler.last(),
+                   profiler.wakeupMeter().lastMinute(FrameClock::now()), profiler.csvOpen());
+    text.setString(buf);
+    sf::FloatRect b = text.getLocalBounds();
+    panel.setSize(sf::Vector2f(b.size.x + 16.0f, b.size.y + 16.0f));
+  }
+
+  std::uint32_t draw(sf::RenderWindow &window) const {
+    window.draw(panel);
+    window.draw(text);
+    return 2;
   }
-  if (state.isIced) s += "Addons: Iced\n";
-  if (state.extraShots > 0) s += "Extra Shots: " + std::to_string(state.extraShots) + "\n";
-  if (!state.topping.empty()) s += "Topping: " + state.topping;
-  return s;
-}
+
+  sf::Text text;
+  sf::RectangleShape panel;
+  bool visible = false;
+};
 
 } // namespace
 
 /******************************************************************
  * Function: runGui
  * ---------------------------------------------------------------
- * Entry point for the SFML GUI. Manages navigation, rendering, and
- * drink/preset flows using simple state tracking.
+ * Entry point for the SFML GUI. The calculator logic lives in
+ * UiMachine; this loop only translates window events into
+ * UiEvents and renders the machine's state.
+ *
+ * By default the loop is event-driven: it sleeps in waitEvent()
+ * and redraws only when the UI state changed, the window was
+ * resized or regained focus, or the HUD needs new figures. A wake
+ * with nothing to show (the GUI_IDLE_WAKE_MS timeout) goes back to
+ * sleep without drawing. continuous keeps the old behaviour of
+ * polling and redrawing at the 60 fps limit.
+ *
+ * Every drawn frame is timed (events, scene build, draw) and
+ * counted (draw calls, texts created, allocations) by a
+ * FrameProfiler, and every pass through the loop counts as a
+ * wakeup; F3 shows the perf HUD. Wakeups per minute go to stderr
+ * on exit.
+ *
+ * Parameters:
+ *   recordPath - if set, every UiEvent is appended to this trace
+ *                file for later replay (final_project --replay)
+ *   frameCsv   - if set, one CSV row per frame is written here
+ *   showHud    - start with the HUD visible
+ *   continuous - poll and redraw every frame
  *
  * Returns:
  *   0 on normal exit.
  ******************************************************************/
-int runGui() {
+int runGui(const char *recordPath, const char *frameCsv, bool showHud, bool continuous) {
   sf::RenderWindow window(sf::VideoMode({760, 540}), "Coffee & Latte Calculator",
                           sf::Style::Default);
   window.setFramerateLimit(60);
@@ -225,629 +344,122 @@ int runGui() {
   if (!loadFont(font))
     return 1;
 
-  UiState state;
-  bool shouldClose = false;
-
-  std::function<void()> pushHistory = [&]() {
-    if (state.screen != Screen::Summary && state.screen != Screen::Error &&
-        state.screen != Screen::MainMenu) {
-      state.history.push_back(state.screen);
-    }
-  };
-
-  std::function<void(Screen)> configureScreen = [&](Screen s) {
-    state.screen = s;
-    state.valueMode = false;
-    state.textMode = false;
-    state.options.clear();
-    state.message.clear();
-    state.warningShown = false; // Reset warning state on screen change
-    // Don't clear addons here, as we might be navigating back/forth within a flow
-    // But do clear them when starting a new flow (handled in startMakeFlow)
-    switch (s) {
-    case Screen::MainMenu:
-      state.prompt = "Select an action";
-      state.options = {"Make a drink", "Create preset", "Load preset", "Quit"};
-      state.selected = 0;
-      break;
-    case Screen::ChooseDrink:
-      state.prompt = "Choose drink type";
-      state.options = {"coffee", "latte"};
-      state.selected = (state.drinkType == "latte") ? 1 : 0;
-      break;
-    case Screen::CoffeeRoast:
-      state.prompt = "Select roast";
-      state.options = {"light", "medium", "dark"};
-      if (state.roastType == "medium")
-        state.selected = 1;
-      else if (state.roastType == "dark")
-        state.selected = 2;
-      else
-        state.selected = 0;
-      break;
-    case Screen::CoffeeStrength:
-      state.prompt = "Coffee strength";
-      state.options = {"bolder", "medium", "weaker"};
-      if (state.coffeeStrength == "medium")
-        state.selected = 1;
-      else if (state.coffeeStrength == "weaker")
-        state.selected = 2;
-      else
-        state.selected = 0;
-      break;
-    case Screen::CoffeeCups:
-      state.prompt = "Cups (Up/Down, Enter to confirm)";
-      state.valueMode = true;
-      state.valueLabel = "cups";
-      state.value = (state.coffeeCups > 0.0) ? state.coffeeCups : 1.0;
-      state.step = 0.5;
-      state.minValue = 0.5;
-      break;
-    case Screen::LatteStrength:
-      state.prompt = "Latte strength";
-      state.options = {"stronger", "weaker"};
-      state.selected = (state.latteStrength == "weaker") ? 1 : 0;
-      break;
-    case Screen::LatteShotSize:
-      state.prompt = "Shot size";
-      state.options = {"single", "double"};
-      state.selected = (state.latteShotSize == "double") ? 1 : 0;
-      break;
-    case Screen::LatteShots:
-      state.prompt = "Number of shots (Up/Down, Enter to confirm)";
-      state.valueMode = true;
-      state.valueLabel = "shots";
-      state.value = (state.latteShots > 0) ? state.latteShots : 1;
-      state.step = 1;
-      state.minValue = 1;
-      break;
-    case Screen::LatteMilkStyle:
-      state.prompt = "Milk style";
-      state.options = {"none", "cortado", "flatwhite", "latte", "custom"};
-      if (state.latteMilkStyle == "cortado")
-        state.selected = 1;
-      else if (state.latteMilkStyle == "flatwhite")
-        state.selected = 2;
-      else if (state.latteMilkStyle == "latte")
-        state.selected = 3;
-      else if (state.latteMilkStyle == "custom")
-        state.selected = 4;
-      else
-        state.selected = 0;
-      break;
-    case Screen::LatteMilkRatio:
-      state.prompt = "Custom milk:espresso ratio (Up/Down, Enter)";
-      state.valueMode = true;
-      state.valueLabel = "ratio";
-      state.value = (state.latteMilkRatio >= 0.0) ? state.latteMilkRatio : 2.0;
-      state.step = 0.1;
-      state.minValue = 0.0;
-      break;
-    case Screen::PresetName:
-      state.prompt = "Enter preset name (type, Enter to confirm)";
-      state.textMode = true;
-      state.textInput = state.presetName;
-      break;
-    case Screen::LoadPresetList: {
-      state.prompt = "Select a preset to load";
-      state.options = state.presets.getPresetNames();
-      state.selected = 0;
-      break;
-    }
-    case Screen::AddonsPrompt:
-      state.prompt = "Add addons? (Ice, Toppings, etc)";
-      state.options = {"No", "Yes"};
-      state.selected = 0;
-      break;
-    case Screen::AddonsList:
-      state.prompt = "Select Addon";
-      if (state.drinkType == "coffee") {
-        state.options = {"Ice (Cold Drink)", "Topping", "Done"};
-      } else {
-        state.options = {"Ice (Cold Drink)", "Topping", "Extra Shots", "Done"};
-      }
-      state.selected = 0;
-      break;
-    case Screen::ToppingInput:
-      state.prompt = "Enter topping name (type, Enter)";
-      state.textMode = true;
-      state.textInput = state.topping;
-      break;
-    case Screen::ExtraShotsInput:
-      state.prompt = "Extra shots (Up/Down, Enter)";
-      state.valueMode = true;
-      state.valueLabel = "extra";
-      state.value = (state.extraShots > 0) ? state.extraShots : 1;
-      state.step = 1;
-      state.minValue = 1;
-      break;
-    case Screen::Summary:
-    case Screen::Error:
-      break;
-    }
-  };
-
-  std::function<void(Screen, const std::string &, std::initializer_list<std::string>)>
-      setOptions = [&](Screen s, const std::string &prompt,
-                       std::initializer_list<std::string> opts) {
-    pushHistory();
-    state.screen = s;
-    state.prompt = prompt;
-    state.options.assign(opts);
-    state.selected = 0;
-    state.valueMode = false;
-    state.textMode = false;
-    state.textInput.clear();
-    state.message.clear();
-  };
-
-  std::function<void(Screen, const std::string &, const std::vector<std::string> &)>
-      setOptionsVec = [&](Screen s, const std::string &prompt,
-                          const std::vector<std::string> &opts) {
-    pushHistory();
-    state.screen = s;
-    state.prompt = prompt;
-    state.options = opts;
-    state.selected = 0;
-    state.valueMode = false;
-    state.textMode = false;
-    state.textInput.clear();
-    state.message.clear();
-  };
-
-  std::function<void(Screen, const std::string &, double, double, double, const std::string &)>
-      setValue = [&](Screen s, const std::string &prompt, double start,
-                     double step, double min, const std::string &label) {
-    pushHistory();
-    state.screen = s;
-    state.prompt = prompt;
-    state.valueMode = true;
-    state.textMode = false;
-    state.value = start;
-    state.step = step;
-    state.minValue = min;
-    state.valueLabel = label;
-    state.options.clear();
-    state.message.clear();
-  };
+  // presets persist on disk and survive returns to the main menu
+  PresetStore presetStore;
+  if (!presetStore.open(DEFAULT_PRESET_STORE))
+    std::cerr << "Presets will not be saved (cannot open "
+              << DEFAULT_PRESET_STORE << ")" << std::endl;
 
-  std::function<void(Screen, const std::string &)> setText = [&](Screen s, const std::string &prompt) {
-    pushHistory();
-    state.screen = s;
-    state.prompt = prompt;
-    state.textMode = true;
-    state.valueMode = false;
-    state.textInput.clear();
-    state.options.clear();
-    state.message.clear();
-  };
-
-  std::function<void()> resetToMenu = [&]() {
-    Flow prev = state.flow;
-    state = UiState();
-    state.flow = Flow::None;
-    state.history.clear();
-    configureScreen(Screen::MainMenu);
-    if (prev == Flow::CreatePreset || prev == Flow::LoadPreset) {
-      state.message = "Preset operations now available in GUI.";
-    }
-  };
-
-  std::function<bool()> computeCoffee = [&]() -> bool {
-    CoffeeResult r;
-    if (!calcCoffee(state.coffeeStrength, state.roastType, state.coffeeCups, r))
-      return false;
-
-    if (!calcCoffee(state.coffeeStrength, state.roastType, state.coffeeCups, r))
-      return false;
-
-    applyCoffeeAddons(r, state.isIced, state.topping);
-
-    if (state.flow == Flow::CreatePreset) {
-      Presets p(state.presetName);
-      p.setCoffee(state.roastType, state.coffeeStrength, state.coffeeCups);
-      state.presets.addPreset(p);
-      state.summary = "Preset saved: " + state.presetName + "\n\n" +
-                      buildCoffeeSummary(state, r);
-    } else {
-      state.summary = buildCoffeeSummary(state, r);
-    }
-    state.dailyCaffeine += r.waterCups * CAFFEINE_PER_CUP_COFFEE;
-    state.screen = Screen::Summary;
-    return true;
-  };
-
-  std::function<bool()> computeLatte = [&]() -> bool {
-    LatteResult r;
-    if (!calcLatteFromShots(state.latteStrength, state.latteShotSize,
-                            state.latteShots, r))
-      return false;
-
-    applyLatteAddons(r, state.isIced, state.extraShots, state.topping);
-
-    if (toLowerCopy(state.latteMilkStyle) != "none") {
-      r.hasMilkTarget = true;
-      r.milkStyle = state.latteMilkStyle;
-      r.milkToEspRatio = state.latteMilkRatio;
-      r.milkML = r.espressoML * r.milkToEspRatio;
-      r.milkCups = r.milkML / ML_PER_CUP;
-      r.finalML = r.espressoML + r.milkML;
-      r.finalCups = r.finalML / ML_PER_CUP;
-    }
-
-    if (state.flow == Flow::CreatePreset) {
-      Presets p(state.presetName);
-      p.setLatte(state.latteShotSize, state.latteShots, state.latteStrength,
-                 state.latteMilkStyle, state.latteMilkRatio);
-      state.presets.addPreset(p);
-      state.summary = "Preset saved: " + state.presetName + "\n\n" +
-                      buildLatteSummary(state, r);
-    } else {
-      state.summary = buildLatteSummary(state, r);
-    }
-    double shotMg = (state.latteShotSize == "double") ? (2.0 * CAFFEINE_PER_SINGLE_SHOT) : CAFFEINE_PER_SINGLE_SHOT;
-    state.dailyCaffeine += state.latteShots * shotMg;
-    state.dailyCaffeine += state.extraShots * CAFFEINE_PER_SINGLE_SHOT;
-
-    state.screen = Screen::Summary;
-    return true;
-  };
-
-  std::function<void()> startMakeFlow = [&]() {
-    state.flow = Flow::Make;
-    // Reset addon state
-    state.isIced = false;
-    state.topping.clear();
-    state.extraShots = 0;
-    setOptions(Screen::ChooseDrink, "Choose drink type", {"coffee", "latte"});
-  };
-
-  std::function<void()> startCreatePresetFlow = [&]() {
-    state.flow = Flow::CreatePreset;
-    setText(Screen::PresetName, "Enter preset name (type, Enter to confirm)");
-  };
+  PresetManager presets;
+  if (presetStore.isOpen())
+    presets.attachStore(&presetStore);
+  UiMachine machine(presets);
+
+  std::ofstream trace;
+  if (recordPath) {
+    trace.open(recordPath, std::ios::app);
+    if (!trace)
+      std::cerr << "Cannot record to " << recordPath << std::endl;
+  }
 
-  std::function<void()> startLoadPresetFlow = [&]() {
-    if (!state.presets.hasPresets()) {
-      state.message = "No presets saved yet.";
-      state.screen = Screen::Error;
-      return;
+  FrameProfiler profiler;
+  if (frameCsv && !profiler.openCsv(frameCsv))
+    std::cerr << "Cannot write frame timings to " << frameCsv << std::endl;
+
+  Scene scene;
+  PerfHud hud(font);
+  hud.visible = showHud;
+  FrameClock::time_point runStart = FrameClock::now();
+  FrameClock::time_point lastFrame = runStart;
+  bool redraw = true;
+
+  auto handleEvent = [&](const sf::Event &event) {
+    const auto *key = event.getIf<sf::Event::KeyPressed>();
+    if (key && key->code == sf::Keyboard::Key::F3) {
+      hud.visible = !hud.visible;
+      redraw = true;
+    } else if (event.is<sf::Event::Closed>()) {
+      window.close();
+    } else if (const auto* resized = event.getIf<sf::Event::Resized>()) {
+      sf::FloatRect visibleArea({0.f, 0.f}, {static_cast<float>(resized->size.x), static_cast<float>(resized->size.y)});
+      window.setView(sf::View(visibleArea));
+      scene.dirty = true;
+    } else if (event.is<sf::Event::FocusGained>()) {
+      // SFML has no expose event; the window may have been covered
+      redraw = true;
+    } else if (std::optional<UiEvent> ui = toUiEvent(event)) {
+      if (trace.is_open())
+        writeUiEvent(trace, *ui);
+      if (machine.handle(*ui))
+        scene.dirty = true;
     }
-    state.flow = Flow::LoadPreset;
-    std::vector<std::string> names = state.presets.getPresetNames();
-    setOptionsVec(Screen::LoadPresetList, "Select a preset to load", names);
   };
 
-  resetToMenu();
-
-  std::function<void()> goBack = [&]() {
-    if (state.history.empty())
-      return;
-    Screen prev = state.history.back();
-    state.history.pop_back();
-    configureScreen(prev);
-  };
-
-  std::function<void()> confirmSelection = [&]() {
-    state.message.clear();
-    switch (state.screen) {
-    case Screen::MainMenu:
-      if (state.selected == 0) {
-        startMakeFlow();
-      } else if (state.selected == 1) {
-        startCreatePresetFlow();
-      } else if (state.selected == 2) {
-        startLoadPresetFlow();
-      } else {
-        shouldClose = true;
-        window.close();
-      }
-      break;
-    case Screen::ChooseDrink:
-      state.drinkType = toLowerCopy(state.options[state.selected]);
-      if (state.drinkType == "coffee") {
-        setOptions(Screen::CoffeeRoast, "Select roast",
-                   {"light", "medium", "dark"});
-      } else {
-        setOptions(Screen::LatteStrength, "Latte strength",
-                   {"stronger", "weaker"});
-      }
-      break;
-    case Screen::CoffeeRoast:
-      state.roastType = toLowerCopy(state.options[state.selected]);
-      setOptions(Screen::CoffeeStrength, "Coffee strength",
-                 {"bolder", "medium", "weaker"});
-      break;
-    case Screen::CoffeeStrength:
-      state.coffeeStrength = toLowerCopy(state.options[state.selected]);
-      setValue(Screen::CoffeeCups, "Cups (Up/Down, Enter to confirm)", 1.0,
-               0.5, 0.5, "cups");
-      break;
-    case Screen::CoffeeCups:
-      state.coffeeCups = state.value;
-      setOptions(Screen::AddonsPrompt, "Add addons?", {"No", "Yes"});
-      break;
-    case Screen::LatteStrength:
-      state.latteStrength = toLowerCopy(state.options[state.selected]);
-      setOptions(Screen::LatteShotSize, "Shot size", {"single", "double"});
-      break;
-    case Screen::LatteShotSize:
-      state.latteShotSize = toLowerCopy(state.options[state.selected]);
-      setValue(Screen::LatteShots, "Number of shots (Up/Down, Enter to confirm)",
-               1, 1, 1, "shots");
-      break;
-    case Screen::LatteMilkStyle: {
-      state.latteMilkStyle = toLowerCopy(state.options[state.selected]);
-      double ratio = milkStyleToRatio(state.latteMilkStyle);
-      if (ratio == -1.0) {
-        state.needsCustomRatio = true;
-        setValue(Screen::LatteMilkRatio,
-                 "Custom milk:espresso ratio (Up/Down, Enter)", 2.0, 0.1, 0.0,
-                 "ratio");
-      } else {
-        state.needsCustomRatio = false;
-        state.latteMilkRatio = ratio;
-        state.latteMilkRatio = ratio;
-        setOptions(Screen::AddonsPrompt, "Add addons?", {"No", "Yes"});
-      }
-      break;
-    }
-    case Screen::AddonsPrompt:
-      if (state.selected == 1) { // Yes
-        configureScreen(Screen::AddonsList);
-      } else { // No
-        if (state.drinkType == "coffee") computeCoffee();
-        else computeLatte();
-      }
-      break;
-    case Screen::AddonsList: {
-      std::string choice = state.options[state.selected];
-      if (choice == "Done") {
-        if (state.drinkType == "coffee") computeCoffee();
-        else computeLatte();
-      } else if (choice == "Ice (Cold Drink)") {
-        state.isIced = !state.isIced; // Toggle
-        state.message = state.isIced ? "Drink is now Iced" : "Drink is now Hot";
-      } else if (choice == "Topping") {
-        setText(Screen::ToppingInput, "Enter topping name");
-      } else if (choice == "Extra Shots") {
-        setValue(Screen::ExtraShotsInput, "Extra shots", 1, 1, 1, "extra");
-      }
+  while (window.isOpen()) {
+    std::optional<sf::Event> first;
+    if (!continuous)
+      first = window.waitEvent(sf::milliseconds(hud.visible ? GUI_HUD_WAKE_MS : GUI_IDLE_WAKE_MS));
+
+    PROBE_SCOPE("gui.frame");
+    PROBE_COUNT("gui.wakeups", 1);
+    FrameClock::time_point frameStart = FrameClock::now();
+    profiler.countWakeup(frameStart);
+    profiler.beginFrame();
+    textsCreated = 0;
+
+    if (first)
+      handleEvent(*first);
+    else if (hud.visible)
+      redraw = true;      // timed out: only the HUD's figures moved on
+    while (const auto event = window.pollEvent())
+      handleEvent(*event);
+
+    if (machine.quitRequested()) {
+      window.close();
       break;
     }
-    case Screen::LoadPresetList:
-      if (!state.options.empty()) {
-        std::string name = state.options[state.selected];
-        Presets *p = state.presets.getPresetByName(name);
-        if (!p) {
-          state.message = "Preset not found.";
-          state.screen = Screen::Error;
-          break;
-        }
-
-        if (p->getDrinkType() == "coffee") {
-          state.roastType = p->getRoast();
-          state.coffeeStrength = p->getStrength();
-          state.coffeeCups = p->getCups();
-          if (!computeCoffee()) {
-            state.message = "Error loading preset.";
-            state.screen = Screen::Error;
-          }
-        } else {
-          state.latteShotSize = p->getShotSize();
-          state.latteShots = p->getShots();
-          state.latteStrength = p->getLatteStrength();
-          state.latteMilkStyle = p->getMilkStyle();
-          state.latteMilkRatio = p->getMilkRatio();
-          if (!computeLatte()) {
-            state.message = "Error loading preset.";
-            state.screen = Screen::Error;
-          }
-        }
-      }
-      break;
-    case Screen::Summary:
-    case Screen::Error:
-      resetToMenu();
-      break;
-    default:
+    if (!window.isOpen())
       break;
-    }
-  };
 
-  std::function<void()> confirmValue = [&]() {
-    switch (state.screen) {
-      break;
-    case Screen::CoffeeCups:
-      // Handled in confirmSelection now to flow to addons
-      state.coffeeCups = state.value;
-      setOptions(Screen::AddonsPrompt, "Add addons?", {"No", "Yes"});
-      break;
-    case Screen::LatteShots:
-      if (state.value > 5.0 && !state.warningShown) {
-        state.message = "Warning: High caffeine content! Enter again to confirm.";
-        state.warningShown = true;
-        break;
-      }
-      state.latteShots = static_cast<int>(state.value);
-      setOptions(Screen::LatteMilkStyle, "Milk style",
-                 {"none", "cortado", "flatwhite", "latte", "custom"});
-      break;
-    case Screen::LatteMilkRatio:
-      state.latteMilkRatio = state.value;
-      if (!computeLatte()) {
-        state.message = "Calculation error.";
-        state.screen = Screen::Error;
-      }
-      // Instead of computing immediately, go to addons
-      setOptions(Screen::AddonsPrompt, "Add addons?", {"No", "Yes"});
-      break;
-    case Screen::ExtraShotsInput:
-      state.extraShots = static_cast<int>(state.value);
-      state.message = "Added " + std::to_string(state.extraShots) + " extra shots.";
-      goBack(); // Return to AddonsList
-      break;
-    default:
-      break;
-    }
-  };
+    FrameClock::time_point eventsEnd = FrameClock::now();
 
-  std::function<void()> confirmText = [&]() {
-    switch (state.screen) {
-    case Screen::PresetName:
-      if (state.textInput.empty()) {
-        state.message = "Preset name cannot be empty.";
-      } else {
-        state.presetName = state.textInput;
-        setOptions(Screen::ChooseDrink, "Choose drink type",
-                   {"coffee", "latte"});
-      }
-      break;
-    case Screen::ToppingInput:
-      state.topping = state.textInput;
-      state.message = "Added topping: " + state.topping;
-      goBack(); // Return to AddonsList
-      break;
-    default:
-      break;
+    if (scene.dirty) {
+      PROBE_SCOPE("gui.buildScene");
+      buildScene(scene, machine, font, static_cast<float>(window.getSize().x),
+                 static_cast<float>(window.getSize().y));
+      redraw = true;
     }
-  };
-
-  while (window.isOpen()) {
-    while (const auto event = window.pollEvent()) {
-      if (event->is<sf::Event::Closed>()) {
-        window.close();
-      } else if (const auto* keyPressed = event->getIf<sf::Event::KeyPressed>()) {
-        if (keyPressed->code == sf::Keyboard::Key::Left) {
-          goBack();
-        } else if (keyPressed->code == sf::Keyboard::Key::Escape) {
-          resetToMenu();
-        } else if (state.valueMode) {
-          if (keyPressed->code == sf::Keyboard::Key::Up) {
-            state.value += state.step;
-          } else if (keyPressed->code == sf::Keyboard::Key::Down) {
-            state.value = std::max(state.minValue, state.value - state.step);
-          } else if (keyPressed->code == sf::Keyboard::Key::Enter) {
-            confirmValue();
-          }
-        } else if (state.textMode) {
-          if (keyPressed->code == sf::Keyboard::Key::Backspace) {
-            if (!state.textInput.empty())
-              state.textInput.pop_back();
-          } else if (keyPressed->code == sf::Keyboard::Key::Enter) {
-            confirmText();
-          }
-        } else {
-          if (keyPressed->code == sf::Keyboard::Key::Up && !state.options.empty()) {
-            state.selected = (state.selected == 0) ? state.options.size() - 1
-                                                   : state.selected - 1;
-          } else if (keyPressed->code == sf::Keyboard::Key::Down &&
-                     !state.options.empty()) {
-            state.selected = (state.selected + 1) % state.options.size();
-          } else if (keyPressed->code == sf::Keyboard::Key::Enter) {
-            confirmSelection();
-          }
-        }
-      } else if (const auto* textEntered = event->getIf<sf::Event::TextEntered>()) {
-        if (state.textMode) {
-          if (textEntered->unicode >= 32 && textEntered->unicode < 127) {
-            state.textInput.push_back(static_cast<char>(textEntered->unicode));
-          }
-        }
-      } else if (const auto* resized = event->getIf<sf::Event::Resized>()) {
-          sf::FloatRect visibleArea({0.f, 0.f}, {static_cast<float>(resized->size.x), static_cast<float>(resized->size.y)});
-          window.setView(sf::View(visibleArea));
+    if (!continuous && !redraw)
+      continue;           // the last frame is still on screen
+    FrameClock::time_point buildEnd = FrameClock::now();
+
+    {
+      PROBE_SCOPE("gui.draw");
+      PROBE_COUNT("gui.redraws", 1);
+      window.clear(sf::Color(18, 20, 26));
+      profiler.countDraw(drawScene(window, scene));
+      if (hud.visible) {
+        if (!continuous || profiler.frames() % FRAME_HUD_REFRESH == 0)
+          hud.refresh(profiler);
+        profiler.countDraw(hud.draw(window));
       }
     }
+    FrameClock::time_point drawEnd = FrameClock::now();
 
-    if (shouldClose)
-      break;
-
-    window.clear(sf::Color(18, 20, 26));
-
-    // Calculate content height to center it vertically
-    float bodyHeight = 0.0f;
-    if (state.screen == Screen::Summary) {
-        bodyHeight = 200.0f; 
-    } else if (state.valueMode || state.textMode) {
-        bodyHeight = 60.0f;
-    } else if (!state.options.empty()) {
-        bodyHeight = state.options.size() * 38.0f;
-    }
-
-    // Header (Title + Prompt + Message) ~ 140px reserved
-    float totalContentHeight = 140.0f + bodyHeight; 
-    float availableHeight = window.getSize().y - 40.0f; // Reserve space for bottom hint
-    float baseY = (availableHeight - totalContentHeight) / 2.0f;
-    if (baseY < 10.0f) baseY = 10.0f;
-
-    sf::Text title = makeText(font, "Coffee & Latte Ratio Calculator", 26);
-    centerHoriz(title, baseY, window.getSize().x);
-    window.draw(title);
-
-    if (state.screen == Screen::MainMenu) {
-        sf::Text stats = makeText(font, "Daily Caffeine: " + formatDouble(state.dailyCaffeine) + " mg", 16);
-        stats.setFillColor(sf::Color(150, 200, 255));
-        centerHoriz(stats, baseY + 35.0f, window.getSize().x);
-        window.draw(stats);
-    }
-
-    sf::Text promptText = makeText(font, state.prompt, 18);
-    centerHoriz(promptText, baseY + 70.0f, window.getSize().x);
-    window.draw(promptText);
-
-    if (!state.message.empty()) {
-      sf::Text msg = makeText(font, state.message, 16);
-      msg.setFillColor(sf::Color(255, 120, 120));
-      centerHoriz(msg, baseY + 110.0f, window.getSize().x);
-      window.draw(msg);
-    }
-
-    float bodyY = baseY + 140.0f;
-
-    if (state.screen == Screen::Summary) {
-      sf::Text sum = makeText(font, state.summary, 16);
-      sum.setPosition(
-          {window.getSize().x / 2.0f - sum.getLocalBounds().size.x / 2.0f, bodyY});
-      window.draw(sum);
-      sf::Text hint =
-          makeText(font, "Enter to return to menu, Esc to restart", 14);
-      centerHoriz(hint, window.getSize().y - 30.0f, window.getSize().x);
-      window.draw(hint);
-    } else if (state.valueMode) {
-      std::ostringstream oss;
-      oss << std::fixed << std::setprecision(2) << state.value;
-      std::string valueStr = state.valueLabel + ": " + oss.str();
-      sf::Text v = makeText(font, valueStr, 20);
-      centerHoriz(v, bodyY, window.getSize().x);
-      window.draw(v);
-      sf::Text hint =
-          makeText(font, "Up/Down to adjust, Enter to confirm, Esc to restart",
-                   14);
-      centerHoriz(hint, window.getSize().y - 30.0f, window.getSize().x);
-      window.draw(hint);
-    } else if (state.textMode) {
-      std::string display = state.textInput.empty() ? "_" : state.textInput;
-      sf::Text t = makeText(font, display, 20);
-      centerHoriz(t, bodyY, window.getSize().x);
-      window.draw(t);
-      sf::Text hint =
-          makeText(font, "Type to edit, Enter to confirm, Esc to restart", 14);
-      centerHoriz(hint, window.getSize().y - 30.0f, window.getSize().x);
-      window.draw(hint);
-    } else if (!state.options.empty()) {
-      drawOptions(window, font, state.options, state.selected, bodyY);
-      sf::Text hint = makeText(
-          font,
-          "Up/Down to move, Enter to confirm, Left to go back, Esc to restart",
-          14);
-      centerHoriz(hint, window.getSize().y - 30.0f, window.getSize().x);
-      window.draw(hint);
-    }
-
+    profiler.countText(textsCreated);
+    profiler.endFrame(msBetween(lastFrame, frameStart), msBetween(frameStart, eventsEnd),
+                      msBetween(eventsEnd, buildEnd), msBetween(buildEnd, drawEnd));
+    lastFrame = frameStart;
+    redraw = false;
     window.display();
   }
 
+  FrameClock::time_point runEnd = FrameClock::now();
+  std::cerr << "gui: " << profiler.wakeupMeter().total() << " wakeups ("
+            << static_cast<long long>(profiler.wakeupMeter().perMinute(runEnd) + 0.5)
+            << "/min), " << profiler.frames() << " frames drawn in "
+            << static_cast<long long>(msBetween(runStart, runEnd) / 1000.0 + 0.5) << " s ("
+            << (continuous ? "continuous" : "event-driven") << ")" << std::endl;
   return 0;
 }
 
@@ -855,5 +467,39 @@ int runGui() {
  * Function: main
  * ---------------------------------------------------------------
  * Program entry for the GUI build; delegates to runGui.
+ * --record <file> appends the session's key events to a trace.
+ * --profile prints frame/probe timings on exit; --trace <file>
+ * writes them as Chrome trace-event JSON. --frame-csv <file>
+ * writes per-frame timings; --hud starts with the perf HUD shown.
+ * --continuous redraws at 60 fps instead of waiting for events.
  ******************************************************************/
-int main() { return runGui(); }
+int main(int argc, char *argv[]) {
+  const char *recordPath = nullptr;
+  const char *frameCsv = nullptr;
+  bool showHud = false;
+  bool continuous = false;
+  bool profile = false;
+  std::string tracePath;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      recordPath = argv[++i];
+    } else if (std::strcmp(argv[i], "--profile") == 0) {
+      profile = true;
+    } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (std::strcmp(argv[i], "--frame-csv") == 0 && i + 1 < argc) {
+      frameCsv = argv[++i];
+    } else if (std::strcmp(argv[i], "--hud") == 0) {
+      showHud = true;
+    } else if (std::strcmp(argv[i], "--continuous") == 0) {
+      continuous = true;
+    } else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--record <trace file>] [--profile] [--trace <json file>]"
+                << " [--frame-csv <csv file>] [--hud] [--continuous]" << std::endl;
+      return 1;
+    }
+  }
+  ProbeSession probes(profile, 0, tracePath);
+  return runGui(recordPath, frameCsv, showHud, continuous);
+}
@@ -0,0 +1,385 @@
+#include "instrumentation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <ostream>
+using namespace std;
+
+namespace probe_detail {
+atomic<bool> enabled{false};
+atomic<bool> tracing{false};
+}
+
+namespace {
+
+struct TraceEvent {
+    uint64_t start;
+    uint32_t duration;   // ticks, saturated
+    uint16_t probe;
+    uint16_t tid;
+};
+
+/******************************************************************
+ * Struct: ThreadBlock
+ * ---------------------------------------------------------------
+ * One thread's probe data. Only the owning thread writes it, so
+ * every update is a relaxed load and store; readers may see a
+ * block mid-update but never a torn counter. A timed call adds
+ * its ticks, max and one histogram bucket (the timed count is the
+ * histogram's sum, worked out by the reader); a call sampling
+ * skips only bumps untimed.
+ ******************************************************************/
+struct ThreadBlock {
+    atomic<uint64_t> ticks[PROBE_MAX];
+    atomic<uint64_t> maxTicks[PROBE_MAX];
+    atomic<uint64_t> untimed[PROBE_MAX];
+    atomic<uint64_t> counts[PROBE_MAX];
+    atomic<uint64_t> histogram[PROBE_MAX][PROBE_BUCKETS];
+
+    atomic<TraceEvent*> events{nullptr};   // allocated on the first traced call
+    atomic<size_t>      eventCount{0};
+    unique_ptr<TraceEvent[]> eventStorage;
+
+    atomic<bool> inUse{true};
+    uint16_t     tid = 0;
+
+    ThreadBlock() {
+        for (size_t p = 0; p < PROBE_MAX; ++p) {
+            ticks[p].store(0, memory_order_relaxed);
+            maxTicks[p].store(0, memory_order_relaxed);
+            untimed[p].store(0, memory_order_relaxed);
+            counts[p].store(0, memory_order_relaxed);
+            for (atomic<uint64_t>& h : histogram[p]) h.store(0, memory_order_relaxed);
+        }
+    }
+};
+
+struct Registry {
+    mutex lock;
+    const char* names[PROBE_MAX] = {};
+    size_t probeCount = 0;
+    vector<unique_ptr<ThreadBlock>> blocks;
+    uint16_t nextTid = 0;
+
+    // tick <-> ns anchor, taken when probes are first enabled
+    atomic<bool> anchored{false};
+    uint64_t anchorTicks = 0;
+    chrono::steady_clock::time_point anchorTime;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+atomic<uint64_t> droppedEvents{0};
+
+ThreadBlock* acquireBlock() {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    for (auto& b : r.blocks) {
+        bool idle = false;
+        if (b->inUse.compare_exchange_strong(idle, true)) {
+            b->tid = ++r.nextTid;
+            return b.get();
+        }
+    }
+    r.blocks.push_back(make_unique<ThreadBlock>());
+    r.blocks.back()->tid = ++r.nextTid;
+    return r.blocks.back().get();
+}
+
+// hands the block back when its thread exits
+struct ThreadHandle {
+    ThreadBlock* block = nullptr;
+    ~ThreadHandle() {
+        if (block) block->inUse.store(false, memory_order_release);
+    }
+};
+
+thread_local ThreadHandle threadHandle;
+
+// the same pointer, constant-initialized: reading it needs no TLS init call
+thread_local ThreadBlock* currentBlock = nullptr;
+
+ThreadBlock& threadBlock() {
+    if (!currentBlock) {
+        currentBlock = acquireBlock();
+        threadHandle.block = currentBlock;
+    }
+    return *currentBlock;
+}
+
+inline void bump(atomic<uint64_t>& a, uint64_t n) {
+    a.store(a.load(memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+// 0..3 exact, then 4 buckets per power of two
+size_t bucketOf(uint64_t t) {
+    if (t < 4) return static_cast<size_t>(t);
+    unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(t));
+    size_t index = 4 * (msb - 1) + ((t >> (msb - 2)) & 3);
+    return min(index, PROBE_BUCKETS - 1);
+}
+
+// first tick value past the bucket
+double bucketLimit(size_t index) {
+    if (index < 4) return static_cast<double>(index + 1);
+    unsigned msb = static_cast<unsigned>(index / 4 + 1);
+    return ldexp(static_cast<double>(5 + index % 4), static_cast<int>(msb) - 2);
+}
+
+double nsPerTick() {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    Registry& r = registry();
+    if (!r.anchored.load(memory_order_acquire)) return 1.0;
+    // stretch a very short run so the ratio is meaningful
+    while (chrono::steady_clock::now() - r.anchorTime < chrono::milliseconds(5)) {}
+    uint64_t ticks = probeTicks() - r.anchorTicks;
+    double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - r.anchorTime).count();
+    return ticks ? ns / static_cast<double>(ticks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+void appendEvent(ThreadBlock& b, ProbeId id, uint64_t start, uint64_t duration) {
+    size_t n = b.eventCount.load(memory_order_relaxed);
+    if (n == PROBE_TRACE_CAPACITY) {
+        droppedEvents.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+    TraceEvent* events = b.events.load(memory_order_relaxed);
+    if (!events) {
+        b.eventStorage.reset(new TraceEvent[PROBE_TRACE_CAPACITY]);
+        events = b.eventStorage.get();
+        b.events.store(events, memory_order_release);
+    }
+    events[n] = {start, static_cast<uint32_t>(min<uint64_t>(duration, UINT32_MAX)), id, b.tid};
+    b.eventCount.store(n + 1, memory_order_release);
+}
+
+} // namespace
+
+namespace probe_detail {
+
+void record(ProbeId id, uint64_t start, uint64_t end) {
+    uint64_t d = end > start ? end - start : 0;
+    ThreadBlock& b = threadBlock();
+    bump(b.ticks[id], d);
+    if (d > b.maxTicks[id].load(memory_order_relaxed)) b.maxTicks[id].store(d, memory_order_relaxed);
+    bump(b.histogram[id][bucketOf(d)], 1);
+    if (tracing.load(memory_order_relaxed)) appendEvent(b, id, start, d);
+}
+
+void tally(ProbeId id) {
+    bump(threadBlock().untimed[id], 1);
+}
+
+void count(ProbeId id, uint64_t n) {
+    bump(threadBlock().counts[id], n);
+}
+
+} // namespace probe_detail
+
+// the last id is shared by any names past PROBE_MAX - 1
+ProbeId registerProbe(const char* name) {
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+    for (size_t i = 0; i < r.probeCount; ++i)
+        if (strcmp(r.names[i], name) == 0) return static_cast<ProbeId>(i);
+    if (r.probeCount == PROBE_MAX - 1) {
+        r.names[PROBE_MAX - 1] = "(other)";
+        return static_cast<ProbeId>(PROBE_MAX - 1);
+    }
+    r.names[r.probeCount] = name;
+    return static_cast<ProbeId>(r.probeCount++);
+}
+
+void enableProbes(bool trace) {
+    Registry& r = registry();
+    {
+        lock_guard<mutex> guard(r.lock);
+        if (!r.anchored.load(memory_order_relaxed)) {
+            r.anchorTime = chrono::steady_clock::now();
+            r.anchorTicks = probeTicks();
+            r.anchored.store(true, memory_order_release);
+        }
+    }
+    if (trace) probe_detail::tracing.store(true, memory_order_relaxed);
+    probe_detail::enabled.store(true, memory_order_relaxed);
+}
+
+void disableProbes() {
+    probe_detail::enabled.store(false, memory_order_relaxed);
+    probe_detail::tracing.store(false, memory_order_relaxed);
+}
+
+/******************************************************************
+ * Function: probeSnapshot
+ * ---------------------------------------------------------------
+ * Merges every thread block. Ticks are converted with the ratio
+ * measured since probes were enabled; the total assumes untimed
+ * calls took the timed mean.
+ ******************************************************************/
+void probeSnapshot(vector<ProbeSummary>& out) {
+    out.clear();
+    double scale = nsPerTick();
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+
+    size_t probes = r.names[PROBE_MAX - 1] ? PROBE_MAX : r.probeCount;
+    for (size_t p = 0; p < probes; ++p) {
+        if (!r.names[p]) continue;
+        ProbeSummary s;
+        s.name = r.names[p];
+        uint64_t ticks = 0, maxTicks = 0, untimed = 0;
+        uint64_t histogram[PROBE_BUCKETS] = {};
+        for (const auto& b : r.blocks) {
+            s.count += b->counts[p].load(memory_order_relaxed);
+            ticks += b->ticks[p].load(memory_order_relaxed);
+            untimed += b->untimed[p].load(memory_order_relaxed);
+            maxTicks = max(maxTicks, b->maxTicks[p].load(memory_order_relaxed));
+            for (size_t i = 0; i < PROBE_BUCKETS; ++i)
+                histogram[i] += b->histogram[p][i].load(memory_order_relaxed);
+        }
+        for (uint64_t h : histogram) s.timed += h;
+        s.calls = s.timed + untimed;
+        if (s.calls == 0 && s.count == 0) continue;
+
+        if (s.timed > 0) {
+            s.meanNs = static_cast<double>(ticks) * scale / static_cast<double>(s.timed);
+            s.totalNs = s.meanNs * static_cast<double>(s.calls);
+            s.maxNs = static_cast<double>(maxTicks) * scale;
+            uint64_t seen = 0, total = s.timed;
+            bool have50 = false;
+            for (size_t i = 0; i < PROBE_BUCKETS; ++i) {
+                seen += histogram[i];
+                if (!have50 && seen * 2 >= total) {
+                    s.p50Ns = min(bucketLimit(i) * scale, s.maxNs);
+                    have50 = true;
+                }
+                if (seen * 100 >= total * 99) {
+                    s.p99Ns = min(bucketLimit(i) * scale, s.maxNs);
+                    break;
+                }
+            }
+        }
+        out.push_back(s);
+    }
+}
+
+void printProbeSnapshot(ostream& out) {
+    vector<ProbeSummary> probes;
+    probeSnapshot(probes);
+
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << left << setw(20) << "probe" << right << setw(10) << "calls" << setw(10) << "timed" << setw(12) << "total ms"
+        << setw(12) << "mean ns" << setw(12) << "p50 ns" << setw(12) << "p99 ns" << setw(14) << "max ns"
+        << '\n';
+    if (probes.empty()) out << "(no probe activity)\n";
+    for (const ProbeSummary& p : probes) {
+        out << left << setw(20) << p.name << right;
+        if (p.calls == 0) {
+            out << setw(10) << p.count << "  (counter)\n";
+            continue;
+        }
+        out << setw(10) << p.calls << setw(10) << p.timed << fixed << setprecision(3) << setw(12) << p.totalNs / 1e6
+            << setprecision(1) << setw(12) << p.meanNs << setw(12) << p.p50Ns << setw(12) << p.p99Ns
+            << setw(14) << p.maxNs;
+        if (p.count) out << "  +" << p.count;
+        out << '\n';
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/******************************************************************
+ * Function: writeChromeTrace
+ * ---------------------------------------------------------------
+ * Every kept event as a complete ("X") event; ts and dur are in
+ * microseconds since probes were enabled, one track per thread.
+ ******************************************************************/
+void writeChromeTrace(ostream& out) {
+    double scale = nsPerTick() / 1000.0;
+    Registry& r = registry();
+    lock_guard<mutex> guard(r.lock);
+
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    out << fixed << setprecision(3);
+    bool first = true;
+    for (const auto& b : r.blocks) {
+        size_t n = b->eventCount.load(memory_order_acquire);
+        const TraceEvent* events = b->events.load(memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            const TraceEvent& e = events[i];
+            double ts = static_cast<double>(static_cast<int64_t>(e.start - r.anchorTicks)) * scale;
+            out << (first ? "\n" : ",\n") << "{\"name\":\"" << r.names[e.probe]
+                << "\",\"cat\":\"probe\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.tid
+                << ",\"ts\":" << ts << ",\"dur\":" << e.duration * scale << '}';
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+uint64_t droppedTraceEvents() {
+    return droppedEvents.load(memory_order_relaxed);
+}
+
+ProbeReporter::ProbeReporter(ostream& out, chrono::milliseconds interval)
+    : worker([this, &out, interval] {
+          unique_lock<mutex> guard(lock);
+          while (!wake.wait_for(guard, interval, [this] { return done; })) {
+              out << "--- probes ---\n";
+              printProbeSnapshot(out);
+              out.flush();
+          }
+      }) {}
+
+ProbeReporter::~ProbeReporter() {
+    {
+        lock_guard<mutex> guard(lock);
+        done = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+ProbeSession::ProbeSession(bool report, unsigned everySeconds, const string& tracePath)
+    : report(report), tracePath(tracePath) {
+    if (!report && tracePath.empty()) return;
+    enableProbes(!tracePath.empty());
+    if (report && everySeconds > 0)
+        reporter = make_unique<ProbeReporter>(cerr, chrono::seconds(everySeconds));
+}
+
+ProbeSession::~ProbeSession() {
+    reporter.reset();
+    if (!report && tracePath.empty()) return;
+    disableProbes();
+#if !COFFEE_INSTRUMENT
+    cerr << "probes: compiled out (rebuild with INSTRUMENT=1)\n";
+#endif
+    if (report) {
+        cerr << "--- probes ---\n";
+        printProbeSnapshot(cerr);
+    }
+    if (!tracePath.empty()) {
+        ofstream file(tracePath, ios::trunc);
+        writeChromeTrace(file);
+        if (file) cerr << "probes: trace written to " << tracePath;
+        else cerr << "probes: cannot write " << tracePath;
+        if (droppedTraceEvents()) cerr << " (" << droppedTraceEvents() << " events dropped)";
+        cerr << "\n";
+    }
+}
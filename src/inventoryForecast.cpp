@@ -0,0 +1,216 @@
+#include "inventoryForecast.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+using namespace std;
+
+namespace {
+
+constexpr int64_t WINDOW = static_cast<int64_t>(INVENTORY_WINDOW_BUCKETS);
+constexpr int64_t NO_BUCKET = numeric_limits<int64_t>::min();
+
+// g -> mg, mL -> µL
+constexpr double UNITS_PER_AMOUNT = 1000.0;
+
+// one order or restock; larger amounts saturate here, so even
+// millions of them cannot wrap the 64-bit totals
+constexpr double MAX_AMOUNT = 1e9;
+
+uint64_t toUnits(double amount) {
+    if (!(amount > 0.0)) return 0;   // also NaN
+    if (!(amount < MAX_AMOUNT)) amount = MAX_AMOUNT;
+    return static_cast<uint64_t>(llround(amount * UNITS_PER_AMOUNT));
+}
+
+double fromUnits(uint64_t units) {
+    return static_cast<double>(units) / UNITS_PER_AMOUNT;
+}
+
+int64_t bucketOf(int64_t unixTime) {
+    int64_t q = unixTime / INVENTORY_BUCKET_SECONDS;
+    return (unixTime % INVENTORY_BUCKET_SECONDS < 0) ? q - 1 : q;
+}
+
+size_t slotOf(int64_t bucket) {
+    int64_t s = bucket % WINDOW;
+    return static_cast<size_t>(s < 0 ? s + WINDOW : s);
+}
+
+} // namespace
+
+InventoryForecast::InventoryForecast() {
+    fill(begin(slotBucket), end(slotBucket), NO_BUCKET);
+}
+
+void InventoryForecast::restock(Ingredient ingredient, double amount) {
+    stockUnits[indexOf(ingredient)] += toUnits(amount);
+}
+
+/******************************************************************
+ * Function: InventoryForecast::advanceTo
+ * ---------------------------------------------------------------
+ * Moves the clock forward to bucket, evicting the buckets that
+ * fall out of the window. At most INVENTORY_WINDOW_BUCKETS slots
+ * are touched however far the clock jumps.
+ ******************************************************************/
+void InventoryForecast::advanceTo(int64_t bucket) {
+    if (!started) {
+        started = true;
+        head = bucket;
+        firstBucket = bucket;
+        for (int64_t k = bucket - WINDOW + 1; k <= bucket; ++k)
+            slotBucket[slotOf(k)] = k;
+        return;
+    }
+    if (bucket <= head) return;
+
+    for (int64_t k = max(head + 1, bucket - WINDOW + 1); k <= bucket; ++k) {
+        size_t slot = slotOf(k);
+        for (size_t i = 0; i < INGREDIENT_COUNT; ++i) {
+            windowUnits[i] -= slotUnits[slot][i];
+            slotUnits[slot][i] = 0;
+        }
+        windowOrders -= slotOrders[slot];
+        slotOrders[slot] = 0;
+        slotBucket[slot] = k;
+    }
+    head = bucket;
+}
+
+// the ring holds exactly the buckets (head - WINDOW, head]
+void InventoryForecast::addToWindow(int64_t bucket, const uint64_t* amounts) {
+    if (bucket <= head - WINDOW) return;
+    size_t slot = slotOf(bucket);
+    for (size_t i = 0; i < INGREDIENT_COUNT; ++i) {
+        slotUnits[slot][i] += amounts[i];
+        windowUnits[i] += amounts[i];
+    }
+    ++slotOrders[slot];
+    ++windowOrders;
+}
+
+// orders before the window: counted as used, not toward the rate
+uint64_t InventoryForecast::late() const {
+    return orderCount - windowOrders;
+}
+
+/******************************************************************
+ * Function: InventoryForecast::consume
+ * ---------------------------------------------------------------
+ * Records one order's beans and milk at unixTime. O(1): totals,
+ * one ring slot and the window sum (plus eviction when the clock
+ * moves to a new minute).
+ ******************************************************************/
+void InventoryForecast::consume(int64_t unixTime, double beansG, double milkML) {
+    uint64_t amounts[INGREDIENT_COUNT] = {toUnits(beansG), toUnits(milkML)};
+    for (size_t i = 0; i < INGREDIENT_COUNT; ++i)
+        usedUnits[i] += amounts[i];
+    ++orderCount;
+
+    int64_t bucket = bucketOf(unixTime);
+    advanceTo(bucket);
+    firstBucket = min(firstBucket, bucket);
+    addToWindow(bucket, amounts);
+}
+
+void InventoryForecast::consume(int64_t unixTime, const OrderResult& result) {
+    if (!result.ok) return;
+    if (result.drink == DrinkType::Coffee)
+        consume(unixTime, result.coffee.coffeeGrams, 0.0);
+    else
+        consume(unixTime, result.latte.coffeeGrams, result.latte.milkML);
+}
+
+/******************************************************************
+ * Function: InventoryForecast::merge
+ * ---------------------------------------------------------------
+ * Folds in a forecast built over another part of the same stream
+ * (e.g. by another batch worker). The result holds the same
+ * totals and window as one forecast fed both parts, in any
+ * order, and so the same late() count.
+ ******************************************************************/
+void InventoryForecast::merge(const InventoryForecast& other) {
+    for (size_t i = 0; i < INGREDIENT_COUNT; ++i) {
+        stockUnits[i] += other.stockUnits[i];
+        usedUnits[i] += other.usedUnits[i];
+    }
+    orderCount += other.orderCount;
+    if (!other.started) return;
+
+    bool wasStarted = started;
+    advanceTo(other.head);
+    firstBucket = wasStarted ? min(firstBucket, other.firstBucket) : other.firstBucket;
+
+    for (size_t slot = 0; slot < INVENTORY_WINDOW_BUCKETS; ++slot) {
+        int64_t bucket = other.slotBucket[slot];
+        if (bucket <= head - WINDOW) continue;   // evicted by our newer clock
+        for (size_t i = 0; i < INGREDIENT_COUNT; ++i) {
+            slotUnits[slot][i] += other.slotUnits[slot][i];
+            windowUnits[i] += other.slotUnits[slot][i];
+        }
+        slotOrders[slot] += other.slotOrders[slot];
+        windowOrders += other.slotOrders[slot];
+    }
+}
+
+double InventoryForecast::stock(Ingredient ingredient) const {
+    return fromUnits(stockUnits[indexOf(ingredient)]);
+}
+
+double InventoryForecast::consumed(Ingredient ingredient) const {
+    return fromUnits(usedUnits[indexOf(ingredient)]);
+}
+
+int64_t InventoryForecast::rateSpanSeconds() const {
+    if (!started) return 0;
+    return min(WINDOW, head - firstBucket + 1) * INVENTORY_BUCKET_SECONDS;
+}
+
+double InventoryForecast::ratePerHour(Ingredient ingredient) const {
+    int64_t span = rateSpanSeconds();
+    if (span == 0) return 0.0;
+    return fromUnits(windowUnits[indexOf(ingredient)]) * 3600.0 / static_cast<double>(span);
+}
+
+double InventoryForecast::hoursToEmpty(Ingredient ingredient) const {
+    double left = remaining(ingredient);
+    if (left <= 0.0) return 0.0;
+    double rate = ratePerHour(ingredient);
+    return (rate > 0.0) ? left / rate : numeric_limits<double>::infinity();
+}
+
+/******************************************************************
+ * Function: printForecast
+ * ---------------------------------------------------------------
+ * One line per ingredient: stock, used, remaining, hourly rate
+ * and projected hours until it runs out.
+ ******************************************************************/
+void printForecast(const InventoryForecast& forecast, ostream& out) {
+    static const char* const NAMES[INGREDIENT_COUNT] = {"beans (g)", "milk (mL)"};
+
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << fixed << setprecision(2);
+
+    out << "inventory: " << forecast.orders() << " orders, rate over the last "
+        << forecast.rateSpanSeconds() / 60 << " min\n";
+    for (size_t i = 0; i < INGREDIENT_COUNT; ++i) {
+        Ingredient ingredient = static_cast<Ingredient>(i);
+        out << "  " << left << setw(10) << NAMES[i] << right
+            << " stock " << setw(12) << forecast.stock(ingredient)
+            << "  used " << setw(12) << forecast.consumed(ingredient)
+            << "  left " << setw(12) << forecast.remaining(ingredient)
+            << "  rate/h " << setw(11) << forecast.ratePerHour(ingredient)
+            << "  empty in ";
+        double hours = forecast.hoursToEmpty(ingredient);
+        if (isinf(hours)) out << "never\n";
+        else out << hours << " h\n";
+    }
+    if (forecast.late() > 0)
+        out << "  (" << forecast.late() << " orders are older than the rate window: used, not in the rate)\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
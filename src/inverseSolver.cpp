@@ -0,0 +1,153 @@
+#include "inverseSolver.hpp"
+#include "constants.hpp"
+#include "drinkComposition.hpp"
+#include "recipeKernels.hpp"
+#include <cmath>
+using namespace std;
+
+namespace {
+
+// sizes are searched up to these, the most an order may ask for
+constexpr int MAX_SOLVED_SHOTS = ORDER_MAX_SHOTS;
+constexpr double MAX_SOLVED_CUPS = ORDER_MAX_CUPS;
+
+// amount for base shots (rounded as DrinkComposition does), or NaN if the latte cannot be made
+double latteAmount(const SizingModel& m, int base) {
+    int total;
+    if (!wholeShots(base * m.shotScale + m.shotOffset, total) || total <= 0) return NAN;
+    return m.perUnit * total + m.fixed;
+}
+
+// float slack so a size that lands exactly on the target is accepted
+bool atMost(double a, double target)  { return a <= target + 1e-9 * fabs(target); }
+bool atLeast(double a, double target) { return a >= target - 1e-9 * fabs(target); }
+
+} // namespace
+
+/******************************************************************
+ * Function: sizingModel
+ * ---------------------------------------------------------------
+ * Folds the recipe, the fused add-on coefficients and the milk
+ * target into one line per drink. For a latte of n total shots:
+ *
+ *   grounds = n * gramsPerShot * sG + oG
+ *   espresso = grounds * ratio'          (ratio' = brew ratio after add-ons)
+ *   final = espresso * (1 + milkRatio * sM) + oM
+ *
+ * (s, o = scale and offset of each quantity; milk terms only with
+ * a milk target). Coffee is cups * mL or grams per cup, likewise.
+ ******************************************************************/
+SizingModel sizingModel(const Order& order, SizeBy by) {
+    SizingModel m;
+    m.drink = order.drink;
+
+    DrinkComposition drink;
+    composeOrder(order, drink);
+    const AddOnEffect& e = drink.effect();
+    auto scale = [&e](Quantity q) { return e.scale[indexOf(q)]; };
+    auto offset = [&e](Quantity q) { return e.offset[indexOf(q)]; };
+
+    if (order.drink == DrinkType::Coffee) {
+        const CoffeeRecipe& rec = COFFEE_RECIPES(order.strength, order.roast);
+        if (rec.ratio == 0.0) return m;
+        Quantity q = (by == SizeBy::Beans) ? Quantity::Grams : Quantity::Water;
+        double perCup = (by == SizeBy::Beans) ? rec.gramsPerCup : ML_PER_CUP;
+        m.perUnit = perCup * scale(q);
+        m.fixed = offset(q);
+    } else {
+        const LatteRecipe& rec = LATTE_RECIPES(order.shotSize, order.strength);
+        if (rec.brewRatio == 0.0) return m;
+        m.shotScale = scale(Quantity::Shots);
+        m.shotOffset = offset(Quantity::Shots);
+
+        double gramsPerShot = rec.gramsPerShot * scale(Quantity::Grams);
+        if (by == SizeBy::Beans) {
+            m.perUnit = gramsPerShot;
+            m.fixed = offset(Quantity::Grams);
+        } else {
+            double ratio = e.apply(Quantity::BrewRatio, rec.brewRatio);
+            bool milk = order.milkStyle != MilkStyle::None;
+            double volumePerEspresso = milk ? 1.0 + order.milkRatio * scale(Quantity::Milk) : 1.0;
+            m.perUnit = gramsPerShot * ratio * volumePerEspresso;
+            m.fixed = offset(Quantity::Grams) * ratio * volumePerEspresso
+                    + (milk ? offset(Quantity::Milk) : 0.0);
+        }
+    }
+    m.ok = m.perUnit > 0.0 && (m.drink == DrinkType::Coffee || m.shotScale > 0.0);
+    return m;
+}
+
+/******************************************************************
+ * Function: solveSize
+ * ---------------------------------------------------------------
+ * Inverts the line. Coffee: cups = (amount - fixed) / perUnit.
+ * Latte: total shots from the line, base shots by undoing the
+ * shot add-ons, then the neighbouring whole counts are checked
+ * against the rounding policy (Down: largest size not over the
+ * amount; Up: smallest not under; Nearest: closest, ties down).
+ * At least one base shot; fails if the policy cannot be met or
+ * the size would be past ORDER_MAX_CUPS / ORDER_MAX_SHOTS.
+ ******************************************************************/
+SizedDrink solveSize(const SizingModel& m, double amount, ShotRounding rounding) {
+    SizedDrink out;
+    if (!m.ok || !(amount > 0.0) || !isfinite(amount)) return out;
+
+    if (m.drink == DrinkType::Coffee) {
+        out.cups = (amount - m.fixed) / m.perUnit;
+        if (!(out.cups > 0.0 && out.cups <= MAX_SOLVED_CUPS)) return out;
+        out.amount = m.perUnit * out.cups + m.fixed;
+        out.ok = true;
+        return out;
+    }
+
+    double total = (amount - m.fixed) / m.perUnit;
+    double base = (total - m.shotOffset) / m.shotScale;
+    if (!(base < MAX_SOLVED_SHOTS)) return out;
+    int lo = max(1, static_cast<int>(floor(base)));
+    int hi = max(1, static_cast<int>(ceil(base)));
+
+    // shot rounding can move a neighbour across the target; walk to the right one
+    int shots;
+    if (rounding == ShotRounding::Up) {
+        shots = lo;
+        while (shots < MAX_SOLVED_SHOTS && !atLeast(latteAmount(m, shots), amount)) ++shots;
+        if (!atLeast(latteAmount(m, shots), amount)) return out;
+    } else if (rounding == ShotRounding::Down) {
+        shots = hi;
+        while (shots > 1 && !atMost(latteAmount(m, shots), amount)) --shots;
+        if (!atMost(latteAmount(m, shots), amount)) return out;
+    } else {
+        double a = latteAmount(m, lo), b = latteAmount(m, hi);
+        shots = (isnan(a) || fabs(b - amount) < fabs(a - amount)) ? hi : lo;
+    }
+
+    out.amount = latteAmount(m, shots);
+    if (isnan(out.amount)) return out;
+    out.shots = shots;
+    out.ok = true;
+    return out;
+}
+
+bool sizeOrder(Order& order) {
+    if (order.sizeBy == SizeBy::None) return true;
+    SizedDrink size = solveSize(sizingModel(order, order.sizeBy), order.sizeAmount, order.rounding);
+    if (!size.ok) return false;
+    if (order.drink == DrinkType::Coffee) order.cups = size.cups;
+    else order.shots = size.shots;
+    return true;
+}
+
+size_t solveMenu(const Order* drinks, size_t drinkCount,
+                 const double* amounts, size_t amountCount,
+                 SizeBy by, ShotRounding rounding, SizedDrink* out) {
+    size_t solved = 0;
+    for (size_t d = 0; d < drinkCount; ++d) {
+        SizingModel model = sizingModel(drinks[d], by);
+        SizedDrink* row = out + d * amountCount;
+        for (size_t a = 0; a < amountCount; ++a) {
+            row[a] = solveSize(model, amounts[a], rounding);
+            solved += row[a].ok;
+        }
+    }
+    return solved;
+}
@@ -6,17 +6,40 @@
 #include "presets.hpp"
 
 #include "addons.hpp"
+#include "consoleInput.hpp"
+#include "orderCache.hpp"
+#include "orderAnalytics.hpp"
 
 using namespace std;
 
+namespace {
+
+// positive number for a count prompt; a bad entry drops the rest of the line, as before
+template <typename T>
+bool parseCount(ConsoleInput& in, string_view word, T& out) {
+    if (parseNumber(word, out) && out > 0) return true;
+    in.skipLine();
+    return false;
+}
+
+} // namespace
+
+// opens the persistent preset store; falls back to memory-only presets
+MachineDisplay::MachineDisplay(ConsoleInput& input) : in(input) {
+    if (presetStore.open(DEFAULT_PRESET_STORE))
+        presetManager.attachStore(&presetStore);
+    else
+        cout << "Note: presets will not be saved (cannot open " << DEFAULT_PRESET_STORE << ").\n";
+}
+
 // displays the interface for the user to select: coffee or latte
 void MachineDisplay::run(char &again){
     
-    while ( again == 'y' ){
+    while ( again == 'y' && !in.atEnd() ){
         
         cout << "\n=== Coffee & Latte Ratio Calculator ===";
         
-        int option;
+        int option = 0;
         
         
         cout << "\n            === Menu ===\n"
@@ -25,26 +48,21 @@ void MachineDisplay::run(char &again){
              << "          3) Load a preset\n\n"
              << "Enter option: ";
         
-        cin >> option;
+        in.number(option);
         
         switch(option){
         
             case 1: {
                 
-                bool valid = false;
-                string drinkType;
+                DrinkType drink = DrinkType::Coffee;
                 
                 // Choose drink type
-                while (!valid) {
-                    cout << "Choose drink (coffee or latte): ";
-                    cin >> drinkType;
-                    string d = toLowerCopy(drinkType);
-                    if (d == "coffee" || d == "latte") valid = true;
-                    else cout << "Invalid input. Please enter 'coffee' or 'latte'.\n";
-                }
-                string drink = toLowerCopy(drinkType);
+                if (!promptUntil(in, "Choose drink (coffee or latte): ",
+                                 "Invalid input. Please enter 'coffee' or 'latte'.\n",
+                                 [&](string_view w) { return parseDrinkType(w, drink); }))
+                    break;
                     
-                if (drink == "coffee")
+                if (drink == DrinkType::Coffee)
                     handleCoffee();
                 else
                     handleLatte();
@@ -74,65 +92,46 @@ void MachineDisplay::run(char &again){
 void MachineDisplay::handleCoffee(){
     
     
-            string roastType, strength;
+            Roast roast = Roast::Medium;
+            Strength strength = Strength::Medium;
             double cups = 0.0;
 
             // Roast selection
-            bool validRoast = false;
-            while (!validRoast) {
-                cout << "Enter bean roast type (light, medium, dark): ";
-                cin >> roastType;
-                string r = toLowerCopy(roastType);
-                if (r == "light" || r == "medium" || r == "dark") validRoast = true;
-                else cout << "Invalid roast. Please enter light, medium, or dark.\n";
-            }
+            if (!promptUntil(in, "Enter bean roast type (light, medium, dark): ",
+                             "Invalid roast. Please enter light, medium, or dark.\n",
+                             [&](string_view w) { return parseRoast(w, roast); }))
+                return;
 
             // Strength
-            bool validStrength = false;
-            while (!validStrength) {
-                cout << "Enter coffee strength (bolder, medium, weaker): ";
-                cin >> strength;
-                string s = toLowerCopy(strength);
-                if (s == "bolder" || s == "medium" || s == "weaker") validStrength = true;
-                else cout << "Invalid strength. Please enter bolder, medium, or weaker.\n";
-            }
-
-            // Cups (numeric do-while)
-            bool validCups;
-            do {
-                validCups = true;
-                cout << "Enter desired coffee amount (in cups): ";
-                cin >> cups;
-                if (cin.fail() || cups <= 0) {
-                    cin.clear();
-                    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                    cout << "Invalid amount. Please enter a positive number.\n";
-                    validCups = false;
-                }
-            } while (!validCups);
-
-            CoffeeResult r;
-            if (calcCoffee(strength, roastType, cups, r)) {
+            if (!promptUntil(in, "Enter coffee strength (bolder, medium, weaker): ",
+                             "Invalid strength. Please enter bolder, medium, or weaker.\n",
+                             [&](string_view w) { return parseStrength(w, strength) && isCoffeeStrength(strength); }))
+                return;
+
+            // Cups (numeric; a bad entry drops the rest of the line)
+            if (!promptUntil(in, "Enter desired coffee amount (in cups): ",
+                             "Invalid amount. Please enter a positive number.\n",
+                             [&](string_view w) { return parseCount(in, w, cups); }))
+                return;
+
+            DrinkComposition drink;
+            drink.setCoffee(strength, roast, cups);
+            if (drink.valid()) {
                 
                 //Add-ons option
-                char addOns;
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                cout << "Would you like add-ons? (y/n): ";
-                cin >> addOns;
-                addOns = tolower(addOns);
-                
-                while (addOns != 'y' && addOns != 'n') {
-                   cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                   cout << "Invalid input. Enter 'y' or 'n': ";
-                   cin >> addOns;
-                   addOns = tolower(addOns);
-                }
+                in.skipLine();
+                char addOns = promptYesNo(in, "Would you like add-ons? (y/n): ",
+                                          "Invalid input. Enter 'y' or 'n': ");
                 
                 if(addOns == 'y'){
-                    handleCoffeeAddOns(r);
+                    handleCoffeeAddOns(in, drink);
                 }
                 
-                printCoffeeSummary(r, roastType, strength);
+                CoffeeResult r;
+                drink.evaluate(r);
+                printCoffeeSummary(r, roast, strength);
+                sharedAnalytics().record(analyticsNow(), 0, DrinkType::Coffee,
+                                         drink.caffeineMg(), r.coffeeGrams, 0.0);
             
             } else {
                 cout << "Calculation error.\n";
@@ -144,125 +143,81 @@ void MachineDisplay::handleCoffee(){
 // if the user selects latte
 void MachineDisplay::handleLatte(){
     // LATTE SECTION
-    string strength, shotSize;
+    Strength strength = Strength::Stronger;
+    ShotSize shotSize = ShotSize::Single;
     int shots = 0;
 
     // Strength selection
-    bool validLStrength = false;
-    string calcStrength;  
-
-    while (!validLStrength) {
-        cout << "Enter latte strength (stronger or weaker): ";
-        cin >> strength;
-    
-        string s = toLowerCopy(strength);
-    
-        if (s == "stronger" || s == "weaker") {
-            calcStrength = s;   
-            validLStrength = true;
-        } 
-        else {
-            cout << "Invalid input. Please enter 'stronger' or 'weaker'.\n";
-        }
-    }
+    if (!promptUntil(in, "Enter latte strength (stronger or weaker): ",
+                     "Invalid input. Please enter 'stronger' or 'weaker'.\n",
+                     [&](string_view w) { return parseStrength(w, strength) && isLatteStrength(strength); }))
+        return;
 
     // Shot size
-    bool validShotSize = false;
-    while (!validShotSize) {
-        cout << "Shot size (single = 8g, double = 16g): ";
-        cin >> shotSize;
-        string ss = toLowerCopy(shotSize);
-        if (ss == "single" || ss == "double") validShotSize = true;
-        else cout << "Invalid shot size. Enter single or double.\n";
-    }
+    if (!promptUntil(in, "Shot size (single = 8g, double = 16g): ",
+                     "Invalid shot size. Enter single or double.\n",
+                     [&](string_view w) { return parseShotSize(w, shotSize); }))
+        return;
 
     // Number of shots
-    bool validShots;
-    do {
-        validShots = true;
-        cout << "How many shots? ";
-        cin >> shots;
-        if (cin.fail() || shots <= 0) {
-            cin.clear();
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-            cout << "Invalid input. Enter a positive whole number.\n";
-            validShots = false;
-        }
-    } while (!validShots);
+    if (!promptUntil(in, "How many shots? ",
+                     "Invalid input. Enter a positive whole number.\n",
+                     [&](string_view w) { return parseCount(in, w, shots); }))
+        return;
 
-    LatteResult r;
-    if (!calcLatteFromShots(strength, shotSize, shots, r)) {
+    DrinkComposition drink;
+    drink.setLatte(strength, shotSize, shots);
+    if (!drink.valid()) {
         cout << "Calculation error.\n";
         return;
     }
     
     //Add-ons option
-    char addOns;
-    cout << "Would you like add-ons? (y/n): ";
-    cin >> addOns;
-    addOns = tolower(addOns);
-    
-    while (addOns != 'y' && addOns != 'n') {
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-        cout << "Invalid input. Enter 'y' or 'n': ";
-        cin >> addOns;
-        addOns = tolower(addOns);
-    }
+    char addOns = promptYesNo(in, "Would you like add-ons? (y/n): ",
+                              "Invalid input. Enter 'y' or 'n': ");
     
     if(addOns == 'y'){
-        handleLatteAddOns(r);
+        handleLatteAddOns(in, drink);
     }
 
     // Milk style selection
-    string milkStyle;
+    MilkStyle milkStyle = MilkStyle::None;
     double ratio = 0.0;
-    bool validMilkStyle = false;
-    while (!validMilkStyle) {
-        cout << "Milk target style (none/cortado/flatwhite/latte/custom): ";
-        cin >> milkStyle;
-        ratio = milkStyleToRatio(milkStyle);
-        if (ratio == -2.0)
-            cout << "Invalid milk style. Try again.\n";
-        else validMilkStyle = true;
-    }
+    if (!promptUntil(in, "Milk target style (none/cortado/flatwhite/latte/custom): ",
+                     "Invalid milk style. Try again.\n",
+                     [&](string_view w) { return parseMilkStyle(w, milkStyle); }))
+        return;
+    ratio = milkStyleToRatio(milkStyle);
 
     // Custom ratio entry
-    if (ratio == -1.0) {
-        bool validCustom;
-        do {
-            validCustom = true;
-            cout << "Enter milk:espresso ratio (e.g., 2.5 means milk is 2.5x espresso): ";
-            cin >> ratio;
-            if (cin.fail() || ratio < 0.0) {
-                cin.clear();
-                cin.ignore(numeric_limits<streamsize>::max(), '\n');
-                cout << "Invalid ratio. Enter a non-negative number.\n";
-                validCustom = false;
-            }
-        } while (!validCustom);
+    if (milkStyle == MilkStyle::Custom) {
+        bool validRatio = promptUntil(in, "Enter milk:espresso ratio (e.g., 2.5 means milk is 2.5x espresso): ",
+                                      "Invalid ratio. Enter a non-negative number.\n",
+                                      [&](string_view w) {
+                                          if (parseNumber(w, ratio) && ratio >= 0.0) return true;
+                                          in.skipLine();
+                                          return false;
+                                      });
+        if (!validRatio) return;
     }
 
-    if (toLowerCopy(milkStyle) != "none") {
-        r.hasMilkTarget = true;
-        r.milkStyle = milkStyle;
-        r.milkToEspRatio = ratio;
-        r.milkML = r.espressoML * r.milkToEspRatio;
-        r.milkCups = r.milkML / ML_PER_CUP;
-        r.finalML = r.espressoML + r.milkML;
-        r.finalCups = r.finalML / ML_PER_CUP;
-    }
-
-    printLatteSummary(r, calcStrength, milkStyle);
+    // volumes are derived once, after every stage is known
+    drink.setMilkTarget(milkStyle, ratio);
+    LatteResult r;
+    drink.evaluate(r);
+    printLatteSummary(r, strength);
+    sharedAnalytics().record(analyticsNow(), 0, DrinkType::Latte,
+                             drink.caffeineMg(), r.coffeeGrams, r.milkML);
 }
 
 // prompts the user if they want to continue or not
 char MachineDisplay::askRepeat(char &again){
     
-    // Repeat prompt (validated)
+    // Repeat prompt (validated); end of input means no
     do {
         cout << "\nWould you like to perform another calculation? (y/n): ";
-        cin >> again;
-        again = static_cast<char>(tolower(static_cast<unsigned char>(again)));
+        again = in.letter();
+        if (again == '\0') again = 'n';
         if (again != 'y' && again != 'n') {
             cout << "Please enter 'y' or 'n'.\n";
         }
@@ -277,72 +232,101 @@ void MachineDisplay::createPreset() {
     cout << "\n=== Create Preset ===\n";
     
     // naming the present ( object )
-    string presetName;
     cout << "Enter a name for this preset: ";
-    cin >> presetName;
+    // valid until the next prompt reads
+    string_view presetName = in.word();
+    if (presetName.empty()) return;
+    if (!presetNameFits(presetName)) {
+        cout << "Preset names can be at most " << PRESET_NAME_MAX << " characters.\n";
+        return;
+    }
+
+    // names are unique keys
+    if (presetManager.contains(presetName)) {
+        cout << "A preset named '" << presetName << "' already exists.\n";
+        return;
+    }
 
     // creating the object
     Presets preset(presetName);
 
     // prompting user to enter drink choice
-    string drinkChoice;
+    DrinkType drinkChoice;
     cout << "Is this a coffee or latte preset? ";
-    cin >> drinkChoice;
 
-    // makes sure its all lowerCase
-    drinkChoice = toLowerCopy(drinkChoice);
+    // if coffee or latte is not inputted
+    if (!parseDrinkType(in.word(), drinkChoice)) {
+        cout << "Invalid type.\n";
+        return;
+    }
 
     // prompting user to enter data for their choice of drink
-    if (drinkChoice == "coffee") {
+    if (drinkChoice == DrinkType::Coffee) {
 
-        string roast, strength;
-        double cups;
+        Roast roast;
+        Strength strength;
+        double cups = 0.0;
 
         cout << "Enter bean roast type (light, medium, dark): ";
-        cin >> roast;
+        if (!parseRoast(in.word(), roast)) {
+            cout << "Invalid roast.\n";
+            return;
+        }
 
         cout << "Enter coffee strength (bolder, medium, weaker): ";
-        cin >> strength;
+        if (!parseStrength(in.word(), strength) || !isCoffeeStrength(strength)) {
+            cout << "Invalid strength.\n";
+            return;
+        }
 
         cout << "Enter desired coffee amount (in cups): ";
-        cin >> cups;
+        in.number(cups);
 
         preset.setCoffee(roast, strength, cups);
     }
-    else if (drinkChoice == "latte") {
+    else {
 
-        string shotSize, strength, milk;
-        int shots;
+        ShotSize shotSize;
+        Strength strength;
+        MilkStyle milk;
+        int shots = 0;
         double ratio = 0.0;
 
         cout << "Enter latte strength (stronger or weaker): ";
-        cin >> strength;
+        if (!parseStrength(in.word(), strength) || !isLatteStrength(strength)) {
+            cout << "Invalid strength.\n";
+            return;
+        }
         
         cout << "Shot size (single = 8g, double = 16g): ";
-        cin >> shotSize;
+        if (!parseShotSize(in.word(), shotSize)) {
+            cout << "Invalid shot size.\n";
+            return;
+        }
 
         cout << "How many shots? ";
-        cin >> shots;
+        in.number(shots);
 
         cout << "Milk target style (none/cortado/latte/flatwhite/custom): ";
-        cin >> milk;
+        if (!parseMilkStyle(in.word(), milk)) {
+            cout << "Invalid milk style.\n";
+            return;
+        }
 
-        string milkLower = toLowerCopy(milk);
-        if (milkLower == "custom") {
+        ratio = milkStyleToRatio(milk);
+        if (milk == MilkStyle::Custom) {
             cout << "Enter milk:espresso ratio (e.g., 2.5 means milk is 2.5x espresso): ";
-            cin >> ratio;
+            in.number(ratio);
         }
 
         preset.setLatte(shotSize, shots, strength, milk, ratio);
     }
-    // if coffee or latte is not inputted
-    else {
-        cout << "Invalid type.\n";
-        return;
-    }
 
     // if object is created / stored properly
-    presetManager.addPreset(preset);
+    if (!presetManager.addPreset(preset).valid()) {
+        cout << "\nCould not save preset.\n";
+        return;
+    }
     cout << "\nPreset saved!\n";
 }
 
@@ -357,9 +341,12 @@ void MachineDisplay::loadPreset() {
     presetManager.listPresets();
 
     // calling object via name entered by user
-    string name;
     cout << "\nEnter preset name: ";
-    cin >> name;
+    string_view name = in.word();
+    if (!presetNameFits(name)) {
+        cout << "Preset names can be at most " << PRESET_NAME_MAX << " characters.\n";
+        return;
+    }
 
     Presets* p = presetManager.getPresetByName(name);
 
@@ -374,61 +361,21 @@ void MachineDisplay::loadPreset() {
 
     cout << "\n=== Calculated Drink Summary ===\n";
 
-    // COFFEE PRESET
-    if (p->getDrinkType() == "coffee") {
+    // repeat loads of a preset come from the result cache
+    Order order;
+    presetOrder(*p, order);
 
-        CoffeeResult r;
-
-        bool ok = calcCoffee(
-            p->getStrength(),
-            p->getRoast(),
-            p->getCups(),
-            r
-        );
-
-        if (!ok) {
-            cout << "Error calculating preset.\n";
-            return;
-        }
-
-        printCoffeeSummary(r, p->getRoast(), p->getStrength());
+    OrderResult result;
+    if (!computeOrderCached(order, result)) {
+        cout << "Error calculating preset.\n";
+        return;
     }
 
-    // LATTE PRESET
-    else {
-
-        LatteResult r;
-
-        // if program can properly calculate latte from user data
-        bool ok = calcLatteFromShots(
-            p->getLatteStrength(),
-            p->getShotSize(),
-            p->getShots(),
-            r
-        );
-
-        // if program cant properly caluate latte from user data
-        if (!ok) {
-            cout << "Error calculating preset.\n";
-            return;
-        }
-
-        // Apply milk style (if not "none")
-        if (toLowerCopy(p->getMilkStyle()) != "none") {
-
-            r.hasMilkTarget = true;
-            r.milkStyle = p->getMilkStyle();
-            r.milkToEspRatio = p->getMilkRatio();
-
-            r.milkML = r.espressoML * r.milkToEspRatio;
-            r.milkCups = r.milkML / ML_PER_CUP;
-            r.finalML = r.espressoML + r.milkML;
-            r.finalCups = r.finalML / ML_PER_CUP;
-        }
-
-        // print summary
-        printLatteSummary(r, p->getLatteStrength(), p->getMilkStyle());
-    }
+    if (order.drink == DrinkType::Coffee)
+        printCoffeeSummary(result.coffee, p->getRoast(), p->getStrength());
+    else
+        printLatteSummary(result.latte, p->getLatteStrength());
+    recordOrder(sharedAnalytics(), order, result, analyticsNow());
 }
 
 
@@ -32,6 +32,36 @@
  *   - Required water or espresso volume (cups and mL)
  *   - Coffee grounds (grams and tablespoons)
  *   - Optional milk and final latte size
+ *
+ * Batch mode:
+ *   final_project --batch [file] [--format=csv|jsonl] [--threads=N] [--stats]
+ *                 [--inventory=<beans g>,<milk mL>]
+ *   streams order records (see orderRecord.hpp) from the file or
+ *   stdin and writes one CSV/JSONL row per order, no prompts.
+ *   --stats adds a consumption report (orderAnalytics.hpp) and
+ *   --inventory a stock forecast (inventoryForecast.hpp) on stderr.
+ *   --menu=<file> answers standard orders from an exported table.
+ *   --engine=fixed does the recipe math in fixed point
+ *   (fixedRecipe.hpp) instead of doubles.
+ *
+ * Menu table:
+ *   final_project --export-menu [file]
+ *   writes every standard order, precomputed (see menuTable.hpp).
+ *
+ * Daemon mode:
+ *   final_project --serve [socket] [--format=csv|jsonl] [--menu=<file>]
+ *   answers pipelined record lines or binary frames on a Unix
+ *   domain socket until SIGINT/SIGTERM (see orderServer.hpp).
+ *
+ * Replay mode:
+ *   final_project --replay <trace> [--repeat=N]
+ *   drives the GUI's state machine from a recorded key trace (see
+ *   uiReplay.hpp) without a window and reports events/s.
+ *
+ * Probes (any mode):
+ *   --profile[=sec] prints probe timings (instrumentation.hpp) on
+ *   stderr at exit, and every sec seconds if given;
+ *   --trace=<file> writes them as Chrome trace-event JSON.
  ******************************************************************/
 
 #include <iostream>
@@ -39,22 +69,232 @@
 #include <string>
 #include <algorithm>
 #include <cctype>    // for std::tolower
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <limits>    // for std::numeric_limits
+#include <sstream>
 using namespace std;
 
 #include "machineDisplay.hpp"
+#include "batchMode.hpp"
+#include "instrumentation.hpp"
+#include "menuTable.hpp"
+#include "orderServer.hpp"
+#include "uiReplay.hpp"
+
+/******************************************************************
+ * Function: printUsage
+ * ---------------------------------------------------------------
+ * Prints command-line options.
+ ******************************************************************/
+void printUsage(const char* prog) {
+    cout << "Usage: " << prog << " [--batch [file] [--format=csv|jsonl] [--threads=N] [--stats]\n"
+         << "       " << string(strlen(prog), ' ') << "                 [--inventory=<beans g>,<milk mL>] [--menu=<file>]\n"
+         << "       " << string(strlen(prog), ' ') << "                 [--engine=double|fixed]]\n"
+         << "       " << prog << " --replay <trace> [--repeat=N]\n"
+         << "       " << prog << " --export-menu [file]\n"
+         << "       " << prog << " --serve [socket] [--format=csv|jsonl] [--menu=<file>]\n"
+         << "  (no options)        interactive calculator\n"
+         << "  --batch [file]      process order records from file or stdin\n"
+         << "  --format=csv|jsonl  batch output format (default csv)\n"
+         << "  --threads=N         batch worker threads (default: one per core)\n"
+         << "  --stats             batch consumption report on stderr\n"
+         << "  --inventory=G,ML    batch bean/milk stock forecast on stderr\n"
+         << "  --menu=<file>       batch menu table from --export-menu\n"
+         << "  --engine=E          batch recipe math: double (default) or fixed point\n"
+         << "  --replay <trace>    replay a GUI key trace headlessly\n"
+         << "  --repeat=N          replay the trace N times (default 1)\n"
+         << "  --export-menu       write the precomputed menu table (default menu.bin)\n"
+         << "  --serve [socket]    answer orders on a Unix socket (default final_project.sock)\n"
+         << "  --profile[=sec]     probe timings on stderr at exit (and every sec seconds)\n"
+         << "  --trace=<file>      probe timings as Chrome trace-event JSON\n";
+}
+
+// "<beans g>,<milk mL>", both non-negative
+bool parseStock(const string& value, double& beans, double& milk) {
+    size_t comma = value.find(',');
+    if (comma == string::npos) return false;
+    const char* text = value.c_str();
+    char* end = nullptr;
+    beans = strtod(text, &end);
+    if (end != text + comma || comma == 0) return false;
+    milk = strtod(text + comma + 1, &end);
+    return end == text + value.size() && comma + 1 < value.size() && beans >= 0.0 && milk >= 0.0;
+}
+
+/******************************************************************
+ * Function: printReplayScreen
+ * ---------------------------------------------------------------
+ * Prints the summary or error text the GUI would have shown.
+ ******************************************************************/
+void printReplayScreen(const UiMachine& machine) {
+    const UiState& ui = machine.state();
+    cout << (ui.screen == Screen::Summary ? ui.summary : ui.message) << '\n';
+}
+
+/******************************************************************
+ * Function: runReplay
+ * ---------------------------------------------------------------
+ * Replays a recorded GUI trace through a UiMachine. The first pass
+ * prints every summary; timing and the digest go to stderr. The
+ * presets live in memory only, so presets.bin is never touched.
+ *
+ * Returns:
+ *   0 on success, 1 if the trace cannot be read or parsed.
+ ******************************************************************/
+int runReplay(const string& path, unsigned long repeat) {
+    ifstream in(path, ios::binary);
+    if (!in) {
+        cerr << "replay: cannot open " << path << endl;
+        return 1;
+    }
+    stringstream text;
+    text << in.rdbuf();
+
+    vector<UiEvent> events;
+    size_t errorLine = 0;
+    if (!parseUiTrace(text.str(), events, errorLine)) {
+        cerr << "replay: " << path << ":" << errorLine << ": unknown event" << endl;
+        return 1;
+    }
+
+    ReplayStats first;
+    size_t total = 0;
+    auto start = chrono::steady_clock::now();
+    for (unsigned long r = 0; r < repeat; ++r) {
+        PresetManager presets;
+        UiMachine machine(presets);
+        ReplayStats stats = replayUiTrace(machine, events, r == 0 ? printReplayScreen : nullptr);
+        if (r == 0) first = stats;
+        total += stats.events;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cerr << "replay: " << first.events << " events, " << first.summaries << " summaries, "
+         << first.errors << " errors, digest " << hex << first.digest << dec << '\n'
+         << "replay: " << total << " events in " << fixed << setprecision(3) << seconds << " s ("
+         << setprecision(0) << (seconds > 0 ? total / seconds : 0.0) << " events/s)" << endl;
+    return 0;
+}
 
 /******************************************************************
  * Function: main
  * ---------------------------------------------------------------
  * Main driver function. Handles user interaction, input validation,
  * and displays results for either coffee or latte calculations.
- * Allows repeating the session via a do-while loop.
+ * Allows repeating the session via a do-while loop. With --batch,
+ * runs the non-interactive order stream instead.
  *
  * Returns:
  *   0 on successful execution.
  ******************************************************************/
-int main() {
+int main(int argc, char* argv[]) {
+    bool batch = false;
+    bool serve = false;
+    BatchOptions options;
+    ServerOptions server;
+    bool profile = false;
+    unsigned profileEvery = 0;
+    string tracePath;
+    string replayPath;
+    unsigned long replayRepeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--batch") {
+            batch = true;
+            string next = (i + 1 < argc) ? argv[i + 1] : "";
+            if (!next.empty() && (next == "-" || next[0] != '-'))
+                options.inputPath = argv[++i];
+        } else if (arg == "--format=csv") {
+            options.format = OutputFormat::Csv;
+        } else if (arg == "--format=jsonl") {
+            options.format = OutputFormat::Jsonl;
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            string value = arg.substr(10);
+            if (value.empty() || value.size() > 4 || value.find_first_not_of("0123456789") != string::npos) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.threads = static_cast<unsigned>(stoul(value));
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg.rfind("--inventory=", 0) == 0) {
+            if (!parseStock(arg.substr(12), options.beansStockG, options.milkStockML)) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            options.inventory = true;
+        } else if (arg.rfind("--menu=", 0) == 0 && arg.size() > 7) {
+            options.menuPath = arg.substr(7);
+        } else if (arg == "--engine=double") {
+            options.engine = CalcEngine::Double;
+        } else if (arg == "--engine=fixed") {
+            options.engine = CalcEngine::Fixed;
+        } else if (arg == "--export-menu") {
+            string path = (i + 1 < argc && argv[i + 1][0] != '-') ? argv[++i] : DEFAULT_MENU_TABLE;
+            MenuTable table;
+            table.build();
+            if (!table.save(path)) {
+                cerr << "cannot write " << path << "\n";
+                return 1;
+            }
+            cerr << "wrote " << MENU_ENTRIES << " menu entries to " << path << "\n";
+            return 0;
+        } else if (arg == "--serve") {
+            serve = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') server.socketPath = argv[++i];
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg.rfind("--profile=", 0) == 0) {
+            string value = arg.substr(10);
+            if (value.empty() || value.size() > 5 || value.find_first_not_of("0123456789") != string::npos) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            profile = true;
+            profileEvery = static_cast<unsigned>(stoul(value));
+        } else if (arg.rfind("--trace=", 0) == 0 && arg.size() > 8) {
+            tracePath = arg.substr(8);
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg.rfind("--repeat=", 0) == 0) {
+            string value = arg.substr(9);
+            if (value.empty() || value.size() > 9 || value.find_first_not_of("0123456789") != string::npos
+                || stoul(value) == 0) {
+                printUsage(argv[0]);
+                return 1;
+            }
+            replayRepeat = stoul(value);
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    ProbeSession probes(profile, profileEvery, tracePath);
+
+    if (!replayPath.empty())
+        return runReplay(replayPath, replayRepeat);
+
+    if (serve) {
+        server.format = options.format;
+        server.menuPath = options.menuPath;
+        return runServer(server);
+    }
+
+    if (batch) {
+        // batch output bypasses iostreams entirely
+        ios::sync_with_stdio(false);
+        return runBatch(options);
+    }
+
+    // prompts read through ConsoleInput, which flushes cout before it blocks
+    ios::sync_with_stdio(false);
     cout << fixed << setprecision(2);
 
     char again = 'y';
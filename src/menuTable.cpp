@@ -0,0 +1,226 @@
+#include "menuTable.hpp"
+#include "constants.hpp"
+#include "recipeKernels.hpp"
+#include <cmath>
+#include <cstring>
+#include <fstream>
+using namespace std;
+
+namespace {
+
+constexpr char     MENU_MAGIC[8] = {'C', 'L', 'M', 'E', 'N', 'U', 'T', 'B'};
+constexpr uint32_t MENU_VERSION  = 1;
+
+struct MenuFileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t entrySize;
+    uint64_t entryCount;
+    uint64_t recipeHash;
+    uint64_t checksum;       // FNV-1a of the entries
+    uint64_t reserved[3];
+};
+
+static_assert(sizeof(MenuFileHeader) == 64, "MenuFileHeader layout is part of the file format");
+
+constexpr MilkStyle MENU_STYLES[MENU_MILK_STYLES] = {
+    MilkStyle::None, MilkStyle::Cortado, MilkStyle::FlatWhite, MilkStyle::Latte};
+
+uint64_t fnv1a(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+size_t coffeeIndex(size_t strength, size_t roast, bool iced, size_t cups) {
+    return ((strength * ROAST_COUNT + roast) * 2 + iced) * MENU_MAX_CUPS + (cups - 1);
+}
+
+size_t latteIndex(size_t shotSize, size_t strength, size_t milk, bool iced, size_t shots) {
+    return MENU_COFFEE_ENTRIES
+         + (((shotSize * MENU_LATTE_STRENGTHS + strength) * MENU_MILK_STYLES + milk) * 2 + iced)
+           * MENU_MAX_SHOTS + (shots - 1);
+}
+
+// table slot of a standard order; false if it must be computed
+bool menuIndex(const Order& o, size_t& index) {
+    if (o.addOnCount > 0) return false;
+
+    if (o.drink == DrinkType::Coffee) {
+        if (!isCoffeeStrength(o.strength)) return false;
+        if (!(o.cups >= 1.0 && o.cups <= MENU_MAX_CUPS) || o.cups != floor(o.cups)) return false;
+        index = coffeeIndex(indexOf(o.strength), indexOf(o.roast), o.iced, static_cast<size_t>(o.cups));
+        return true;
+    }
+
+    if (!isLatteStrength(o.strength) || o.shots <= 0 || o.extraShots < 0) return false;
+    if (o.milkStyle == MilkStyle::Custom) return false;
+    if (o.milkStyle != MilkStyle::None && o.milkRatio != milkStyleToRatio(o.milkStyle)) return false;
+    size_t total = static_cast<size_t>(o.shots) + static_cast<size_t>(o.extraShots);
+    if (total > MENU_MAX_SHOTS) return false;
+    size_t strength = (o.strength == Strength::Stronger) ? 0 : 1;
+    index = latteIndex(indexOf(o.shotSize), strength, indexOf(o.milkStyle), o.iced, total);
+    return true;
+}
+
+MenuEntry pack(const OrderResult& r) {
+    MenuEntry e{};
+    if (r.drink == DrinkType::Coffee) {
+        const CoffeeResult& c = r.coffee;
+        double v[] = {c.waterCups, c.waterML, c.coffeeGrams, c.ratio, c.tablespoons};
+        memcpy(e.value, v, sizeof v);
+    } else {
+        const LatteResult& l = r.latte;
+        double v[] = {l.coffeeGrams, l.brewRatio, l.espressoML, l.espressoCups,
+                      l.tablespoons, l.milkML, l.finalML};
+        memcpy(e.value, v, sizeof v);
+    }
+    e.value[7] = r.caffeineMg;
+    return e;
+}
+
+} // namespace
+
+/******************************************************************
+ * Function: MenuTable::build
+ * ---------------------------------------------------------------
+ * Runs every standard order through computeOrder and packs the
+ * result into its slot.
+ ******************************************************************/
+void MenuTable::build() {
+    vector<MenuEntry> table(MENU_ENTRIES);
+    Order o;
+    OrderResult r;
+
+    o.drink = DrinkType::Coffee;
+    for (size_t s = 0; s < MENU_COFFEE_STRENGTHS; ++s)
+        for (size_t roast = 0; roast < ROAST_COUNT; ++roast)
+            for (bool iced : {false, true})
+                for (size_t cups = 1; cups <= MENU_MAX_CUPS; ++cups) {
+                    o.strength = static_cast<Strength>(s);
+                    o.roast = static_cast<Roast>(roast);
+                    o.iced = iced;
+                    o.cups = static_cast<double>(cups);
+                    computeOrder(o, r);
+                    table[coffeeIndex(s, roast, iced, cups)] = pack(r);
+                }
+
+    o = Order();
+    o.drink = DrinkType::Latte;
+    for (size_t z = 0; z < SHOT_SIZE_COUNT; ++z)
+        for (size_t s = 0; s < MENU_LATTE_STRENGTHS; ++s)
+            for (size_t m = 0; m < MENU_MILK_STYLES; ++m)
+                for (bool iced : {false, true})
+                    for (size_t shots = 1; shots <= MENU_MAX_SHOTS; ++shots) {
+                        o.shotSize = static_cast<ShotSize>(z);
+                        o.strength = (s == 0) ? Strength::Stronger : Strength::Weaker;
+                        o.milkStyle = MENU_STYLES[m];
+                        o.milkRatio = milkStyleToRatio(o.milkStyle);
+                        o.iced = iced;
+                        o.shots = static_cast<int>(shots);
+                        computeOrder(o, r);
+                        table[latteIndex(z, s, m, iced, shots)] = pack(r);
+                    }
+
+    entries.swap(table);
+}
+
+/******************************************************************
+ * Function: MenuTable::lookup
+ * ---------------------------------------------------------------
+ * One load of the order's entry; the fields that are not stored
+ * come from the order or are derived the way evaluate() does.
+ ******************************************************************/
+bool MenuTable::lookup(const Order& order, OrderResult& out) const {
+    size_t index;
+    if (entries.empty() || !menuIndex(order, index)) return false;
+    const double* v = entries[index].value;
+
+    out.drink = order.drink;
+    out.ok = true;
+    out.caffeineMg = v[7];
+    if (order.drink == DrinkType::Coffee) {
+        out.coffee = {v[0], v[1], v[2], v[3], v[4]};
+        return true;
+    }
+
+    LatteResult& l = out.latte;
+    l = LatteResult(order.shots + order.extraShots, order.shotSize, v[0], v[1], v[2], v[3], v[4]);
+    if (order.milkStyle != MilkStyle::None) {
+        l.hasMilkTarget = true;
+        l.milkStyle = order.milkStyle;
+        l.milkToEspRatio = order.milkRatio;
+        l.milkML = v[5];
+        l.milkCups = l.milkML / ML_PER_CUP;
+        l.finalML = v[6];
+        l.finalCups = l.finalML / ML_PER_CUP;
+    }
+    return true;
+}
+
+// the recipe tables, the iced effect and the table shape
+uint64_t MenuTable::recipeHash() {
+    uint64_t h = 1469598103934665603ull;
+    h = fnv1a(h, &COFFEE_RECIPES, sizeof COFFEE_RECIPES);
+    h = fnv1a(h, &LATTE_RECIPES, sizeof LATTE_RECIPES);
+    h = fnv1a(h, &defaultAddOns().spec(ADDON_ICED).effect, sizeof(AddOnEffect));
+    h = fnv1a(h, MILK_RATIO, sizeof MILK_RATIO);
+    const double units[] = {ML_PER_CUP, GRAMS_PER_TBSP, CAFFEINE_PER_CUP_COFFEE, CAFFEINE_PER_SINGLE_SHOT};
+    h = fnv1a(h, units, sizeof units);
+    const uint64_t shape[] = {MENU_MAX_CUPS, MENU_MAX_SHOTS, MENU_COFFEE_ENTRIES, MENU_LATTE_ENTRIES};
+    return fnv1a(h, shape, sizeof shape);
+}
+
+bool MenuTable::save(const string& path) const {
+    if (entries.empty()) return false;
+
+    MenuFileHeader header{};
+    memcpy(header.magic, MENU_MAGIC, sizeof MENU_MAGIC);
+    header.version = MENU_VERSION;
+    header.entrySize = sizeof(MenuEntry);
+    header.entryCount = entries.size();
+    header.recipeHash = recipeHash();
+    header.checksum = fnv1a(1469598103934665603ull, entries.data(), entries.size() * sizeof(MenuEntry));
+
+    ofstream file(path, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof header);
+    file.write(reinterpret_cast<const char*>(entries.data()),
+               static_cast<streamsize>(entries.size() * sizeof(MenuEntry)));
+    return static_cast<bool>(file.flush());
+}
+
+bool MenuTable::load(const string& path) {
+    ifstream file(path, ios::binary);
+    MenuFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof header)) return false;
+    if (memcmp(header.magic, MENU_MAGIC, sizeof MENU_MAGIC) != 0 || header.version != MENU_VERSION
+        || header.entrySize != sizeof(MenuEntry) || header.entryCount != MENU_ENTRIES
+        || header.recipeHash != recipeHash())
+        return false;
+
+    vector<MenuEntry> table(MENU_ENTRIES);
+    if (!file.read(reinterpret_cast<char*>(table.data()),
+                   static_cast<streamsize>(table.size() * sizeof(MenuEntry))))
+        return false;
+    if (fnv1a(1469598103934665603ull, table.data(), table.size() * sizeof(MenuEntry)) != header.checksum)
+        return false;
+
+    entries.swap(table);
+    return true;
+}
+
+MenuTable& sharedMenuTable() {
+    static MenuTable table = [] {
+        MenuTable t;
+        t.build();
+        return t;
+    }();
+    return table;
+}
+
+bool computeOrderFromMenu(const Order& order, OrderResult& out, const MenuTable& table) {
+    return table.lookup(order, out) || computeOrder(order, out);
+}
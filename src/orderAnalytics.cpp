@@ -0,0 +1,300 @@
+#include "orderAnalytics.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+using namespace std;
+
+namespace {
+
+constexpr size_t CELLS_PER_HOUR = ANALYTICS_STORES * DRINK_TYPE_COUNT;
+constexpr size_t CELLS = ANALYTICS_HOURS * CELLS_PER_HOUR;
+
+// slot marker while one writer zeroes it for a new hour
+constexpr int64_t SLOT_RESETTING = INT64_MIN;
+constexpr int64_t SLOT_EMPTY = INT64_MIN + 1;
+
+// mg -> µg, g -> mg, mL -> µL; integer units so concurrent adds are exact
+constexpr double MILLI = 1000.0;
+
+// one record's amount; larger values saturate, so the 64-bit cells
+// take millions of them without wrapping
+constexpr double MAX_RECORD_AMOUNT = 1e9;
+
+uint64_t toUnits(double value, double scale) {
+    if (!(value > 0.0)) return 0;   // also NaN
+    if (!(value < MAX_RECORD_AMOUNT)) value = MAX_RECORD_AMOUNT;
+    return static_cast<uint64_t>(llround(value * scale));
+}
+
+// the stripe this thread writes to, assigned round robin on first use
+size_t threadStripeIndex() {
+    static atomic<size_t> next{0};
+    thread_local size_t index = next.fetch_add(1, memory_order_relaxed) % ANALYTICS_STRIPES;
+    return index;
+}
+
+int64_t hourOf(int64_t unixTime) {
+    return (unixTime >= 0) ? unixTime / 3600 : (unixTime - 3599) / 3600;
+}
+
+size_t slotOf(int64_t hour) {
+    int64_t s = hour % static_cast<int64_t>(ANALYTICS_HOURS);
+    return static_cast<size_t>(s < 0 ? s + static_cast<int64_t>(ANALYTICS_HOURS) : s);
+}
+
+} // namespace
+
+/******************************************************************
+ * Struct: OrderAnalytics::Stripe
+ * ---------------------------------------------------------------
+ * Columnar counters for one group of writer threads. slotHour
+ * says which hour each slot currently holds.
+ ******************************************************************/
+struct OrderAnalytics::Stripe {
+    atomic<int64_t>  slotHour[ANALYTICS_HOURS];
+    atomic<uint64_t> orders[CELLS];
+    atomic<uint64_t> caffeineUg[CELLS];
+    atomic<uint64_t> beansMg[CELLS];
+    atomic<uint64_t> milkUL[CELLS];
+
+    Stripe() {
+        for (atomic<int64_t>& h : slotHour) h.store(SLOT_EMPTY, memory_order_relaxed);
+        for (size_t i = 0; i < CELLS; ++i) {
+            orders[i].store(0, memory_order_relaxed);
+            caffeineUg[i].store(0, memory_order_relaxed);
+            beansMg[i].store(0, memory_order_relaxed);
+            milkUL[i].store(0, memory_order_relaxed);
+        }
+    }
+
+    // makes slot hold hour; false if it already holds a newer one
+    bool claim(size_t slot, int64_t hour) {
+        for (;;) {
+            int64_t cur = slotHour[slot].load(memory_order_acquire);
+            if (cur == hour) return true;
+            if (cur == SLOT_RESETTING) continue;
+            if (cur > hour) return false;
+            if (!slotHour[slot].compare_exchange_weak(cur, SLOT_RESETTING, memory_order_acq_rel))
+                continue;
+            size_t base = slot * CELLS_PER_HOUR;
+            for (size_t i = base; i < base + CELLS_PER_HOUR; ++i) {
+                orders[i].store(0, memory_order_relaxed);
+                caffeineUg[i].store(0, memory_order_relaxed);
+                beansMg[i].store(0, memory_order_relaxed);
+                milkUL[i].store(0, memory_order_relaxed);
+            }
+            slotHour[slot].store(hour, memory_order_release);
+            return true;
+        }
+    }
+};
+
+OrderAnalytics::OrderAnalytics() : stripes(new atomic<Stripe*>[ANALYTICS_STRIPES]) {
+    for (size_t i = 0; i < ANALYTICS_STRIPES; ++i)
+        stripes[i].store(nullptr, memory_order_relaxed);
+}
+
+OrderAnalytics::~OrderAnalytics() {
+    for (size_t i = 0; i < ANALYTICS_STRIPES; ++i)
+        delete stripes[i].load(memory_order_relaxed);
+}
+
+// stripes are allocated on first use; a losing racer frees its copy
+OrderAnalytics::Stripe& OrderAnalytics::stripeForThisThread() {
+    atomic<Stripe*>& slot = stripes[threadStripeIndex()];
+    Stripe* s = slot.load(memory_order_acquire);
+    if (s) return *s;
+    Stripe* fresh = new Stripe();
+    if (slot.compare_exchange_strong(s, fresh, memory_order_acq_rel))
+        return *fresh;
+    delete fresh;
+    return *s;
+}
+
+/******************************************************************
+ * Function: OrderAnalytics::record
+ * ---------------------------------------------------------------
+ * Adds one order to its hour, store and drink cell. Lock-free:
+ * the common case is one acquire load and four relaxed adds on
+ * this thread's stripe.
+ ******************************************************************/
+void OrderAnalytics::record(int64_t unixTime, unsigned store, DrinkType drink,
+                            double caffeineMg, double beansG, double milkML) {
+    int64_t hour = hourOf(unixTime);
+    size_t slot = slotOf(hour);
+    Stripe& s = stripeForThisThread();
+    if (!s.claim(slot, hour)) {
+        droppedCount.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    if (store >= ANALYTICS_STORES) store = ANALYTICS_STORES - 1;
+    size_t cell = slot * CELLS_PER_HOUR + store * DRINK_TYPE_COUNT + indexOf(drink);
+    s.orders[cell].fetch_add(1, memory_order_relaxed);
+    s.caffeineUg[cell].fetch_add(toUnits(caffeineMg, MILLI), memory_order_relaxed);
+    s.beansMg[cell].fetch_add(toUnits(beansG, MILLI), memory_order_relaxed);
+    s.milkUL[cell].fetch_add(toUnits(milkML, MILLI), memory_order_relaxed);
+}
+
+/******************************************************************
+ * Function: OrderAnalytics::collect
+ * ---------------------------------------------------------------
+ * Merges every stripe into perHour (one entry per hour of the
+ * filter range). A slot that changes hour while it is being read
+ * is skipped for that stripe rather than reported half-reset.
+ ******************************************************************/
+void OrderAnalytics::collect(const AnalyticsFilter& filter, ConsumptionTotals* perHour) const {
+    int64_t from = max(filter.fromHour, filter.toHour - static_cast<int64_t>(ANALYTICS_HOURS));
+
+    for (size_t si = 0; si < ANALYTICS_STRIPES; ++si) {
+        const Stripe* s = stripes[si].load(memory_order_acquire);
+        if (!s) continue;
+
+        for (int64_t hour = from; hour < filter.toHour; ++hour) {
+            size_t slot = slotOf(hour);
+            if (s->slotHour[slot].load(memory_order_acquire) != hour) continue;
+
+            uint64_t orders = 0, caffeine = 0, beans = 0, milk = 0;
+            size_t base = slot * CELLS_PER_HOUR;
+            for (unsigned store = 0; store < ANALYTICS_STORES; ++store) {
+                if (filter.store != ANY_STORE && filter.store != store) continue;
+                for (size_t d = 0; d < DRINK_TYPE_COUNT; ++d) {
+                    if (!filter.anyDrink && d != indexOf(filter.drink)) continue;
+                    size_t cell = base + store * DRINK_TYPE_COUNT + d;
+                    orders += s->orders[cell].load(memory_order_relaxed);
+                    caffeine += s->caffeineUg[cell].load(memory_order_relaxed);
+                    beans += s->beansMg[cell].load(memory_order_relaxed);
+                    milk += s->milkUL[cell].load(memory_order_relaxed);
+                }
+            }
+
+            atomic_thread_fence(memory_order_acquire);
+            if (s->slotHour[slot].load(memory_order_relaxed) != hour) continue;
+
+            ConsumptionTotals& t = perHour[hour - filter.fromHour];
+            t.orders += orders;
+            t.caffeineMg += caffeine / MILLI;
+            t.beansG += beans / MILLI;
+            t.milkML += milk / MILLI;
+        }
+    }
+}
+
+ConsumptionTotals OrderAnalytics::total(const AnalyticsFilter& filter) const {
+    vector<ConsumptionTotals> perHour;
+    hourly(filter, perHour);
+    ConsumptionTotals sum;
+    for (const ConsumptionTotals& t : perHour) {
+        sum.orders += t.orders;
+        sum.caffeineMg += t.caffeineMg;
+        sum.beansG += t.beansG;
+        sum.milkML += t.milkML;
+    }
+    return sum;
+}
+
+void OrderAnalytics::hourly(const AnalyticsFilter& filter, vector<ConsumptionTotals>& out) const {
+    out.assign(filter.toHour > filter.fromHour ? static_cast<size_t>(filter.toHour - filter.fromHour) : 0,
+               ConsumptionTotals());
+    if (!out.empty()) collect(filter, out.data());
+}
+
+OrderAnalytics& sharedAnalytics() {
+    static OrderAnalytics analytics;
+    return analytics;
+}
+
+int64_t analyticsNow() {
+    return chrono::duration_cast<chrono::seconds>(
+               chrono::system_clock::now().time_since_epoch()).count();
+}
+
+/******************************************************************
+ * Function: recordOrder
+ * ---------------------------------------------------------------
+ * An order's own time= is trusted only within the window ending
+ * ANALYTICS_MAX_SKEW_SECONDS after unixTime: one far in the future
+ * would claim hour slots ahead of the clock and evict the hours
+ * being reported. Orders outside it are counted as dropped.
+ ******************************************************************/
+void recordOrder(OrderAnalytics& analytics, const Order& order,
+                 const OrderResult& result, int64_t unixTime) {
+    if (!result.ok) return;
+    int64_t when = order.time ? order.time : unixTime;
+    if (when > unixTime + ANALYTICS_MAX_SKEW_SECONDS ||
+        when <= unixTime - static_cast<int64_t>(ANALYTICS_HOURS) * 3600) {
+        analytics.drop();
+        return;
+    }
+    bool coffee = (result.drink == DrinkType::Coffee);
+    analytics.record(when, order.store, result.drink,
+                     result.caffeineMg,
+                     coffee ? result.coffee.coffeeGrams : result.latte.coffeeGrams,
+                     coffee ? 0.0 : result.latte.milkML);
+}
+
+namespace {
+
+void printTotals(ostream& out, const char* label, const ConsumptionTotals& t) {
+    out << "  " << left << setw(12) << label << right
+        << setw(8) << t.orders << " orders "
+        << setw(12) << t.caffeineMg << " mg caffeine "
+        << setw(11) << t.beansG << " g beans "
+        << setw(11) << t.milkML << " mL milk\n";
+}
+
+} // namespace
+
+/******************************************************************
+ * Function: printAnalytics
+ * ---------------------------------------------------------------
+ * Human-readable consumption report for the window ending at the
+ * hour of unixTime: totals, per drink, per active store, then the
+ * non-empty hours of the last day.
+ ******************************************************************/
+void printAnalytics(const OrderAnalytics& analytics, int64_t unixTime, ostream& out) {
+    AnalyticsFilter filter;
+    filter.toHour = hourOf(unixTime) + 1;
+    filter.fromHour = filter.toHour - static_cast<int64_t>(ANALYTICS_HOURS);
+
+    ios::fmtflags flags = out.flags();
+    streamsize precision = out.precision();
+    out << fixed << setprecision(2);
+
+    out << "analytics: last " << ANALYTICS_HOURS << " hours\n";
+    printTotals(out, "all", analytics.total(filter));
+
+    filter.anyDrink = false;
+    filter.drink = DrinkType::Coffee;
+    printTotals(out, "coffee", analytics.total(filter));
+    filter.drink = DrinkType::Latte;
+    printTotals(out, "latte", analytics.total(filter));
+    filter.anyDrink = true;
+
+    for (unsigned store = 0; store < ANALYTICS_STORES; ++store) {
+        filter.store = store;
+        ConsumptionTotals t = analytics.total(filter);
+        if (t.orders == 0) continue;
+        char label[32];
+        snprintf(label, sizeof label, "store %u", store);
+        printTotals(out, label, t);
+    }
+    filter.store = ANY_STORE;
+
+    filter.fromHour = filter.toHour - 24;
+    vector<ConsumptionTotals> perHour;
+    analytics.hourly(filter, perHour);
+    for (size_t i = 0; i < perHour.size(); ++i) {
+        if (perHour[i].orders == 0) continue;
+        char label[32];
+        snprintf(label, sizeof label, "hour -%zu", perHour.size() - 1 - i);
+        printTotals(out, label, perHour[i]);
+    }
+    if (analytics.dropped() > 0)
+        out << "  (" << analytics.dropped() << " records outside the window dropped)\n";
+
+    out.flags(flags);
+    out.precision(precision);
+}
@@ -0,0 +1,119 @@
+#include "orderBatch.hpp"
+#include "constants.hpp"
+#include "recipeKernels.hpp"
+using namespace std;
+
+void CoffeeOrderBatch::add(Strength s, Roast r, double c) {
+    strength.push_back(s);
+    roast.push_back(r);
+    cups.push_back(c);
+}
+
+void CoffeeOrderBatch::reserve(size_t n) {
+    strength.reserve(n);
+    roast.reserve(n);
+    cups.reserve(n);
+}
+
+void CoffeeOrderBatch::clear() {
+    strength.clear();
+    roast.clear();
+    cups.clear();
+}
+
+void LatteOrderBatch::add(Strength s, ShotSize size, int count) {
+    strength.push_back(s);
+    shotSize.push_back(size);
+    shots.push_back(count);
+}
+
+void LatteOrderBatch::reserve(size_t n) {
+    strength.reserve(n);
+    shotSize.reserve(n);
+    shots.reserve(n);
+}
+
+void LatteOrderBatch::clear() {
+    strength.clear();
+    shotSize.clear();
+    shots.clear();
+}
+
+/******************************************************************
+ * Function: calcCoffeeBatch
+ * ---------------------------------------------------------------
+ * Batch form of calcCoffee. The loop body is branch-free (one
+ * COFFEE_RECIPES lookup, multiplies and selects) so the compiler
+ * can vectorize it.
+ *
+ * Parameters:
+ *   orders  - struct-of-arrays block of coffee orders
+ *   results - output array with at least orders.size() entries
+ *   valid   - output flags, 1 if results[i] is a real result
+ *
+ * Returns:
+ *   Number of valid orders in the batch.
+ ******************************************************************/
+size_t calcCoffeeBatch(const CoffeeOrderBatch& orders,
+                       CoffeeResult* results, unsigned char* valid) {
+    const size_t n = orders.size();
+    const Strength* strength = orders.strength.data();
+    const Roast*    roast    = orders.roast.data();
+    const double*   cupsIn   = orders.cups.data();
+
+    size_t validCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const CoffeeRecipe& rec = COFFEE_RECIPES(strength[i], roast[i]);
+        bool   ok   = (rec.ratio > 0.0) & (cupsIn[i] > 0.0);
+        double cups = ok ? cupsIn[i] : 0.0;
+
+        results[i].waterCups   = cups;
+        results[i].waterML     = cups * ML_PER_CUP;
+        results[i].coffeeGrams = cups * rec.gramsPerCup;
+        results[i].ratio       = ok ? rec.ratio : 0.0;
+        results[i].tablespoons = cups * rec.tbspPerCup;
+        valid[i] = ok;
+        validCount += ok;
+    }
+    return validCount;
+}
+
+/******************************************************************
+ * Function: calcLatteBatch
+ * ---------------------------------------------------------------
+ * Batch form of calcLatteFromShots (no milk target). Same layout
+ * and validity rules as calcCoffeeBatch.
+ ******************************************************************/
+size_t calcLatteBatch(const LatteOrderBatch& orders,
+                      LatteResult* results, unsigned char* valid) {
+    const size_t n = orders.size();
+    const Strength* strength = orders.strength.data();
+    const ShotSize* shotSize = orders.shotSize.data();
+    const int*      shotsIn  = orders.shots.data();
+
+    size_t validCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const LatteRecipe& rec = LATTE_RECIPES(shotSize[i], strength[i]);
+        bool   ok    = (rec.brewRatio > 0.0) & (shotsIn[i] > 0);
+        int    shots = ok ? shotsIn[i] : 0;
+
+        LatteResult& r = results[i];
+        r.shots        = shots;
+        r.shotSize     = shotSize[i];
+        r.coffeeGrams  = shots * rec.gramsPerShot;
+        r.brewRatio    = ok ? rec.brewRatio : 0.0;
+        r.espressoML   = shots * rec.espressoMLPerShot;
+        r.espressoCups = shots * rec.espressoCupsPerShot;
+        r.tablespoons  = shots * rec.tbspPerShot;
+        r.hasMilkTarget  = false;
+        r.milkStyle      = MilkStyle::None;
+        r.milkToEspRatio = 0.0;
+        r.milkML    = 0.0;
+        r.milkCups  = 0.0;
+        r.finalML   = 0.0;
+        r.finalCups = 0.0;
+        valid[i] = ok;
+        validCount += ok;
+    }
+    return validCount;
+}
@@ -0,0 +1,75 @@
+#include "orderCache.hpp"
+using namespace std;
+
+namespace {
+
+// key layout (bit 0 up): drink+1 (2) | strength (2) | iced (1) | then
+//   coffee: roast (2) | cups, thousandths (32)
+//   latte:  shot size (1) | milk style (3) | shots (8) | extra shots (8)
+//           | milk ratio, thousandths (32)
+constexpr unsigned DRINK_SHIFT    = 0;
+constexpr unsigned STRENGTH_SHIFT = 2;
+constexpr unsigned ICED_SHIFT     = 4;
+constexpr unsigned ROAST_SHIFT    = 5;
+constexpr unsigned CUPS_SHIFT     = 8;
+constexpr unsigned SHOT_SHIFT     = 5;
+constexpr unsigned MILK_SHIFT     = 6;
+constexpr unsigned SHOTS_SHIFT    = 9;
+constexpr unsigned EXTRA_SHIFT    = 17;
+constexpr unsigned RATIO_SHIFT    = 25;
+
+static_assert(CUPS_SHIFT + 32 <= 64 && RATIO_SHIFT + 32 <= 64, "order key fields overflow 64 bits");
+
+// exact thousandths of v, or false if v has no such form
+bool toMilli(double v, uint64_t& out) {
+    if (!(v >= 0.0) || v > 4294967.295) return false;
+    uint64_t q = static_cast<uint64_t>(v * 1000.0 + 0.5);
+    if (static_cast<double>(q) / 1000.0 != v) return false;
+    out = q;
+    return true;
+}
+
+} // namespace
+
+uint64_t orderCacheKey(const Order& order) {
+    // named add-ons do not fit the key; those orders are computed directly
+    if (order.addOnCount > 0) return 0;
+
+    uint64_t key = (static_cast<uint64_t>(order.drink) + 1) << DRINK_SHIFT;
+    key |= static_cast<uint64_t>(order.strength) << STRENGTH_SHIFT;
+    key |= static_cast<uint64_t>(order.iced) << ICED_SHIFT;
+
+    if (order.drink == DrinkType::Coffee) {
+        uint64_t cups;
+        if (!toMilli(order.cups, cups)) return 0;
+        key |= static_cast<uint64_t>(order.roast) << ROAST_SHIFT;
+        key |= cups << CUPS_SHIFT;
+        return key;
+    }
+
+    if (order.shots < 0 || order.shots > 255 || order.extraShots < 0 || order.extraShots > 255)
+        return 0;
+    // the ratio only matters with a milk target
+    uint64_t ratio = 0;
+    if (order.milkStyle != MilkStyle::None && !toMilli(order.milkRatio, ratio))
+        return 0;
+    key |= static_cast<uint64_t>(order.shotSize) << SHOT_SHIFT;
+    key |= static_cast<uint64_t>(order.milkStyle) << MILK_SHIFT;
+    key |= static_cast<uint64_t>(order.shots) << SHOTS_SHIFT;
+    key |= static_cast<uint64_t>(order.extraShots) << EXTRA_SHIFT;
+    key |= ratio << RATIO_SHIFT;
+    return key;
+}
+
+OrderCache& sharedOrderCache() {
+    static OrderCache cache(ORDER_CACHE_CAPACITY, ORDER_CACHE_SHARDS);
+    return cache;
+}
+
+bool computeOrderCached(const Order& order, OrderResult& out, OrderCache& cache) {
+    uint64_t key = orderCacheKey(order);
+    if (key == 0) return computeOrder(order, out);
+    return cache.getOrCompute(key, out, [&order](OrderResult& r) {
+        return computeOrder(order, r);
+    });
+}
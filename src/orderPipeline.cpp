@@ -0,0 +1,252 @@
+#include "orderPipeline.hpp"
+#include "boundedQueue.hpp"
+#include "inventoryForecast.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+constexpr unsigned MAX_THREADS = 256;
+
+// one newline-aligned slice of the input and the rows it produced
+struct Chunk {
+    size_t       seq = 0;
+    size_t       firstLine = 0;
+    vector<char> input;
+    size_t       inputLen = 0;
+    OutputBuffer output;
+    BatchCounts  counts;
+};
+
+// spin, then yield, then sleep: an idle stage must not take a
+// core away from the workers
+class Backoff {
+
+    public:
+
+        void pause() {
+            if (spins < 64) {
+                ++spins;
+            } else if (spins < 128) {
+                ++spins;
+                this_thread::yield();
+            } else {
+                this_thread::sleep_for(chrono::microseconds(50));
+            }
+        }
+
+        void reset() { spins = 0; }
+
+    private:
+
+        unsigned spins = 0;
+};
+
+struct Shared {
+    Shared(unsigned threads, size_t poolSize)
+        : freeChunks(poolSize), done(new atomic<Chunk*>[poolSize]), poolSize(poolSize) {
+        for (unsigned i = 0; i < threads; ++i)
+            queues.emplace_back(new BoundedQueue<Chunk*>(poolSize));
+        for (size_t i = 0; i < poolSize; ++i)
+            done[i].store(nullptr, memory_order_relaxed);
+    }
+
+    vector<unique_ptr<BoundedQueue<Chunk*>>> queues;   // one per worker, stealable
+    vector<unique_ptr<InventoryForecast>> usage;       // one per worker when forecasting
+    BoundedQueue<Chunk*>       freeChunks;             // writer -> reader recycling
+    unique_ptr<atomic<Chunk*>[]> done;                 // reorder ring, slot = seq % poolSize
+    size_t                     poolSize;
+
+    atomic<size_t> totalChunks{0};
+    atomic<bool>   readerDone{false};
+};
+
+// own queue first, then steal from the others
+bool takeChunk(Shared& shared, unsigned self, Chunk*& chunk) {
+    unsigned n = static_cast<unsigned>(shared.queues.size());
+    for (unsigned k = 0; k < n; ++k) {
+        if (shared.queues[(self + k) % n]->pop(chunk))
+            return true;
+    }
+    return false;
+}
+
+void workerLoop(Shared& shared, unsigned self, OutputFormat format, CalcEngine engine) {
+    Backoff backoff;
+    for (;;) {
+        // read before the sweep: once set, every chunk is already queued
+        bool finished = shared.readerDone.load(memory_order_acquire);
+
+        Chunk* chunk;
+        if (takeChunk(shared, self, chunk)) {
+            chunk->output.clear();
+            chunk->counts = BatchCounts();
+            processRecords(string_view(chunk->input.data(), chunk->inputLen), chunk->firstLine,
+                           chunk->output, format, chunk->counts,
+                           shared.usage.empty() ? nullptr : shared.usage[self].get(), engine);
+            shared.done[chunk->seq % shared.poolSize].store(chunk, memory_order_release);
+            backoff.reset();
+            continue;
+        }
+        if (finished) return;
+        backoff.pause();
+    }
+}
+
+// emits chunks strictly in sequence order
+void writerLoop(Shared& shared, const PipelineWriter& write, BatchCounts& counts, bool& ok) {
+    Backoff backoff;
+    size_t next = 0;
+    for (;;) {
+        atomic<Chunk*>& slot = shared.done[next % shared.poolSize];
+        Chunk* chunk = slot.load(memory_order_acquire);
+        if (!chunk) {
+            if (shared.readerDone.load(memory_order_acquire)
+                && next == shared.totalChunks.load(memory_order_relaxed))
+                return;
+            backoff.pause();
+            continue;
+        }
+        slot.store(nullptr, memory_order_relaxed);
+
+        string_view rows = chunk->output.view();
+        if (ok && !rows.empty() && !write(rows.data(), rows.size()))
+            ok = false;
+        counts.processed += chunk->counts.processed;
+        counts.failed += chunk->counts.failed;
+
+        while (!shared.freeChunks.push(chunk)) backoff.pause();
+        ++next;
+        backoff.reset();
+    }
+}
+
+} // namespace
+
+unsigned resolveThreadCount(unsigned requested) {
+    if (requested == 0) requested = thread::hardware_concurrency();
+    return max(1u, min(requested, MAX_THREADS));
+}
+
+/******************************************************************
+ * Function: runPipeline
+ * ---------------------------------------------------------------
+ * Multithreaded version of the batch loop. The calling thread
+ * reads the input, at most chunkBytes at a time, and as each read
+ * returns sends its whole lines on as a chunk, carrying only the
+ * partial last line (as runBatch does), so a slow stream is
+ * answered line by line. Each chunk is tagged with a sequence
+ * number and its first line number. Chunks
+ * are dealt round-robin onto per-worker lock-free queues; a worker
+ * drains its own queue and steals from the others when it runs
+ * dry, so one slow chunk does not stall a core. Each worker runs
+ * processRecords (parse -> calc -> add-ons -> format) into the
+ * chunk's own buffer and publishes it in a reorder ring. A writer
+ * thread emits the ring strictly in sequence, so output is byte
+ * for byte the same as the single-threaded loop, then recycles
+ * the chunk back to the reader.
+ *
+ * Parameters:
+ *   read    - input source
+ *   write   - output sink (called from the writer thread only)
+ *   format  - CSV or JSONL rows
+ *   options - thread count, chunking and calc engine
+ *   counts  - processed / failed totals
+ *   inventory - optional; each worker keeps its own forecast,
+ *             merged into this one at the end
+ *
+ * Returns:
+ *   false on a read or write error.
+ ******************************************************************/
+bool runPipeline(const PipelineReader& read, const PipelineWriter& write,
+                 OutputFormat format, const PipelineOptions& options, BatchCounts& counts,
+                 InventoryForecast* inventory) {
+    unsigned threads = resolveThreadCount(options.threads);
+    size_t chunkBytes = max<size_t>(options.chunkBytes, 4096);
+    size_t poolSize = threads * max<size_t>(options.chunksPerThread, 2);
+
+    Shared shared(threads, poolSize);
+    if (inventory) {
+        for (unsigned i = 0; i < threads; ++i)
+            shared.usage.emplace_back(new InventoryForecast);
+    }
+    vector<unique_ptr<Chunk>> pool;
+    for (size_t i = 0; i < poolSize; ++i) {
+        pool.emplace_back(new Chunk);
+        shared.freeChunks.push(pool.back().get());
+    }
+
+    bool writeOk = true;
+    thread writer(writerLoop, ref(shared), cref(write), ref(counts), ref(writeOk));
+    vector<thread> workers;
+    for (unsigned i = 0; i < threads; ++i)
+        workers.emplace_back(workerLoop, ref(shared), i, format, options.engine);
+
+    vector<char> carry;   // partial last line of the previous read
+    size_t seq = 0;
+    size_t lineNo = 1;
+    bool eof = false, readOk = true;
+    Backoff backoff;
+
+    while (!eof) {
+        Chunk* chunk;
+        while (!shared.freeChunks.pop(chunk)) backoff.pause();   // backpressure
+        backoff.reset();
+
+        size_t len = carry.size();
+        if (chunk->input.size() < len + chunkBytes) chunk->input.resize(len + chunkBytes);
+        if (len > 0) memcpy(chunk->input.data(), carry.data(), len);
+        carry.clear();
+
+        // one read: whatever it returns is dispatched now, not held for a full chunk
+        long n = read(chunk->input.data() + len, chunk->input.size() - len);
+        if (n <= 0) {
+            readOk = (n == 0);
+            eof = true;
+        } else {
+            len += static_cast<size_t>(n);
+        }
+
+        size_t whole = len;
+        if (!eof) {
+            size_t last = string_view(chunk->input.data(), len).rfind('\n');
+            if (last == string_view::npos) {
+                // one line longer than a chunk: keep reading into a bigger one
+                carry.assign(chunk->input.data(), chunk->input.data() + len);
+                shared.freeChunks.push(chunk);
+                continue;
+            }
+            whole = last + 1;
+            carry.assign(chunk->input.data() + whole, chunk->input.data() + len);
+        }
+        if (whole == 0) {
+            shared.freeChunks.push(chunk);
+            continue;
+        }
+
+        chunk->seq = seq++;
+        chunk->firstLine = lineNo;
+        chunk->inputLen = whole;
+        lineNo += static_cast<size_t>(count(chunk->input.data(), chunk->input.data() + whole, '\n'));
+
+        while (!shared.queues[chunk->seq % threads]->push(chunk)) backoff.pause();
+        backoff.reset();
+    }
+
+    shared.totalChunks.store(seq, memory_order_relaxed);
+    shared.readerDone.store(true, memory_order_release);
+
+    for (thread& t : workers) t.join();
+    writer.join();
+    for (const unique_ptr<InventoryForecast>& part : shared.usage)
+        inventory->merge(*part);
+    return readOk && writeOk;
+}
@@ -0,0 +1,311 @@
+#include "orderRecord.hpp"
+#include "drinkComposition.hpp"
+#include "constants.hpp"
+#include "instrumentation.hpp"
+#include "inverseSolver.hpp"
+#include "presets.hpp"
+#include <algorithm>
+#include <charconv>
+using namespace std;
+
+namespace {
+
+string_view trim(string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+// splits off the next comma-separated field (trimmed)
+string_view nextField(string_view& rest) {
+    size_t comma = rest.find(',');
+    string_view field = rest.substr(0, comma);
+    rest = (comma == string_view::npos) ? string_view() : rest.substr(comma + 1);
+    return trim(field);
+}
+
+// range messages, shared by the field parsers and checkOrderLimits
+const char* const CUPS_ERROR  = "cups must be a positive number up to 1000, or auto";
+const char* const SHOTS_ERROR = "shots must be a whole number from 1 to 1000, or auto";
+const char* const EXTRA_ERROR = "extra= needs a whole number from 0 to 1000";
+const char* const RATIO_ERROR = "ratio= needs a number from 0 to 100";
+const char* const SIZE_ERROR  = "volume= and beans= need a positive number up to 1000000";
+const char* const TIME_ERROR  = "time= needs Unix seconds";
+
+template <typename T>
+bool parseNumber(string_view s, T& out) {
+    if (s.empty()) return false;
+    auto res = from_chars(s.data(), s.data() + s.size(), out);
+    return res.ec == errc() && res.ptr == s.data() + s.size();
+}
+
+// handles one optional trailing flag
+bool parseFlag(string_view flag, Order& out, const char*& error) {
+    size_t eq = flag.find('=');
+    string_view key = trim(flag.substr(0, eq));
+    string_view value = (eq == string_view::npos) ? string_view() : trim(flag.substr(eq + 1));
+
+    if (key == "iced" && eq == string_view::npos) {
+        out.iced = true;
+    } else if (key == "extra") {
+        if (!parseNumber(value, out.extraShots)) {
+            error = EXTRA_ERROR;
+            return false;
+        }
+    } else if (key == "ratio") {
+        if (!parseNumber(value, out.milkRatio) || out.milkRatio < 0.0) {
+            error = RATIO_ERROR;
+            return false;
+        }
+    } else if (key == "topping") {
+        out.topping = value;
+    } else if (key == "volume" || key == "beans") {
+        if (!parseNumber(value, out.sizeAmount)) {
+            error = SIZE_ERROR;
+            return false;
+        }
+        out.sizeBy = (key == "volume") ? SizeBy::Volume : SizeBy::Beans;
+    } else if (key == "round") {
+        if (value == "nearest") out.rounding = ShotRounding::Nearest;
+        else if (value == "down") out.rounding = ShotRounding::Down;
+        else if (value == "up") out.rounding = ShotRounding::Up;
+        else {
+            error = "round= must be nearest, down or up";
+            return false;
+        }
+    } else if (key == "store") {
+        if (!parseNumber(value, out.store)) {
+            error = "store= needs a non-negative whole number";
+            return false;
+        }
+    } else if (key == "time") {
+        if (!parseNumber(value, out.time) || out.time == 0) {
+            error = TIME_ERROR;
+            return false;
+        }
+    } else {
+        AddOnId id = (eq == string_view::npos) ? defaultAddOns().find(key) : NO_ADDON;
+        if (id == NO_ADDON) {
+            error = "unknown flag";
+            return false;
+        }
+        if (!defaultAddOns().appliesTo(id, out.drink)) {
+            error = "add-on is not offered for this drink";
+            return false;
+        }
+        if (out.addOnCount == ORDER_MAX_ADDONS) {
+            error = "too many add-ons";
+            return false;
+        }
+        out.addOns[out.addOnCount++] = id;
+    }
+    return true;
+}
+
+/******************************************************************
+ * Struct: CompiledAddOns
+ * ---------------------------------------------------------------
+ * One slot of a per-thread, direct-mapped cache of
+ * defaultAddOns().compile() results, keyed by drink and add-on
+ * list. Orders repeat a handful of combinations, so the fold is
+ * paid once per combination instead of once per order. The
+ * default registry never changes, so entries never go stale.
+ ******************************************************************/
+constexpr size_t ADDON_CACHE_SLOTS = 64;
+
+struct CompiledAddOns {
+    DrinkType     drink = DrinkType::Coffee;
+    unsigned char count = 0xFF;   // empty slot
+    AddOnId       ids[ORDER_MAX_ADDONS] = {};
+    AddOnEffect   effect;
+};
+
+const AddOnEffect& compiledAddOns(const Order& order) {
+    thread_local CompiledAddOns cache[ADDON_CACHE_SLOTS];
+
+    size_t hash = static_cast<size_t>(order.drink) * 31 + order.addOnCount;
+    for (size_t i = 0; i < order.addOnCount; ++i) hash = hash * 31 + order.addOns[i];
+    CompiledAddOns& slot = cache[hash % ADDON_CACHE_SLOTS];
+
+    if (slot.count != order.addOnCount || slot.drink != order.drink ||
+        !equal(order.addOns, order.addOns + order.addOnCount, slot.ids)) {
+        PROBE_COUNT("addons.cache_miss", 1);
+        PROBE_SCOPE("addons.compile");
+        slot.drink = order.drink;
+        slot.count = order.addOnCount;
+        copy(order.addOns, order.addOns + order.addOnCount, slot.ids);
+        slot.effect = defaultAddOns().compile(order.addOns, order.addOnCount, order.drink);
+    } else {
+        PROBE_COUNT("addons.cache_hit", 1);
+    }
+    return slot.effect;
+}
+
+} // namespace
+
+/******************************************************************
+ * Function: checkOrderLimits
+ * ---------------------------------------------------------------
+ * The numeric limits every order source applies (record lines,
+ * binary frames): finite cups, ratio and target within the
+ * ORDER_MAX_* bounds, whole shots and extra shots up to
+ * ORDER_MAX_SHOTS, no negative time. cups and shots may be 0,
+ * still to be sized from the target. The comparisons are written
+ * so NaN fails them; infinity fails the upper bound.
+ *
+ * Returns:
+ *   nullptr if the order is within them, else a static message.
+ ******************************************************************/
+const char* checkOrderLimits(const Order& order) {
+    if (!(order.cups >= 0.0 && order.cups <= ORDER_MAX_CUPS)) return CUPS_ERROR;
+    if (order.shots < 0 || order.shots > ORDER_MAX_SHOTS) return SHOTS_ERROR;
+    if (order.extraShots < 0 || order.extraShots > ORDER_MAX_SHOTS) return EXTRA_ERROR;
+    if (order.drink == DrinkType::Latte &&
+        !(order.milkRatio >= 0.0 && order.milkRatio <= ORDER_MAX_MILK_RATIO))
+        return RATIO_ERROR;
+    if (order.sizeBy != SizeBy::None &&
+        !(order.sizeAmount > 0.0 && order.sizeAmount <= ORDER_MAX_SIZE_AMOUNT))
+        return SIZE_ERROR;
+    if (order.time < 0) return TIME_ERROR;
+    return nullptr;
+}
+
+bool isSkippableLine(string_view line) {
+    line = trim(line);
+    return line.empty() || line.front() == '#';
+}
+
+/******************************************************************
+ * Function: parseOrderLine
+ * ---------------------------------------------------------------
+ * Parses one order record (see Order for the syntax) without
+ * allocating; numbers go through std::from_chars.
+ *
+ * Parameters:
+ *   line  - the record, without its trailing newline
+ *   out   - parsed order
+ *   error - set to a static message on failure
+ *
+ * Returns:
+ *   true if the record is a valid order.
+ ******************************************************************/
+bool parseOrderLine(string_view line, Order& out, const char*& error) {
+    PROBE_SCOPE("order.parse");
+    out = Order();
+    string_view rest = line;
+
+    if (!parseDrinkType(nextField(rest), out.drink)) {
+        error = "drink must be coffee or latte";
+        return false;
+    }
+
+    if (out.drink == DrinkType::Coffee) {
+        if (!parseRoast(nextField(rest), out.roast)) {
+            error = "roast must be light, medium or dark";
+            return false;
+        }
+        if (!parseStrength(nextField(rest), out.strength) || !isCoffeeStrength(out.strength)) {
+            error = "coffee strength must be bolder, medium or weaker";
+            return false;
+        }
+        string_view cups = nextField(rest);
+        if (cups != "auto" && (!parseNumber(cups, out.cups) || !(out.cups > 0.0))) {
+            error = CUPS_ERROR;
+            return false;
+        }
+    } else {
+        if (!parseStrength(nextField(rest), out.strength) || !isLatteStrength(out.strength)) {
+            error = "latte strength must be stronger or weaker";
+            return false;
+        }
+        if (!parseShotSize(nextField(rest), out.shotSize)) {
+            error = "shot size must be single or double";
+            return false;
+        }
+        string_view shots = nextField(rest);
+        if (shots != "auto" && (!parseNumber(shots, out.shots) || out.shots <= 0)) {
+            error = SHOTS_ERROR;
+            return false;
+        }
+        if (!parseMilkStyle(nextField(rest), out.milkStyle)) {
+            error = "milk style must be none, cortado, flatwhite, latte or custom";
+            return false;
+        }
+        out.milkRatio = milkStyleToRatio(out.milkStyle);
+    }
+
+    while (!rest.empty()) {
+        string_view flag = nextField(rest);
+        if (flag.empty()) continue;
+        if (!parseFlag(flag, out, error)) return false;
+    }
+
+    // custom starts at -1 (milkStyleToRatio) until ratio= sets it
+    if (out.drink == DrinkType::Latte && out.milkRatio < 0.0) {
+        error = "custom milk style needs ratio=<value>";
+        return false;
+    }
+    if (const char* range = checkOrderLimits(out)) {
+        error = range;
+        return false;
+    }
+
+    if (out.sizeBy != SizeBy::None) {
+        if (!sizeOrder(out)) {
+            error = "no size reaches the volume=/beans= target";
+            return false;
+        }
+    } else if (out.cups <= 0.0 && out.shots <= 0) {
+        error = "auto size needs volume=<mL> or beans=<g>";
+        return false;
+    }
+    return true;
+}
+
+void presetOrder(const Presets& preset, Order& out) {
+    out = Order();
+    out.drink = preset.getDrinkType();
+    if (out.drink == DrinkType::Coffee) {
+        out.strength = preset.getStrength();
+        out.roast = preset.getRoast();
+        out.cups = preset.getCups();
+    } else {
+        out.strength = preset.getLatteStrength();
+        out.shotSize = preset.getShotSize();
+        out.shots = preset.getShots();
+        out.milkStyle = preset.getMilkStyle();
+        out.milkRatio = preset.getMilkRatio();
+    }
+}
+
+void composeOrder(const Order& order, DrinkComposition& out) {
+    out = DrinkComposition();
+    if (order.drink == DrinkType::Coffee) {
+        out.setCoffee(order.strength, order.roast, order.cups);
+    } else {
+        out.setLatte(order.strength, order.shotSize, order.shots);
+        out.setMilkTarget(order.milkStyle, order.milkRatio);
+    }
+    if (order.iced) out.addAddOn(ADDON_ICED);
+    out.addExtraShots(order.extraShots);
+    if (order.addOnCount > 0) out.addEffect(compiledAddOns(order));
+}
+
+/******************************************************************
+ * Function: computeOrder
+ * ---------------------------------------------------------------
+ * Runs one parsed order through its DrinkComposition: base recipe,
+ * fused add-ons, then (lattes) the milk target, matching the
+ * interactive front ends. Also fills in the drink's caffeine.
+ ******************************************************************/
+bool computeOrder(const Order& order, OrderResult& out) {
+    PROBE_SCOPE("order.compute");
+    out.drink = order.drink;
+
+    DrinkComposition drink;
+    composeOrder(order, drink);
+    out.ok = (order.drink == DrinkType::Coffee) ? drink.evaluate(out.coffee)
+                                                : drink.evaluate(out.latte);
+    out.caffeineMg = out.ok ? drink.caffeineMg() : 0.0;
+    return out.ok;
+}
@@ -0,0 +1,526 @@
+#include "orderServer.hpp"
+#include "addonRegistry.hpp"
+#include "instrumentation.hpp"
+#include "inverseSolver.hpp"
+#include "menuTable.hpp"
+#include "orderAnalytics.hpp"
+#include "presets.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <csignal>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr int SERVER_MAX_EVENTS = 64;
+
+constexpr string_view PRESET_PREFIX = "preset,";
+
+bool isWireRequest(string_view s) {
+    return !s.empty() && static_cast<uint8_t>(s.front()) == WIRE_MAGIC;
+}
+
+string_view trimSpaces(string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+} // namespace
+
+WireRequest toWire(const Order& order, uint32_t id) {
+    WireRequest w;
+    w.drink = static_cast<uint8_t>(order.drink);
+    w.roast = static_cast<uint8_t>(order.roast);
+    w.strength = static_cast<uint8_t>(order.strength);
+    w.shotSize = static_cast<uint8_t>(order.shotSize);
+    w.milkStyle = static_cast<uint8_t>(order.milkStyle);
+    w.iced = order.iced;
+    w.addOnCount = order.addOnCount;
+    for (size_t i = 0; i < order.addOnCount; ++i) w.addOns[i] = order.addOns[i];
+    w.id = id;
+    w.shots = order.shots;
+    w.extraShots = order.extraShots;
+    w.store = static_cast<uint16_t>(order.store);
+    w.sizeBy = static_cast<uint8_t>(order.sizeBy);
+    w.rounding = static_cast<uint8_t>(order.rounding);
+    w.cups = order.cups;
+    w.milkRatio = order.milkRatio;
+    w.sizeAmount = order.sizeAmount;
+    w.time = order.time;
+    return w;
+}
+
+/******************************************************************
+ * Function: fromWire
+ * ---------------------------------------------------------------
+ * Builds an order from a binary frame, rejecting anything a record
+ * line could not express: out-of-range enums, strengths or add-ons
+ * the drink does not take, numbers outside checkOrderLimits (the
+ * same routine parseOrderLine uses), non-positive sizes, a custom
+ * milk style without a ratio, or a target no size reaches. A
+ * milkRatio of 0 on a standard milk style means the style's own
+ * ratio.
+ ******************************************************************/
+bool fromWire(const WireRequest& w, Order& out) {
+    out = Order();
+    if (w.drink > 1 || w.roast >= ROAST_COUNT || w.strength >= STRENGTH_COUNT
+        || w.shotSize >= SHOT_SIZE_COUNT || w.milkStyle >= MILK_STYLE_COUNT
+        || w.sizeBy > static_cast<uint8_t>(SizeBy::Beans)
+        || w.rounding > static_cast<uint8_t>(ShotRounding::Up)
+        || w.addOnCount > ORDER_MAX_ADDONS || w.extraShots < 0)
+        return false;
+
+    out.drink = static_cast<DrinkType>(w.drink);
+    out.roast = static_cast<Roast>(w.roast);
+    out.strength = static_cast<Strength>(w.strength);
+    out.shotSize = static_cast<ShotSize>(w.shotSize);
+    out.milkStyle = static_cast<MilkStyle>(w.milkStyle);
+    out.iced = w.iced != 0;
+    out.extraShots = w.extraShots;
+    out.store = w.store;
+    out.time = w.time;
+
+    const AddOnRegistry& menu = defaultAddOns();
+    for (size_t i = 0; i < w.addOnCount; ++i) {
+        if (w.addOns[i] >= menu.size() || !menu.appliesTo(w.addOns[i], out.drink)) return false;
+        out.addOns[out.addOnCount++] = w.addOns[i];
+    }
+
+    // cups/shots are ignored when sizing from a target (sizeOrder fills them)
+    bool sized = w.sizeBy != 0;
+    if (out.drink == DrinkType::Coffee) {
+        if (!isCoffeeStrength(out.strength)) return false;
+        if (!sized) out.cups = w.cups;
+    } else {
+        if (!isLatteStrength(out.strength)) return false;
+        if (!sized) out.shots = w.shots;
+        if (!(w.milkRatio >= 0.0)) return false;
+        out.milkRatio = (w.milkRatio > 0.0 || out.milkStyle == MilkStyle::Custom)
+                            ? w.milkRatio : milkStyleToRatio(out.milkStyle);
+    }
+
+    if (sized) {
+        out.sizeBy = static_cast<SizeBy>(w.sizeBy);
+        out.rounding = static_cast<ShotRounding>(w.rounding);
+        out.sizeAmount = w.sizeAmount;
+    }
+    if (checkOrderLimits(out)) return false;
+    if (sized) return sizeOrder(out);
+    return (out.drink == DrinkType::Coffee) ? out.cups > 0.0 : out.shots > 0;
+}
+
+WireResponse wireResponse(uint32_t id, const OrderResult& result, WireStatus status) {
+    WireResponse r;
+    r.id = id;
+    r.status = status;
+    if (status != WireStatus::Ok) return r;
+
+    r.drink = static_cast<uint8_t>(result.drink);
+    r.caffeineMg = result.caffeineMg;
+    if (result.drink == DrinkType::Coffee) {
+        const CoffeeResult& c = result.coffee;
+        r.ratio = c.ratio;
+        r.coffeeGrams = c.coffeeGrams;
+        r.tablespoons = c.tablespoons;
+        r.waterML = c.waterML;
+        r.finalML = c.waterML;
+    } else {
+        const LatteResult& l = result.latte;
+        r.hasMilkTarget = l.hasMilkTarget;
+        r.shots = l.shots;
+        r.ratio = l.brewRatio;
+        r.coffeeGrams = l.coffeeGrams;
+        r.tablespoons = l.tablespoons;
+        r.espressoML = l.espressoML;
+        r.milkML = l.milkML;
+        r.finalML = l.hasMilkTarget ? l.finalML : l.espressoML;
+    }
+    return r;
+}
+
+/******************************************************************
+ * Struct: OrderServer::Connection
+ * ---------------------------------------------------------------
+ * One client: unparsed request bytes, replies not yet sent, and
+ * the epoll interest currently registered for it.
+ ******************************************************************/
+struct OrderServer::Connection {
+    int          fd = -1;
+    vector<char> in;
+    size_t       inUsed = 0;
+    OutputBuffer out;             // memory mode
+    size_t       sent = 0;        // bytes of out already written
+    size_t       requests = 0;    // line replies are numbered by this
+    uint32_t     events = 0;
+    bool         readClosed = false;
+
+    size_t pending() const { return out.view().size() - sent; }
+};
+
+OrderServer::OrderServer() = default;
+
+#ifdef __linux__
+
+OrderServer::~OrderServer() {
+    for (auto& c : connections)
+        if (c) ::close(c->fd);
+    if (signalFd >= 0) ::close(signalFd);
+    if (wakeFd >= 0) ::close(wakeFd);
+    if (epollFd >= 0) ::close(epollFd);
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        ::unlink(options.socketPath.c_str());
+    }
+}
+
+/******************************************************************
+ * Function: OrderServer::open
+ * ---------------------------------------------------------------
+ * Warms everything a request touches (menu table, add-on registry,
+ * presets) and then starts listening. A socket file left behind by
+ * a server that is gone is replaced; a live one is not.
+ ******************************************************************/
+bool OrderServer::open(const ServerOptions& settings, string& error) {
+    options = settings;
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (options.socketPath.empty() || options.socketPath.size() >= sizeof addr.sun_path) {
+        error = "socket path is empty or too long";
+        return false;
+    }
+    memcpy(addr.sun_path, options.socketPath.c_str(), options.socketPath.size() + 1);
+
+    struct stat st;
+    if (::stat(addr.sun_path, &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            error = options.socketPath + " exists and is not a socket";
+            return false;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        bool live = probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof addr) == 0;
+        if (probe >= 0) ::close(probe);
+        if (live) {
+            error = "a server is already listening on " + options.socketPath;
+            return false;
+        }
+        ::unlink(addr.sun_path);
+    }
+
+    if (!options.menuPath.empty() && !sharedMenuTable().load(options.menuPath))
+        cerr << "serve: menu table " << options.menuPath << " is missing or stale; using the built-in one\n";
+    sharedMenuTable();
+    defaultAddOns();
+    if (options.presets && presetStore.open(DEFAULT_PRESET_STORE)) {
+        presetManager.attachStore(&presetStore);
+        presetManager.getPresetNames();   // loads them all now rather than on the first request
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || ::bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof addr) != 0) {
+        error = "cannot bind " + options.socketPath + ": " + strerror(errno);
+        if (listenFd >= 0) ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    if (::listen(listenFd, SERVER_BACKLOG) != 0) {
+        error = string("listen: ") + strerror(errno);
+        return false;
+    }
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0) {
+        error = string("epoll: ") + strerror(errno);
+        return false;
+    }
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listenFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &ev);
+    ev.data.fd = wakeFd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    if (options.stopOnSignal) {
+        sigset_t mask;
+        sigemptyset(&mask);
+        sigaddset(&mask, SIGINT);
+        sigaddset(&mask, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &mask, nullptr);
+        signalFd = ::signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (signalFd >= 0) {
+            ev.data.fd = signalFd;
+            ::epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &ev);
+        }
+    }
+    return true;
+}
+
+bool OrderServer::run() {
+    if (epollFd < 0) return false;
+    epoll_event events[SERVER_MAX_EVENTS];
+
+    while (!stopping.load(memory_order_acquire)) {
+        int n = ::epoll_wait(epollFd, events, SERVER_MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == listenFd) {
+                accept();
+            } else if (fd == wakeFd) {
+                uint64_t count;
+                while (::read(wakeFd, &count, sizeof count) > 0) {}
+            } else if (fd == signalFd) {
+                signalfd_siginfo info;
+                while (::read(signalFd, &info, sizeof info) > 0) {}
+                stopping.store(true, memory_order_release);
+            } else if (static_cast<size_t>(fd) < connections.size() && connections[fd]) {
+                Connection& c = *connections[fd];
+                uint32_t ev = events[i].events;
+                if (ev & EPOLLERR) closeConnection(c);
+                else if (ev & (EPOLLIN | EPOLLHUP)) onReadable(c);   // also flushes
+                else if (ev & EPOLLOUT) onWritable(c);
+            }
+        }
+    }
+    return true;
+}
+
+void OrderServer::stop() {
+    stopping.store(true, memory_order_release);
+    if (wakeFd >= 0) {
+        uint64_t one = 1;
+        ssize_t ignored = ::write(wakeFd, &one, sizeof one);
+        (void)ignored;
+    }
+}
+
+void OrderServer::accept() {
+    for (;;) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;   // EAGAIN, or out of descriptors until a client leaves
+
+        if (static_cast<size_t>(fd) >= connections.size()) connections.resize(fd + 1);
+        connections[fd] = make_unique<Connection>();
+        Connection& c = *connections[fd];
+        c.fd = fd;
+        c.events = EPOLLIN;
+        epoll_event ev{};
+        ev.events = c.events;
+        ev.data.fd = fd;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev);
+        ++totals.connections;
+        PROBE_COUNT("server.accepts", 1);
+    }
+}
+
+// one read per wakeup keeps a busy client from starving the rest
+void OrderServer::onReadable(Connection& c) {
+    if (!c.readClosed) {
+        if (c.in.size() < c.inUsed + SERVER_READ_CHUNK) c.in.resize(c.inUsed + SERVER_READ_CHUNK);
+        ssize_t n = ::read(c.fd, c.in.data() + c.inUsed, SERVER_READ_CHUNK);
+        if (n < 0 && errno != EAGAIN && errno != EINTR) {
+            closeConnection(c);
+            return;
+        }
+        if (n == 0) c.readClosed = true;
+        if (n > 0) c.inUsed += static_cast<size_t>(n);
+        serveRequests(c, c.readClosed);
+    }
+    onWritable(c);
+}
+
+void OrderServer::onWritable(Connection& c) {
+    string_view data = c.out.view();
+    while (c.sent < data.size()) {
+        ssize_t n = ::send(c.fd, data.data() + c.sent, data.size() - c.sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) break;
+            closeConnection(c);
+            return;
+        }
+        c.sent += static_cast<size_t>(n);
+    }
+    if (c.sent == data.size()) {
+        c.out.clear();
+        c.sent = 0;
+        if (c.readClosed) {
+            closeConnection(c);
+            return;
+        }
+    }
+    updateEvents(c);
+}
+
+// read while replies fit, write while any are pending
+void OrderServer::updateEvents(Connection& c) {
+    uint32_t want = 0;
+    if (!c.readClosed && c.pending() < SERVER_MAX_PENDING) want |= EPOLLIN;
+    if (c.pending() > 0) want |= EPOLLOUT;
+    if (want == c.events) return;
+    c.events = want;
+    epoll_event ev{};
+    ev.events = want;
+    ev.data.fd = c.fd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_MOD, c.fd, &ev);
+}
+
+void OrderServer::closeConnection(Connection& c) {
+    int fd = c.fd;
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connections[fd].reset();
+}
+
+#else
+
+OrderServer::~OrderServer() = default;
+
+bool OrderServer::open(const ServerOptions& settings, string& error) {
+    options = settings;
+    error = "daemon mode needs Linux (epoll)";
+    return false;
+}
+
+bool OrderServer::run() { return false; }
+
+void OrderServer::stop() { stopping.store(true); }
+
+#endif
+
+/******************************************************************
+ * Function: OrderServer::serveRequests
+ * ---------------------------------------------------------------
+ * Answers every complete request in the connection's input and
+ * keeps the partial one for the next read. At end of input a last
+ * line without '\n' still counts (as in batch mode); a partial
+ * frame does not. A line longer than SERVER_MAX_LINE ends the
+ * connection after the replies so far.
+ ******************************************************************/
+void OrderServer::serveRequests(Connection& c, bool atEnd) {
+    size_t pos = 0;
+    while (pos < c.inUsed) {
+        string_view rest(c.in.data() + pos, c.inUsed - pos);
+
+        if (isWireRequest(rest)) {
+            if (rest.size() < sizeof(WireRequest)) break;
+            WireRequest request;
+            memcpy(&request, rest.data(), sizeof request);
+            serveFrame(c, request);
+            pos += sizeof request;
+            continue;
+        }
+
+        size_t nl = rest.find('\n');
+        if (nl == string_view::npos) {
+            if (rest.size() > SERVER_MAX_LINE) {
+                ++totals.dropped;
+                c.readClosed = true;
+                pos = c.inUsed;
+                break;
+            }
+            if (!atEnd) break;
+            nl = rest.size();
+        }
+        serveLine(c, rest.substr(0, nl));
+        pos += min(nl + 1, rest.size());
+    }
+
+    memmove(c.in.data(), c.in.data() + pos, c.inUsed - pos);
+    c.inUsed -= pos;
+}
+
+void OrderServer::serveLine(Connection& c, string_view line) {
+    if (isSkippableLine(line)) return;
+    PROBE_SCOPE("server.line");
+
+    Order order;
+    OrderResult result;
+    const char* error = nullptr;
+    bool parsed;
+
+    if (line.size() >= PRESET_PREFIX.size()
+        && equalsIgnoreCase(line.substr(0, PRESET_PREFIX.size()), PRESET_PREFIX)) {
+        string_view name = trimSpaces(line.substr(PRESET_PREFIX.size()));
+        const Presets* preset = presetNameFits(name) ? presetManager.getPresetByName(name) : nullptr;
+        parsed = preset != nullptr;
+        if (preset) presetOrder(*preset, order);
+        else error = presetNameFits(name) ? "unknown preset" : "preset name too long";
+    } else {
+        parsed = parseOrderLine(line, order, error);
+    }
+
+    if (parsed) {
+        computeOrderFromMenu(order, result, sharedMenuTable());
+        recordOrder(sharedAnalytics(), order, result, analyticsNow());
+    } else {
+        result.ok = false;
+    }
+    writeOrderRow(c.out, options.format, ++c.requests, result, error);
+    ++totals.requests;
+    totals.failed += !(result.ok && !error);
+}
+
+void OrderServer::serveFrame(Connection& c, const WireRequest& request) {
+    PROBE_SCOPE("server.frame");
+    Order order;
+    OrderResult result;
+    WireStatus status = WireStatus::Invalid;
+
+    if (fromWire(request, order)) {
+        status = computeOrderFromMenu(order, result, sharedMenuTable()) ? WireStatus::Ok
+                                                                        : WireStatus::CalcError;
+        if (status == WireStatus::Ok) recordOrder(sharedAnalytics(), order, result, analyticsNow());
+    }
+    WireResponse response = wireResponse(request.id, result, status);
+    c.out.append(string_view(reinterpret_cast<const char*>(&response), sizeof response));
+    ++c.requests;
+    ++totals.requests;
+    totals.failed += status != WireStatus::Ok;
+}
+
+/******************************************************************
+ * Function: runServer
+ * ---------------------------------------------------------------
+ * Daemon mode: serves until SIGINT or SIGTERM, then removes the
+ * socket file and reports totals on stderr.
+ *
+ * Returns:
+ *   0 on a clean stop, 1 if the socket cannot be set up.
+ ******************************************************************/
+int runServer(const ServerOptions& options) {
+    ServerOptions settings = options;
+    settings.stopOnSignal = true;
+
+    OrderServer server;
+    string error;
+    if (!server.open(settings, error)) {
+        cerr << "serve: " << error << "\n";
+        return 1;
+    }
+    cerr << "serve: listening on " << settings.socketPath << endl;
+
+    bool ok = server.run();
+    const ServerStats& stats = server.stats();
+    cerr << "serve: " << stats.connections << " connections, " << stats.requests << " requests, "
+         << stats.failed << " invalid";
+    if (stats.dropped) cerr << ", " << stats.dropped << " dropped for oversized requests";
+    cerr << "\n";
+    return ok ? 0 : 1;
+}
@@ -1,45 +1,149 @@
 #include "presetManager.hpp"
+#include "instrumentation.hpp"
 #include <iostream>
 using namespace std;
 
-// used to put things into the vector
-void PresetManager::addPreset(const Presets& preset) {
-    presets.push_back(preset);
+// persistence; anything already in memory is written through
+void PresetManager::attachStore(PresetStore* backing) {
+    store = backing;
+    storeLoaded = false;
+    if (!store) return;
+    for (const auto& s : slots) {
+        if (s.live && !store->contains(s.preset.getName()))
+            store->append(s.preset);
+    }
+}
+
+// places a preset in a slot (reusing removed slots first) and indexes it
+PresetHandle PresetManager::insertSlot(const Presets& preset) const {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+        slots[index].preset = preset;
+        slots[index].live = true;
+    } else {
+        index = static_cast<uint32_t>(slots.size());
+        slots.push_back({preset, 0, true});
+    }
+
+    byName.emplace(slots[index].preset.getName(), index);
+    return {index, slots[index].generation};
+}
+
+// cache miss: pull one preset from the store
+PresetHandle PresetManager::faultIn(string_view name) const {
+    Presets p(name);
+    if (!store || !store->find(name, p))
+        return PresetHandle();
+    return insertSlot(p);
+}
+
+// listing needs every preset; load the ones not cached yet (once)
+void PresetManager::loadAllFromStore() const {
+    if (!store || storeLoaded) return;
+    store->forEach([this](const Presets& p) {
+        if (!byName.count(p.getName())) insertSlot(p);
+    });
+    storeLoaded = true;
+}
+
+// used to put things into the store (invalid handle if taken or not persisted)
+PresetHandle PresetManager::addPreset(const Presets& preset) {
+    if (contains(preset.getName()))
+        return PresetHandle();
+    if (store && !store->append(preset))
+        return PresetHandle();
+    return insertSlot(preset);
+}
+
+// removes a preset by name; outstanding handles to it go stale
+bool PresetManager::removePreset(string_view name) {
+    if (!presetNameFits(name)) return false;
+    bool removed = store && store->remove(name);
+
+    auto it = byName.find(name);
+    if (it == byName.end())
+        return removed;
+
+    uint32_t index = it->second;
+    byName.erase(it);
+    slots[index].live = false;
+    slots[index].generation++;
+    freeSlots.push_back(index);
+    return true;
 }
 
 // preset menu display
 void PresetManager::listPresets() const {
-    if (presets.empty()) {
+    if (!hasPresets()) {
         cout << "\nNo presets saved.\n";
         return;
     }
 
+    loadAllFromStore();
     cout << "\n--- Saved Presets ---\n";
-    for (const auto& p : presets) {
-        cout << "• " << p.getName()
-             << " (" << p.getDrinkType() << ")\n";
+    for (const auto& s : slots) {
+        if (!s.live) continue;
+        cout << "• " << s.preset.getName()
+             << " (" << toString(s.preset.getDrinkType()) << ")\n";
     }
 }
 
 
-// accessor
-Presets* PresetManager::getPresetByName(const string& name) {
-    for (auto& p : presets) {
-        if (p.getName() == name)
-            return &p;
-    }
-    return nullptr;
+// accessors
+// a name too long to store is never found (no prefix match)
+PresetHandle PresetManager::findPreset(string_view name) {
+    if (!presetNameFits(name)) return PresetHandle();
+    auto it = byName.find(name);
+    if (it == byName.end())
+        return faultIn(name);
+    return {it->second, slots[it->second].generation};
+}
+
+Presets* PresetManager::getPreset(PresetHandle handle) {
+    if (handle.index >= slots.size()) return nullptr;
+    Slot& s = slots[handle.index];
+    return (s.live && s.generation == handle.generation) ? &s.preset : nullptr;
+}
+
+const Presets* PresetManager::getPreset(PresetHandle handle) const {
+    if (handle.index >= slots.size()) return nullptr;
+    const Slot& s = slots[handle.index];
+    return (s.live && s.generation == handle.generation) ? &s.preset : nullptr;
+}
+
+Presets* PresetManager::getPresetByName(string_view name) {
+    PROBE_SCOPE("presets.lookup");
+    return getPreset(findPreset(name));
+}
+
+bool PresetManager::contains(string_view name) const {
+    if (!presetNameFits(name)) return false;
+    return byName.count(name) != 0 || (store && store->contains(name));
 }
 
 // to check if list is empty
 bool PresetManager::hasPresets() const {
-    return !presets.empty();
+    return size() != 0;
 }
 
-vector<string> PresetManager::getPresetNames() const {
-    vector<string> names;
-    for (const auto& p : presets) {
-        names.push_back(p.getName());
-    }
+// with a store attached every cached preset is also in the store
+size_t PresetManager::size() const {
+    return store ? store->size() : byName.size();
+}
+
+vector<string_view> PresetManager::getPresetNames() const {
+    vector<string_view> names;
+    getPresetNames(names);
     return names;
 }
+
+void PresetManager::getPresetNames(vector<string_view>& out) const {
+    loadAllFromStore();
+    out.clear();
+    out.reserve(byName.size());
+    for (const auto& s : slots) {
+        if (s.live) out.push_back(s.preset.getName());
+    }
+}
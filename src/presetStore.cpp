@@ -0,0 +1,525 @@
+#include "presetStore.hpp"
+#include <cstring>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+constexpr char     STORE_MAGIC[8]    = {'C', 'L', 'P', 'R', 'E', 'S', 'E', 'T'};
+constexpr uint32_t STORE_VERSION     = 1;
+constexpr size_t   MIN_TABLE_SLOTS   = 16;
+constexpr size_t   COMPACT_MIN_TAIL  = 1024;   // tail records before compaction is considered
+
+struct FileHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t baseCount;
+    uint64_t tableSlots;     // power of two; entry = record index + 1, 0 = empty
+    uint64_t tableOffset;
+    uint64_t baseOffset;
+    uint64_t tailOffset;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout is part of the file format");
+
+uint64_t fnv1a(const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t hashName(string_view name) {
+    return fnv1a(name.data(), name.size());
+}
+
+uint32_t recordChecksum(PresetRecord rec) {
+    rec.checksum = 0;
+    return static_cast<uint32_t>(fnv1a(&rec, sizeof(rec)));
+}
+
+/******************************************************************
+ * Function: validRecord
+ * ---------------------------------------------------------------
+ * A record read from the file is only used if its checksum
+ * matches, its name is NUL-terminated inside the field, and its
+ * state and enum fields are in range; anything else is treated
+ * as absent.
+ ******************************************************************/
+bool validRecord(const PresetRecord& rec) {
+    return rec.checksum == recordChecksum(rec) &&
+           memchr(rec.name, '\0', sizeof(rec.name)) != nullptr &&
+           (rec.state == RECORD_LIVE || rec.state == RECORD_TOMBSTONE) &&
+           rec.drinkType <= static_cast<uint8_t>(DrinkType::Latte) &&
+           rec.roast < ROAST_COUNT && rec.coffeeStrength < STRENGTH_COUNT &&
+           rec.shotSize < SHOT_SIZE_COUNT && rec.latteStrength < STRENGTH_COUNT &&
+           rec.milkStyle < MILK_STYLE_COUNT;
+}
+
+PresetRecord toRecord(const Presets& p, uint8_t state) {
+    PresetRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    string_view name = p.getName();
+    name.copy(rec.name, PRESET_NAME_MAX);
+    rec.state          = state;
+    rec.drinkType      = static_cast<uint8_t>(p.getDrinkType());
+    rec.roast          = static_cast<uint8_t>(p.getRoast());
+    rec.coffeeStrength = static_cast<uint8_t>(p.getStrength());
+    rec.shotSize       = static_cast<uint8_t>(p.getShotSize());
+    rec.latteStrength  = static_cast<uint8_t>(p.getLatteStrength());
+    rec.milkStyle      = static_cast<uint8_t>(p.getMilkStyle());
+    rec.shots          = p.getShots();
+    rec.coffeeCups     = p.getCups();
+    rec.milkRatio      = p.getMilkRatio();
+    rec.checksum       = recordChecksum(rec);
+    return rec;
+}
+
+Presets fromRecord(const PresetRecord& rec) {
+    Presets p(string_view(rec.name));
+    if (static_cast<DrinkType>(rec.drinkType) == DrinkType::Coffee) {
+        p.setCoffee(static_cast<Roast>(rec.roast),
+                    static_cast<Strength>(rec.coffeeStrength), rec.coffeeCups);
+    } else {
+        p.setLatte(static_cast<ShotSize>(rec.shotSize), rec.shots,
+                   static_cast<Strength>(rec.latteStrength),
+                   static_cast<MilkStyle>(rec.milkStyle), rec.milkRatio);
+    }
+    return p;
+}
+
+size_t tableSlotsFor(size_t count) {
+    size_t slots = MIN_TABLE_SLOTS;
+    while (slots < count * 2) slots *= 2;
+    return slots;
+}
+
+uint64_t alignTo(uint64_t value, uint64_t align) {
+    return (value + align - 1) / align * align;
+}
+
+#ifndef _WIN32
+/******************************************************************
+ * Class: StoreLock
+ * ---------------------------------------------------------------
+ * Exclusive flock on "<path>.lock" for as long as it lives. The
+ * store file itself is replaced by rename, so the lock lives on a
+ * separate file whose inode never changes: whoever holds it sees
+ * the current image and no other process can swap it meanwhile.
+ ******************************************************************/
+class StoreLock {
+
+    public:
+
+        explicit StoreLock(const string& path)
+            : fd(::open((path + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644)) {
+            if (fd >= 0 && ::flock(fd, LOCK_EX) != 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        ~StoreLock() {
+            if (fd >= 0) ::close(fd);   // releases the flock
+        }
+
+        StoreLock(const StoreLock&) = delete;
+        StoreLock& operator=(const StoreLock&) = delete;
+
+        bool held() const { return fd >= 0; }
+
+    private:
+
+        int fd;
+};
+
+bool writeAll(int fd, const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+/******************************************************************
+ * Function: writeImage
+ * ---------------------------------------------------------------
+ * Writes a complete compacted file (header, hash table, records)
+ * to a temporary path, syncs it, and renames it over path.
+ ******************************************************************/
+bool writeImage(const string& path, const vector<PresetRecord>& records) {
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STORE_MAGIC, sizeof(header.magic));
+    header.version     = STORE_VERSION;
+    header.recordSize  = sizeof(PresetRecord);
+    header.baseCount   = records.size();
+    header.tableSlots  = tableSlotsFor(records.size());
+    header.tableOffset = sizeof(FileHeader);
+    header.baseOffset  = alignTo(header.tableOffset + header.tableSlots * sizeof(uint32_t),
+                                 sizeof(PresetRecord));
+    header.tailOffset  = header.baseOffset + records.size() * sizeof(PresetRecord);
+
+    vector<uint32_t> table(header.tableSlots, 0);
+    uint64_t mask = header.tableSlots - 1;
+    for (size_t i = 0; i < records.size(); ++i) {
+        uint64_t h = hashName(records[i].name) & mask;
+        while (table[h] != 0) h = (h + 1) & mask;
+        table[h] = static_cast<uint32_t>(i + 1);
+    }
+
+    string tmpPath = path + ".tmp";
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+
+    vector<char> padding(header.baseOffset - header.tableOffset
+                         - table.size() * sizeof(uint32_t), 0);
+    bool ok = writeAll(fd, &header, sizeof(header))
+           && writeAll(fd, table.data(), table.size() * sizeof(uint32_t))
+           && writeAll(fd, padding.data(), padding.size())
+           && writeAll(fd, records.data(), records.size() * sizeof(PresetRecord))
+           && ::fsync(fd) == 0;
+    ::close(fd);
+
+    if (!ok || ::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        ::unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+PresetStore::~PresetStore() {
+    close();
+}
+
+/******************************************************************
+ * Function: PresetStore::open
+ * ---------------------------------------------------------------
+ * Maps the base of an existing store and replays its write-ahead
+ * tail, under the store lock. A torn record at the end of the
+ * tail is truncated away.
+ *
+ * Returns:
+ *   true if the store is usable (including a missing file),
+ *   false if the file cannot be opened or locked, or is not a
+ *   preset store.
+ ******************************************************************/
+bool PresetStore::open(const string& filePath) {
+    close();
+#ifdef _WIN32
+    (void)filePath;
+    return false;   // persistence needs mmap; Windows builds stay in-memory
+#else
+    path = filePath;
+    StoreLock lock(path);
+    if (!lock.held() || !refresh()) {
+        close();
+        return false;
+    }
+    return true;
+#endif
+}
+
+void PresetStore::close() {
+    dropFile();
+    path.clear();
+}
+
+// forgets the mapping, descriptor and tail (path stays)
+void PresetStore::dropFile() {
+    unmap();
+#ifndef _WIN32
+    if (fd >= 0) ::close(fd);
+#endif
+    fd = -1;
+    fileEnd = 0;
+    tail.clear();
+    tailIndex.clear();
+    liveCount = 0;
+}
+
+/******************************************************************
+ * Function: PresetStore::refresh
+ * ---------------------------------------------------------------
+ * Called with the store lock held. Keeps the current mapping if
+ * it is still the file at path and nobody appended to it since;
+ * otherwise remaps it. Only a missing file (ENOENT) counts as an
+ * empty store: any other open/stat failure is an error, so a
+ * later write can never replace presets it could not read.
+ ******************************************************************/
+bool PresetStore::refresh() {
+#ifdef _WIN32
+    return false;
+#else
+    struct stat onDisk, current;
+    if (::stat(path.c_str(), &onDisk) != 0) {
+        if (errno != ENOENT) return false;
+        dropFile();   // missing (or removed behind us): created on first append
+        return true;
+    }
+    if (fd >= 0 && ::fstat(fd, &current) == 0 && current.st_dev == onDisk.st_dev &&
+        current.st_ino == onDisk.st_ino && static_cast<uint64_t>(current.st_size) == fileEnd)
+        return true;
+
+    dropFile();
+    fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) return errno == ENOENT;
+    return mapFile();
+#endif
+}
+
+bool PresetStore::mapFile() {
+#ifdef _WIN32
+    return false;
+#else
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader))
+        return false;
+    uint64_t fileSize = static_cast<uint64_t>(st.st_size);
+
+    FileHeader header;
+    if (::pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        return false;
+    // every offset and length must lie inside the file, in order and aligned; the
+    // table needs an empty slot (probes stop there) and entries fit in 32 bits
+    if (memcmp(header.magic, STORE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != STORE_VERSION ||
+        header.recordSize != sizeof(PresetRecord) ||
+        header.tableSlots == 0 || (header.tableSlots & (header.tableSlots - 1)) != 0 ||
+        header.tableSlots > fileSize / sizeof(uint32_t) ||
+        header.baseCount >= header.tableSlots || header.baseCount > UINT32_MAX ||
+        header.tableOffset < sizeof(FileHeader) || header.tableOffset % sizeof(uint32_t) != 0 ||
+        header.tableOffset > fileSize ||
+        header.baseOffset < header.tableOffset + header.tableSlots * sizeof(uint32_t) ||
+        header.baseOffset % sizeof(PresetRecord) != 0 || header.baseOffset > fileSize ||
+        header.baseCount > (fileSize - header.baseOffset) / sizeof(PresetRecord) ||
+        header.tailOffset != header.baseOffset + header.baseCount * sizeof(PresetRecord))
+        return false;
+
+    void* p = ::mmap(nullptr, header.tailOffset, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        return false;
+
+    mapped     = static_cast<const unsigned char*>(p);
+    mappedSize = header.tailOffset;
+    table      = reinterpret_cast<const uint32_t*>(mapped + header.tableOffset);
+    base       = reinterpret_cast<const PresetRecord*>(mapped + header.baseOffset);
+    tableSlots = header.tableSlots;
+    baseCount  = header.baseCount;
+    tailOffset = header.tailOffset;
+    liveCount  = baseCount;
+
+    // replay the tail; stop (and truncate) at the first torn record
+    uint64_t offset = tailOffset;
+    PresetRecord rec;
+    while (offset + sizeof(rec) <= fileSize &&
+           ::pread(fd, &rec, sizeof(rec), static_cast<off_t>(offset)) == static_cast<ssize_t>(sizeof(rec)) &&
+           validRecord(rec)) {
+        bool wasLive = findLive(rec.name) != nullptr;
+        tail.push_back(rec);
+        tailIndex[tail.back().name] = tail.size() - 1;
+        liveCount = liveCount + (rec.state == RECORD_LIVE) - wasLive;
+        offset += sizeof(rec);
+    }
+    if (offset != fileSize && ::ftruncate(fd, static_cast<off_t>(offset)) != 0)
+        return false;
+    fileEnd = offset;
+    return true;
+#endif
+}
+
+void PresetStore::unmap() {
+#ifndef _WIN32
+    if (mapped) ::munmap(const_cast<unsigned char*>(mapped), mappedSize);
+#endif
+    mapped = nullptr;
+    mappedSize = 0;
+    table = nullptr;
+    base = nullptr;
+    tableSlots = 0;
+    baseCount = 0;
+    tailOffset = 0;
+}
+
+// mapped base record i, or nullptr if it is out of range or fails validRecord
+const PresetRecord* PresetStore::baseRecord(uint64_t i) const {
+    if (i >= baseCount) return nullptr;
+    const PresetRecord& rec = base[i];
+    return (validRecord(rec) && rec.state == RECORD_LIVE) ? &rec : nullptr;
+}
+
+// probes the mapped hash table; nullptr if name is not in the base
+const PresetRecord* PresetStore::findBase(string_view name) const {
+    if (tableSlots == 0) return nullptr;
+    uint64_t mask = tableSlots - 1;
+    uint64_t h = hashName(name) & mask;
+    for (uint64_t probes = 0; probes < tableSlots && table[h] != 0; ++probes) {
+        const PresetRecord* rec = baseRecord(table[h] - 1);
+        if (rec && name == rec->name) return rec;
+        h = (h + 1) & mask;
+    }
+    return nullptr;
+}
+
+// newest record for name, or nullptr if missing / deleted (or too long to store)
+const PresetRecord* PresetStore::findLive(string_view name) const {
+    if (!presetNameFits(name)) return nullptr;
+    auto it = tailIndex.find(name);
+    if (it != tailIndex.end()) {
+        const PresetRecord& rec = tail[it->second];
+        return (rec.state == RECORD_LIVE) ? &rec : nullptr;
+    }
+    return findBase(name);
+}
+
+bool PresetStore::appendRecord(const PresetRecord& rec) {
+#ifdef _WIN32
+    (void)rec;
+    return false;
+#else
+    if (fd < 0) {
+        // first write (refresh() saw ENOENT under the lock): lay down an empty base
+        if (!writeImage(path, {})) return false;
+        fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+        if (fd < 0 || !mapFile()) return false;
+    }
+
+    if (::pwrite(fd, &rec, sizeof(rec), static_cast<off_t>(fileEnd)) != static_cast<ssize_t>(sizeof(rec)))
+        return false;
+    fileEnd += sizeof(rec);
+
+    bool wasLive = findLive(rec.name) != nullptr;
+    tail.push_back(rec);
+    tailIndex[tail.back().name] = tail.size() - 1;
+    liveCount = liveCount + (rec.state == RECORD_LIVE) - wasLive;
+    return true;
+#endif
+}
+
+/******************************************************************
+ * Function: PresetStore::append / remove
+ * ---------------------------------------------------------------
+ * Under the store lock: pick up whatever another process wrote,
+ * then check and append, so the check sees the current file.
+ ******************************************************************/
+bool PresetStore::append(const Presets& preset) {
+#ifdef _WIN32
+    (void)preset;
+    return false;
+#else
+    if (!isOpen()) return false;
+    StoreLock lock(path);
+    if (!lock.held() || !refresh()) return false;
+    if (findLive(preset.getName())) return false;
+    if (!appendRecord(toRecord(preset, RECORD_LIVE))) return false;
+    maybeCompact();
+    return true;
+#endif
+}
+
+bool PresetStore::remove(string_view name) {
+#ifdef _WIN32
+    (void)name;
+    return false;
+#else
+    if (!isOpen()) return false;
+    StoreLock lock(path);
+    if (!lock.held() || !refresh()) return false;
+    if (!findLive(name)) return false;
+
+    Presets stub(name);
+    if (!appendRecord(toRecord(stub, RECORD_TOMBSTONE))) return false;
+    maybeCompact();
+    return true;
+#endif
+}
+
+bool PresetStore::find(string_view name, Presets& out) const {
+    const PresetRecord* rec = findLive(name);
+    if (!rec) return false;
+    out = fromRecord(*rec);
+    return true;
+}
+
+bool PresetStore::contains(string_view name) const {
+    return findLive(name) != nullptr;
+}
+
+void PresetStore::forEach(const function<void(const Presets&)>& fn) const {
+    for (uint64_t i = 0; i < baseCount; ++i) {
+        const PresetRecord* rec = baseRecord(i);
+        if (rec && !tailIndex.count(rec->name)) fn(fromRecord(*rec));
+    }
+    for (size_t i = 0; i < tail.size(); ++i) {
+        const PresetRecord& rec = tail[i];
+        if (rec.state == RECORD_LIVE && tailIndex.at(rec.name) == i) fn(fromRecord(rec));
+    }
+}
+
+// compacts once the tail is both large and a sizeable share of the base (lock held)
+void PresetStore::maybeCompact() {
+    if (tail.size() >= COMPACT_MIN_TAIL && tail.size() * 2 >= baseCount)
+        compactLocked();
+}
+
+/******************************************************************
+ * Function: PresetStore::compact
+ * ---------------------------------------------------------------
+ * Folds the tail into a new base (dropping tombstones, shadowed
+ * and invalid records), replaces the file atomically, and remaps
+ * it. The store lock is held from reading the current image to
+ * mapping the new one.
+ ******************************************************************/
+bool PresetStore::compact() {
+#ifdef _WIN32
+    return false;
+#else
+    if (!isOpen()) return false;
+    StoreLock lock(path);
+    return lock.held() && refresh() && compactLocked();
+#endif
+}
+
+bool PresetStore::compactLocked() {
+#ifdef _WIN32
+    return false;
+#else
+    vector<PresetRecord> records;
+    records.reserve(liveCount);
+    for (uint64_t i = 0; i < baseCount; ++i) {
+        const PresetRecord* rec = baseRecord(i);
+        if (rec && !tailIndex.count(rec->name)) records.push_back(*rec);
+    }
+    for (size_t i = 0; i < tail.size(); ++i) {
+        const PresetRecord& rec = tail[i];
+        if (rec.state == RECORD_LIVE && tailIndex.at(rec.name) == i) records.push_back(rec);
+    }
+
+    if (!writeImage(path, records)) return false;
+
+    dropFile();
+    fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    return fd >= 0 && mapFile();
+#endif
+}
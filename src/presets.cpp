@@ -2,25 +2,25 @@
 #include <iostream>
 using namespace std; 
 
-// constructor
-    Presets::Presets(const string& name) : name(name) {}
+// constructor (name is copied into the fixed buffer; callers check presetNameFits)
+    Presets::Presets(string_view name) {
+        size_t len = name.copy(this->name, PRESET_NAME_MAX);
+        this->name[len] = '\0';
+    }
 
 // setups
-    void Presets::setCoffee(const string& roast,
-                            const string& strength,
-                            double cups)
+    void Presets::setCoffee(Roast roast, Strength strength, double cups)
     {
-        drinkType = "coffee";
+        drinkType = DrinkType::Coffee;
         coffeeRoast = roast;
         coffeeStrength = strength;
         coffeeCups = cups;
     }
     
-    void Presets::setLatte(const string& shotSize, int shots, 
-                       const string& strength,
-                       const string& milkStyle, double ratio) {
+    void Presets::setLatte(ShotSize shotSize, int shots, Strength strength,
+                           MilkStyle milkStyle, double ratio) {
 
-        drinkType = "latte";
+        drinkType = DrinkType::Latte;
         this->shotSize = shotSize;
         this->shots = shots;
         this->latteStrength = strength;
@@ -32,24 +32,24 @@ using namespace std;
 
 
 // accessors
-    string Presets::getName() const { 
+    string_view Presets::getName() const { 
         return name; 
         
     }
     
-    string Presets::getDrinkType() const { 
+    DrinkType Presets::getDrinkType() const { 
         return drinkType; 
         
     }
     
 
 // coffee accessors
-    string Presets::getRoast() const { 
+    Roast Presets::getRoast() const { 
         return coffeeRoast; 
         
     }
     
-    string Presets::getStrength() const { 
+    Strength Presets::getStrength() const { 
         return coffeeStrength; 
         
     }
@@ -61,7 +61,7 @@ using namespace std;
     
 
 // latte accessors
-    string Presets::getShotSize() const { 
+    ShotSize Presets::getShotSize() const { 
         return shotSize; 
         
     }
@@ -71,12 +71,12 @@ using namespace std;
         
     }
     
-    string Presets::getLatteStrength() const { 
+    Strength Presets::getLatteStrength() const { 
         return latteStrength; 
         
     }
     
-    string Presets::getMilkStyle() const { 
+    MilkStyle Presets::getMilkStyle() const { 
         return milkStyle; 
         
     }
@@ -91,20 +91,20 @@ using namespace std;
     ostream& operator<<(ostream& out, const Presets& p){
         
         out << "\n=== Preset: " << p.name << " ===\n";
-        out << "Type: " << p.drinkType << "\n";
+        out << "Type: " << toString(p.drinkType) << "\n";
         
         // coffee preset
-        if (p.drinkType == "coffee") {
-            out << "Roast:            " << p.coffeeRoast << "\n";
-            out << "Strength:         " << p.coffeeStrength << "\n";
+        if (p.drinkType == DrinkType::Coffee) {
+            out << "Roast:            " << toString(p.coffeeRoast) << "\n";
+            out << "Strength:         " << toString(p.coffeeStrength) << "\n";
             out << "Cups:             " << p.coffeeCups << "\n";
         }
         // latte preset
         else {
-            out << "Shot Size:        " << p.shotSize << "\n";
+            out << "Shot Size:        " << toString(p.shotSize) << "\n";
             out << "Shots:            " << p.shots << "\n";
-            out << "Strength:         " << p.latteStrength << "\n";
-            out << "Milk Style:       " << p.milkStyle << "\n";
+            out << "Strength:         " << toString(p.latteStrength) << "\n";
+            out << "Milk Style:       " << toString(p.milkStyle) << "\n";
             out << "Milk Ratio:       " << p.milkRatio << "\n";
         }
         
@@ -0,0 +1,93 @@
+#include "summaryFormat.hpp"
+#include <charconv>
+#include <cstring>
+using namespace std;
+
+SummaryWriter::SummaryWriter(char* buffer, size_t capacity)
+    : data(buffer), capacity(capacity > 0 ? capacity - 1 : 0) {
+    if (capacity > 0) data[0] = '\0';
+}
+
+void SummaryWriter::clear() {
+    used = 0;
+    overflow = false;
+    data[0] = '\0';
+}
+
+SummaryWriter& SummaryWriter::append(string_view s) {
+    size_t n = s.size();
+    if (n > capacity - used) {
+        n = capacity - used;
+        overflow = true;
+    }
+    memcpy(data + used, s.data(), n);
+    used += n;
+    data[used] = '\0';
+    return *this;
+}
+
+SummaryWriter& SummaryWriter::append(char c) {
+    return append(string_view(&c, 1));
+}
+
+SummaryWriter& SummaryWriter::appendInt(long long v) {
+    char tmp[24];
+    auto res = to_chars(tmp, tmp + sizeof(tmp), v);
+    return append(string_view(tmp, static_cast<size_t>(res.ptr - tmp)));
+}
+
+SummaryWriter& SummaryWriter::appendFixed2(double v) {
+    char tmp[64];
+    auto res = to_chars(tmp, tmp + sizeof(tmp), v, chars_format::fixed, 2);
+    if (res.ec != errc()) return append("?");
+    return append(string_view(tmp, static_cast<size_t>(res.ptr - tmp)));
+}
+
+/******************************************************************
+ * Function: formatCoffeeSummary
+ * ---------------------------------------------------------------
+ * Writes the console coffee summary (same text the interactive
+ * calculator has always printed, numbers to 2 decimals).
+ ******************************************************************/
+void formatCoffeeSummary(SummaryWriter& out, const CoffeeResult& r, Roast roast, Strength strength) {
+    out.append("\n--- Coffee Summary ---\n");
+    out.append("Roast Type:         ").append(toString(roast)).append('\n');
+    out.append("Strength:           ").append(toString(strength))
+       .append(" (1:").appendFixed2(r.ratio).append(")\n");
+    out.append("Required Water:     ").appendFixed2(r.waterCups)
+       .append(" cup(s) (").appendFixed2(r.waterML).append(" mL)\n");
+    out.append("Coffee Grounds:     ").appendFixed2(r.coffeeGrams)
+       .append(" g (").appendFixed2(r.tablespoons).append(" tbsp)\n");
+    out.append("Enjoy your coffee!\n");
+}
+
+/******************************************************************
+ * Function: formatLatteSummary
+ * ---------------------------------------------------------------
+ * Writes the console latte summary, including the milk lines when
+ * a milk target is set.
+ ******************************************************************/
+void formatLatteSummary(SummaryWriter& out, const LatteResult& r, Strength strength) {
+    out.append("\n--- Latte Summary ---\n");
+    out.append("Strength (brew):      ").append(toString(strength))
+       .append(" (espresso 1:").appendFixed2(r.brewRatio).append(")\n");
+    out.append("Shot Plan:            ").appendInt(r.shots)
+       .append(" x ").append(toString(r.shotSize)).append(" shot(s)\n");
+    out.append("Coffee Grounds:       ").appendFixed2(r.coffeeGrams)
+       .append(" g (").appendFixed2(r.tablespoons).append(" tbsp)\n");
+    out.append("Espresso Output:      ").appendFixed2(r.espressoCups)
+       .append(" cup(s) (").appendFixed2(r.espressoML).append(" mL)\n");
+
+    if (r.hasMilkTarget) {
+        out.append("Milk Style Target:    ").append(toString(r.milkStyle))
+           .append(" (milk:espresso = ").appendFixed2(r.milkToEspRatio).append(":1)\n");
+        out.append("Milk Volume:          ").appendFixed2(r.milkCups)
+           .append(" cup(s) (").appendFixed2(r.milkML).append(" mL)\n");
+        out.append("Estimated Final Size: ").appendFixed2(r.finalCups)
+           .append(" cup(s) (").appendFixed2(r.finalML).append(" mL)\n");
+    } else {
+        out.append("Milk:                 to taste (add milk to reach your preferred latte size)\n");
+    }
+
+    out.append("Enjoy your latte!\n");
+}
@@ -0,0 +1,133 @@
+#include "uiReplay.hpp"
+#include <cstring>
+using namespace std;
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 1469598103934665603ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+struct KeyName {
+    string_view name;
+    UiKey key;
+};
+
+constexpr KeyName KEY_NAMES[] = {
+    {"up", UiKey::Up},
+    {"down", UiKey::Down},
+    {"left", UiKey::Left},
+    {"enter", UiKey::Enter},
+    {"esc", UiKey::Escape},
+    {"backspace", UiKey::Backspace},
+};
+
+string_view trim(string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+uint64_t fnv(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+} // namespace
+
+/******************************************************************
+ * Function: parseUiTrace
+ * ---------------------------------------------------------------
+ * Appends the events of a text trace to out.
+ *
+ * Returns:
+ *   false on an unknown event, with its line number in errorLine.
+ ******************************************************************/
+bool parseUiTrace(string_view text, vector<UiEvent>& out, size_t& errorLine) {
+    size_t lineNo = 0;
+    while (!text.empty()) {
+        size_t nl = text.find('\n');
+        string_view line = text.substr(0, nl);
+        text = (nl == string_view::npos) ? string_view() : text.substr(nl + 1);
+        ++lineNo;
+
+        // text keeps inner and trailing spaces as typed
+        if (line.size() >= 5 && line.compare(0, 5, "text ") == 0) {
+            if (line.back() == '\r') line.remove_suffix(1);
+            for (char c : line.substr(5)) out.push_back({UiKey::Char, c});
+            continue;
+        }
+
+        line = trim(line);
+        if (line.empty() || line.front() == '#') continue;
+
+        bool known = false;
+        for (const KeyName& k : KEY_NAMES) {
+            if (line == k.name) {
+                out.push_back({k.key, 0});
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            errorLine = lineNo;
+            return false;
+        }
+    }
+    return true;
+}
+
+void writeUiEvent(ostream& out, const UiEvent& event) {
+    if (event.key == UiKey::Char) {
+        out << "text " << event.ch << '\n';
+        return;
+    }
+    for (const KeyName& k : KEY_NAMES) {
+        if (k.key == event.key) {
+            out << k.name << '\n';
+            return;
+        }
+    }
+}
+
+/******************************************************************
+ * Function: replayUiTrace
+ * ---------------------------------------------------------------
+ * Pushes recorded events through the machine as fast as it takes
+ * them. The digest folds in the screen after every event and the
+ * text of every summary, so two builds that replay a trace to the
+ * same digest walked the same screens and printed the same drinks.
+ * A confirmed Quit is cleared so the trace continues.
+ ******************************************************************/
+ReplayStats replayUiTrace(UiMachine& machine, const vector<UiEvent>& events,
+                          void (*onScreen)(const UiMachine&)) {
+    ReplayStats stats;
+    uint64_t h = FNV_OFFSET;
+
+    for (const UiEvent& e : events) {
+        Screen before = machine.state().screen;
+        stats.handled += machine.handle(e);
+        ++stats.events;
+
+        const UiState& ui = machine.state();
+        unsigned char screen = static_cast<unsigned char>(ui.screen);
+        h = fnv(h, &screen, 1);
+
+        if (ui.screen != before && (ui.screen == Screen::Summary || ui.screen == Screen::Error)) {
+            if (ui.screen == Screen::Summary) {
+                ++stats.summaries;
+                h = fnv(h, ui.summary, strlen(ui.summary));
+            } else {
+                ++stats.errors;
+                h = fnv(h, ui.message, strlen(ui.message));
+            }
+            if (onScreen) onScreen(machine);
+        }
+        if (machine.quitRequested()) machine.clearQuit();
+    }
+    stats.digest = h;
+    return stats;
+}
@@ -0,0 +1,609 @@
+#include "uiStateMachine.hpp"
+#include "orderCache.hpp"
+#include "orderAnalytics.hpp"
+#include "constants.hpp"
+#include "instrumentation.hpp"
+#include "presets.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+using namespace std;
+
+namespace {
+
+using Handler = void (*)(UiMachine&);
+
+// one row per Screen: defaults applied on entry, then the handlers
+struct ScreenSpec {
+    Screen             screen;         // row check (static_assert below)
+    const char*        prompt;
+    InputMode          input;
+    const char* const* options;
+    size_t             optionCount;
+    Handler            enter;          // dynamic setup, may be null
+    Handler            confirm;        // Enter, may be null
+};
+
+const char* const MAIN_MENU_OPTIONS[]   = {"Make a drink", "Create preset", "Load preset", "Quit"};
+const char* const DRINK_OPTIONS[]       = {"coffee", "latte"};
+const char* const ROAST_OPTIONS[]       = {"light", "medium", "dark"};
+const char* const COFFEE_STRENGTHS[]    = {"bolder", "medium", "weaker"};
+const char* const LATTE_STRENGTHS[]     = {"stronger", "weaker"};
+const char* const SHOT_SIZE_OPTIONS[]   = {"single", "double"};
+const char* const MILK_STYLE_OPTIONS[]  = {"none", "cortado", "flatwhite", "latte", "custom"};
+const char* const YES_NO_OPTIONS[]      = {"No", "Yes"};
+const char* const COFFEE_ADDON_OPTIONS[] = {"Ice (Cold Drink)", "Topping", "Done"};
+const char* const LATTE_ADDON_OPTIONS[]  = {"Ice (Cold Drink)", "Topping", "Extra Shots", "Done"};
+
+void setRange(UiState& ui, double start, double step, double min, const char* label) {
+    ui.value = start;
+    ui.step = step;
+    ui.minValue = min;
+    ui.valueLabel = label;
+}
+
+// drink is complete: calculate and show the summary
+void finishDrink(UiMachine& m) {
+    bool ok = (m.state().drinkType == DrinkType::Coffee) ? m.computeCoffee() : m.computeLatte();
+    if (!ok) {
+        m.enterScreen(Screen::Error);
+        m.setMessage("Calculation error.");
+    }
+}
+
+// --- enter handlers ---------------------------------------------
+
+void enterChooseDrink(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.selected = (ui.drinkType == DrinkType::Latte) ? 1 : 0;
+}
+
+void enterCoffeeRoast(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.selected = indexOf(ui.roastType);
+}
+
+void enterCoffeeStrength(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.selected = isCoffeeStrength(ui.coffeeStrength) ? indexOf(ui.coffeeStrength) : 0;
+}
+
+void enterCoffeeCups(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    setRange(ui, (ui.coffeeCups > 0.0) ? ui.coffeeCups : 1.0, 0.5, 0.5, "cups");
+}
+
+void enterLatteStrength(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.selected = (ui.latteStrength == Strength::Weaker) ? 1 : 0;
+}
+
+void enterLatteShotSize(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.selected = indexOf(ui.latteShotSize);
+}
+
+void enterLatteShots(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    setRange(ui, (ui.latteShots > 0) ? ui.latteShots : 1, 1, 1, "shots");
+}
+
+void enterLatteMilkStyle(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.selected = indexOf(ui.latteMilkStyle);
+}
+
+void enterLatteMilkRatio(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    setRange(ui, (ui.latteMilkRatio > 0.0) ? ui.latteMilkRatio : 2.0, 0.1, 0.0, "ratio");
+}
+
+void enterPresetName(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.textInput = ui.presetName;
+}
+
+void enterLoadPresetList(UiMachine& m) {
+    m.presetManager().getPresetNames(m.presetNames());
+    m.mutableState().optionCount = m.presetNames().size();
+}
+
+void enterAddonsList(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    if (ui.drinkType == DrinkType::Coffee) {
+        ui.options = COFFEE_ADDON_OPTIONS;
+        ui.optionCount = size(COFFEE_ADDON_OPTIONS);
+    } else {
+        ui.options = LATTE_ADDON_OPTIONS;
+        ui.optionCount = size(LATTE_ADDON_OPTIONS);
+    }
+}
+
+void enterToppingInput(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.textInput = ui.topping;
+}
+
+void enterExtraShots(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    setRange(ui, (ui.extraShots > 0) ? ui.extraShots : 1, 1, 1, "extra");
+}
+
+// --- confirm handlers -------------------------------------------
+
+void confirmMainMenu(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    switch (ui.selected) {
+    case 0:
+        ui.flow = Flow::Make;
+        ui.isIced = false;
+        ui.topping.clear();
+        ui.extraShots = 0;
+        m.goTo(Screen::ChooseDrink);
+        break;
+    case 1:
+        ui.flow = Flow::CreatePreset;
+        m.goTo(Screen::PresetName);
+        break;
+    case 2:
+        if (!m.presetManager().hasPresets()) {
+            m.enterScreen(Screen::Error);
+            m.setMessage("No presets saved yet.");
+            break;
+        }
+        ui.flow = Flow::LoadPreset;
+        m.goTo(Screen::LoadPresetList);
+        break;
+    default:
+        m.requestQuit();
+        break;
+    }
+}
+
+void confirmChooseDrink(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    parseDrinkType(m.option(ui.selected), ui.drinkType);
+    m.goTo(ui.drinkType == DrinkType::Coffee ? Screen::CoffeeRoast : Screen::LatteStrength);
+}
+
+void confirmCoffeeRoast(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    parseRoast(m.option(ui.selected), ui.roastType);
+    m.goTo(Screen::CoffeeStrength);
+}
+
+void confirmCoffeeStrength(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    parseStrength(m.option(ui.selected), ui.coffeeStrength);
+    m.goTo(Screen::CoffeeCups);
+}
+
+void confirmCoffeeCups(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.coffeeCups = ui.value;
+    m.goTo(Screen::AddonsPrompt);
+}
+
+void confirmLatteStrength(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    parseStrength(m.option(ui.selected), ui.latteStrength);
+    m.goTo(Screen::LatteShotSize);
+}
+
+void confirmLatteShotSize(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    parseShotSize(m.option(ui.selected), ui.latteShotSize);
+    m.goTo(Screen::LatteShots);
+}
+
+void confirmLatteShots(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    if (ui.value > 5.0 && !ui.warningShown) {
+        m.setMessage("Warning: High caffeine content! Enter again to confirm.");
+        ui.warningShown = true;
+        return;
+    }
+    ui.latteShots = static_cast<int>(ui.value);
+    m.goTo(Screen::LatteMilkStyle);
+}
+
+void confirmLatteMilkStyle(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    parseMilkStyle(m.option(ui.selected), ui.latteMilkStyle);
+    if (ui.latteMilkStyle == MilkStyle::Custom) {
+        m.goTo(Screen::LatteMilkRatio);
+    } else {
+        ui.latteMilkRatio = milkStyleToRatio(ui.latteMilkStyle);
+        m.goTo(Screen::AddonsPrompt);
+    }
+}
+
+void confirmLatteMilkRatio(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.latteMilkRatio = ui.value;
+    m.goTo(Screen::AddonsPrompt);
+}
+
+void confirmPresetName(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    if (ui.textInput.empty()) {
+        m.setMessage("Preset name cannot be empty.");
+    } else if (!presetNameFits(ui.textInput)) {
+        m.setMessage("Preset name must be at most " + std::to_string(PRESET_NAME_MAX) + " characters.");
+    } else if (m.presetManager().contains(ui.textInput)) {
+        m.setMessage("A preset with that name already exists.");
+    } else {
+        ui.presetName = ui.textInput;
+        m.goTo(Screen::ChooseDrink);
+    }
+}
+
+void confirmLoadPreset(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    if (ui.optionCount == 0) return;
+
+    Presets* p = m.presetManager().getPresetByName(m.option(ui.selected));
+    if (!p) {
+        m.enterScreen(Screen::Error);
+        m.setMessage("Preset not found.");
+        return;
+    }
+
+    ui.drinkType = p->getDrinkType();
+    bool ok;
+    if (ui.drinkType == DrinkType::Coffee) {
+        ui.roastType = p->getRoast();
+        ui.coffeeStrength = p->getStrength();
+        ui.coffeeCups = p->getCups();
+        ok = m.computeCoffee();
+    } else {
+        ui.latteShotSize = p->getShotSize();
+        ui.latteShots = p->getShots();
+        ui.latteStrength = p->getLatteStrength();
+        ui.latteMilkStyle = p->getMilkStyle();
+        ui.latteMilkRatio = p->getMilkRatio();
+        ok = m.computeLatte();
+    }
+    if (!ok) {
+        m.enterScreen(Screen::Error);
+        m.setMessage("Error loading preset.");
+    }
+}
+
+void confirmAddonsPrompt(UiMachine& m) {
+    if (m.state().selected == 1)   // Yes
+        m.goTo(Screen::AddonsList);
+    else
+        finishDrink(m);
+}
+
+void confirmAddonsList(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    string_view choice = m.option(ui.selected);
+    if (choice == "Done") {
+        finishDrink(m);
+    } else if (choice == "Ice (Cold Drink)") {
+        ui.isIced = !ui.isIced;
+        m.setMessage(ui.isIced ? "Drink is now Iced" : "Drink is now Hot");
+    } else if (choice == "Topping") {
+        m.goTo(Screen::ToppingInput);
+    } else if (choice == "Extra Shots") {
+        m.goTo(Screen::ExtraShotsInput);
+    }
+}
+
+void confirmToppingInput(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.topping = ui.textInput;
+    m.goBack();   // AddonsList
+    char buf[UI_MESSAGE_CAPACITY];
+    SummaryWriter msg(buf);
+    msg.append("Added topping: ").append(ui.topping);
+    m.setMessage(msg.view());
+}
+
+void confirmExtraShots(UiMachine& m) {
+    UiState& ui = m.mutableState();
+    ui.extraShots = static_cast<int>(ui.value);
+    m.goBack();   // AddonsList
+    char buf[UI_MESSAGE_CAPACITY];
+    SummaryWriter msg(buf);
+    msg.append("Added ").appendInt(ui.extraShots).append(" extra shots.");
+    m.setMessage(msg.view());
+}
+
+void confirmDone(UiMachine& m) {
+    m.resetToMenu();
+}
+
+#define OPTIONS(list) list, size(list)
+
+constexpr ScreenSpec SCREENS[SCREEN_COUNT] = {
+    {Screen::MainMenu,        "Select an action",                            InputMode::Options, OPTIONS(MAIN_MENU_OPTIONS),  nullptr,             confirmMainMenu},
+    {Screen::ChooseDrink,     "Choose drink type",                           InputMode::Options, OPTIONS(DRINK_OPTIONS),      enterChooseDrink,    confirmChooseDrink},
+    {Screen::CoffeeRoast,     "Select roast",                                InputMode::Options, OPTIONS(ROAST_OPTIONS),      enterCoffeeRoast,    confirmCoffeeRoast},
+    {Screen::CoffeeStrength,  "Coffee strength",                             InputMode::Options, OPTIONS(COFFEE_STRENGTHS),   enterCoffeeStrength, confirmCoffeeStrength},
+    {Screen::CoffeeCups,      "Cups (Up/Down, Enter to confirm)",            InputMode::Value,   nullptr, 0,                  enterCoffeeCups,     confirmCoffeeCups},
+    {Screen::LatteStrength,   "Latte strength",                              InputMode::Options, OPTIONS(LATTE_STRENGTHS),    enterLatteStrength,  confirmLatteStrength},
+    {Screen::LatteShotSize,   "Shot size",                                   InputMode::Options, OPTIONS(SHOT_SIZE_OPTIONS),  enterLatteShotSize,  confirmLatteShotSize},
+    {Screen::LatteShots,      "Number of shots (Up/Down, Enter to confirm)", InputMode::Value,   nullptr, 0,                  enterLatteShots,     confirmLatteShots},
+    {Screen::LatteMilkStyle,  "Milk style",                                  InputMode::Options, OPTIONS(MILK_STYLE_OPTIONS), enterLatteMilkStyle, confirmLatteMilkStyle},
+    {Screen::LatteMilkRatio,  "Custom milk:espresso ratio (Up/Down, Enter)", InputMode::Value,   nullptr, 0,                  enterLatteMilkRatio, confirmLatteMilkRatio},
+    {Screen::PresetName,      "Enter preset name (type, Enter to confirm)",  InputMode::Text,    nullptr, 0,                  enterPresetName,     confirmPresetName},
+    {Screen::LoadPresetList,  "Select a preset to load",                     InputMode::Options, nullptr, 0,                  enterLoadPresetList, confirmLoadPreset},
+    {Screen::AddonsPrompt,    "Add addons? (Ice, Toppings, etc)",            InputMode::Options, OPTIONS(YES_NO_OPTIONS),     nullptr,             confirmAddonsPrompt},
+    {Screen::AddonsList,      "Select Addon",                                InputMode::Options, nullptr, 0,                  enterAddonsList,     confirmAddonsList},
+    {Screen::ToppingInput,    "Enter topping name (type, Enter)",            InputMode::Text,    nullptr, 0,                  enterToppingInput,   confirmToppingInput},
+    {Screen::ExtraShotsInput, "Extra shots (Up/Down, Enter)",                InputMode::Value,   nullptr, 0,                  enterExtraShots,     confirmExtraShots},
+    {Screen::Summary,         "Your drink",                                  InputMode::None,    nullptr, 0,                  nullptr,             confirmDone},
+    {Screen::Error,           "Press Enter to return to the menu",           InputMode::None,    nullptr, 0,                  nullptr,             confirmDone},
+};
+
+#undef OPTIONS
+
+// every row sits at its own Screen index
+constexpr bool screensInOrder() {
+    for (size_t i = 0; i < SCREEN_COUNT; ++i)
+        if (static_cast<size_t>(SCREENS[i].screen) != i) return false;
+    return true;
+}
+
+} // namespace
+
+UiMachine::UiMachine(PresetManager& presets) : ui(session.resource()), presets(presets) {
+    resetToMenu();
+}
+
+size_t UiMachine::optionCount() const {
+    return ui.optionCount;
+}
+
+// static options, or the preset names on LoadPresetList
+string_view UiMachine::option(size_t i) const {
+    if (i >= ui.optionCount) return string_view();
+    return ui.options ? string_view(ui.options[i]) : names[i];
+}
+
+void UiMachine::setMessage(string_view text) {
+    size_t n = min(text.size(), UI_MESSAGE_CAPACITY - 1);
+    memcpy(ui.message, text.data(), n);
+    ui.message[n] = '\0';
+}
+
+/******************************************************************
+ * Function: UiMachine::enterScreen
+ * ---------------------------------------------------------------
+ * Makes s the current screen: applies its table row (prompt,
+ * input mode, static options) and then its enter handler, which
+ * restores the selection or value from what was already chosen.
+ ******************************************************************/
+void UiMachine::enterScreen(Screen s) {
+    const ScreenSpec& spec = SCREENS[static_cast<size_t>(s)];
+    ui.screen = s;
+    ui.input = spec.input;
+    ui.prompt = spec.prompt;
+    ui.options = spec.options;
+    ui.optionCount = spec.optionCount;
+    ui.selected = 0;
+    ui.message[0] = '\0';
+    ui.warningShown = false;
+    if (spec.enter) spec.enter(*this);
+}
+
+void UiMachine::goTo(Screen s) {
+    if (ui.screen != Screen::Summary && ui.screen != Screen::Error &&
+        ui.screen != Screen::MainMenu) {
+        if (ui.historySize == UI_HISTORY_MAX) {
+            memmove(ui.history, ui.history + 1, (UI_HISTORY_MAX - 1) * sizeof(Screen));
+            --ui.historySize;
+        }
+        ui.history[ui.historySize++] = ui.screen;
+    }
+    enterScreen(s);
+}
+
+void UiMachine::goBack() {
+    if (ui.historySize == 0) return;
+    enterScreen(ui.history[--ui.historySize]);
+}
+
+/******************************************************************
+ * Function: UiMachine::startSession
+ * ---------------------------------------------------------------
+ * Replaces ui with a blank state for the next order session. The
+ * old state goes first (its strings are all the arena holds), the
+ * arena is released in one step, and the new state is built in
+ * place on it, so nothing is copied or freed piecemeal.
+ ******************************************************************/
+void UiMachine::startSession() {
+    ui.~UiState();
+    session.release();
+    ::new (&ui) UiState(session.resource());
+}
+
+// back to the main menu with a fresh drink; daily caffeine is kept
+void UiMachine::resetToMenu() {
+    Flow prev = ui.flow;
+    double caffeine = ui.dailyCaffeine;
+    startSession();
+    ui.dailyCaffeine = caffeine;
+    enterScreen(Screen::MainMenu);
+    if (prev == Flow::CreatePreset || prev == Flow::LoadPreset)
+        setMessage("Preset operations now available in GUI.");
+}
+
+// daily caffeine plus the fleet analytics
+void UiMachine::recordDrink(const Order& order, const OrderResult& result) {
+    ui.dailyCaffeine += result.caffeineMg;
+    recordOrder(sharedAnalytics(), order, result, analyticsNow());
+}
+
+bool UiMachine::computeCoffee() {
+    Order order;
+    order.drink = DrinkType::Coffee;
+    order.strength = ui.coffeeStrength;
+    order.roast = ui.roastType;
+    order.cups = ui.coffeeCups;
+    order.iced = ui.isIced;
+
+    OrderResult result;
+    if (!computeOrderCached(order, result))
+        return false;
+    const CoffeeResult& r = result.coffee;
+
+    SummaryWriter out(ui.summary);
+    if (ui.flow == Flow::CreatePreset) {
+        Presets p(ui.presetName);
+        p.setCoffee(ui.roastType, ui.coffeeStrength, ui.coffeeCups);
+        bool saved = presets.addPreset(p).valid();
+        out.append(saved ? "Preset saved: " : "Preset NOT saved: ")
+           .append(ui.presetName).append("\n\n");
+    }
+    buildCoffeeSummary(out, ui, r);
+    recordDrink(order, result);
+    enterScreen(Screen::Summary);
+    return true;
+}
+
+bool UiMachine::computeLatte() {
+    Order order;
+    order.drink = DrinkType::Latte;
+    order.strength = ui.latteStrength;
+    order.shotSize = ui.latteShotSize;
+    order.shots = ui.latteShots;
+    order.milkStyle = ui.latteMilkStyle;
+    order.milkRatio = ui.latteMilkRatio;
+    order.iced = ui.isIced;
+    order.extraShots = ui.extraShots;
+
+    // calc, add-ons and milk target, memoized per canonical order
+    OrderResult result;
+    if (!computeOrderCached(order, result))
+        return false;
+    const LatteResult& r = result.latte;
+
+    SummaryWriter out(ui.summary);
+    if (ui.flow == Flow::CreatePreset) {
+        Presets p(ui.presetName);
+        p.setLatte(ui.latteShotSize, ui.latteShots, ui.latteStrength,
+                   ui.latteMilkStyle, ui.latteMilkRatio);
+        bool saved = presets.addPreset(p).valid();
+        out.append(saved ? "Preset saved: " : "Preset NOT saved: ")
+           .append(ui.presetName).append("\n\n");
+    }
+    buildLatteSummary(out, ui, r);
+    recordDrink(order, result);
+    enterScreen(Screen::Summary);
+    return true;
+}
+
+// option and summary screens clear the last message on Enter
+void UiMachine::confirm() {
+    if (ui.input == InputMode::Options || ui.input == InputMode::None)
+        ui.message[0] = '\0';
+    const ScreenSpec& spec = SCREENS[static_cast<size_t>(ui.screen)];
+    if (spec.confirm) spec.confirm(*this);
+}
+
+/******************************************************************
+ * Function: UiMachine::handle
+ * ---------------------------------------------------------------
+ * Routes one key event. Left goes back and Escape restarts on
+ * every screen; the rest depends on the screen's input mode.
+ *
+ * Returns:
+ *   true if the event was used (the UI may have changed).
+ ******************************************************************/
+bool UiMachine::handle(const UiEvent& event) {
+    PROBE_SCOPE("ui.handle");
+    if (event.key == UiKey::Left) {
+        goBack();
+        return true;
+    }
+    if (event.key == UiKey::Escape) {
+        resetToMenu();
+        return true;
+    }
+
+    switch (ui.input) {
+    case InputMode::Value:
+        if (event.key == UiKey::Up) {
+            ui.value += ui.step;
+        } else if (event.key == UiKey::Down) {
+            ui.value = max(ui.minValue, ui.value - ui.step);
+        } else if (event.key == UiKey::Enter) {
+            confirm();
+        } else {
+            return false;
+        }
+        return true;
+    case InputMode::Text:
+        if (event.key == UiKey::Backspace) {
+            if (!ui.textInput.empty()) ui.textInput.pop_back();
+        } else if (event.key == UiKey::Enter) {
+            confirm();
+        } else if (event.key == UiKey::Char && event.ch >= 32 && event.ch < 127) {
+            ui.textInput.push_back(event.ch);
+        } else {
+            return false;
+        }
+        return true;
+    default:
+        if (event.key == UiKey::Up && ui.optionCount > 0) {
+            ui.selected = (ui.selected == 0) ? ui.optionCount - 1 : ui.selected - 1;
+        } else if (event.key == UiKey::Down && ui.optionCount > 0) {
+            ui.selected = (ui.selected + 1) % ui.optionCount;
+        } else if (event.key == UiKey::Enter) {
+            confirm();
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
+
+static_assert(screensInOrder(), "SCREENS rows must follow the Screen enum order");
+static_assert(is_nothrow_constructible<UiState, pmr::memory_resource*>::value,
+              "startSession() rebuilds UiState in place");
+
+/******************************************************************
+ * Function: buildCoffeeSummary
+ * ---------------------------------------------------------------
+ * Formats a coffee result into the GUI's multi-line summary.
+ ******************************************************************/
+void buildCoffeeSummary(SummaryWriter& out, const UiState& state, const CoffeeResult& r) {
+    out.append("Coffee Summary\n");
+    out.append("Roast: ").append(toString(state.roastType)).append('\n');
+    out.append("Strength: ").append(toString(state.coffeeStrength))
+       .append(" (1:").appendInt(static_cast<int>(r.ratio)).append(")\n");
+    out.append("Water: ").appendFixed2(r.waterML).append(" mL\n");
+    out.append("Coffee: ").appendFixed2(r.coffeeGrams)
+       .append(" g (").appendFixed2(r.tablespoons).append(" tbsp)\n");
+    if (state.isIced) out.append("Addons: Iced\n");
+    if (!state.topping.empty()) out.append("Topping: ").append(state.topping);
+}
+
+/******************************************************************
+ * Function: buildLatteSummary
+ * ---------------------------------------------------------------
+ * Formats a latte result into the GUI's multi-line summary.
+ ******************************************************************/
+void buildLatteSummary(SummaryWriter& out, const UiState& state, const LatteResult& r) {
+    out.append("Latte Summary\n");
+    out.append("Strength: ").append(toString(state.latteStrength)).append('\n');
+    out.append("Shots: ").appendInt(state.latteShots)
+       .append(" x ").append(toString(state.latteShotSize)).append('\n');
+    out.append("Coffee: ").appendFixed2(r.coffeeGrams)
+       .append(" g (").appendFixed2(r.tablespoons).append(" tbsp)\n");
+    out.append("Espresso: ").appendFixed2(r.espressoML).append(" mL\n");
+    if (r.hasMilkTarget) {
+        out.append("Milk: ").appendFixed2(r.milkML)
+           .append(" mL (style ").append(toString(state.latteMilkStyle)).append(")\n");
+        out.append("Final: ").appendFixed2(r.finalML).append(" mL\n");
+    }
+    if (state.isIced) out.append("Addons: Iced\n");
+    if (state.extraShots > 0) out.append("Extra Shots: ").appendInt(state.extraShots).append('\n');
+    if (!state.topping.empty()) out.append("Topping: ").append(state.topping);
+}